@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/Big_uint.hpp>
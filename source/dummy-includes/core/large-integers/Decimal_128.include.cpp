@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/Decimal_128.hpp>
@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>
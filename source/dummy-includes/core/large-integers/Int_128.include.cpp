@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/Int_128.hpp>
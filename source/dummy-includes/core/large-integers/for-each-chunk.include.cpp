@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/~for-each-chunk.hpp>
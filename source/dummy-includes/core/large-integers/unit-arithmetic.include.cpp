@@ -0,0 +1 @@
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>
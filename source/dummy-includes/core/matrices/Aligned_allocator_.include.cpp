@@ -0,0 +1 @@
+#include <kickstart/core/matrices/Aligned_allocator_.hpp>
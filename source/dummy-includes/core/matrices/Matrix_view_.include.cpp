@@ -0,0 +1 @@
+#include <kickstart/core/matrices/Matrix_view_.hpp>
@@ -0,0 +1 @@
+#include <kickstart/core/matrices/Sparse_matrix_.hpp>
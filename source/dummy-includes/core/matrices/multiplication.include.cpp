@@ -0,0 +1 @@
+#include <kickstart/core/matrices/multiplication.hpp>
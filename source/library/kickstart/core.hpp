@@ -25,7 +25,7 @@
 #include <kickstart/core/collection-util.hpp>       // ssize_
 #include <kickstart/core/failure-handling.hpp>      // hopefully, fail, …
 #include <kickstart/core/language.hpp>              // Size etc.
-#include <kickstart/core/large-integers.hpp>        // Uint_128
+#include <kickstart/core/large-integers.hpp>        // Uint_128, Int_128, Uint_256 etc., Big_uint
 #include <kickstart/core/matrices.hpp>              // Matrix_ etc.
 #include <kickstart/core/process.hpp>               // process::Commandline
 #include <kickstart/core/stdlib-extensions.hpp>     // bits_per, …
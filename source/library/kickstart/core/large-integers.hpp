@@ -25,4 +25,14 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <kickstart/core/large-integers/batch-operations.hpp>
+#include <kickstart/core/large-integers/Big_uint.hpp>
+#include <kickstart/core/large-integers/checked-arithmetic.hpp>
+#include <kickstart/core/large-integers/Decimal_128.hpp>
+#include <kickstart/core/large-integers/Divider_.hpp>
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>
+#include <kickstart/core/large-integers/Int_128.hpp>
+#include <kickstart/core/large-integers/modular-arithmetic.hpp>
+#include <kickstart/core/large-integers/primes.hpp>
+#include <kickstart/core/large-integers/radix-sort.hpp>
 #include <kickstart/core/large-integers/Uint_128.hpp>
@@ -0,0 +1,1089 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/language/type-aliases.hpp>             // C_str
+#include <kickstart/core/large-integers/decimal-digits.hpp>     // write_decimal_digits, swar::*
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>
+#include <kickstart/core/large-integers/Uint_128.hpp>           // Uint_128, Parsing_result_
+#include <kickstart/core/large-integers/Uint_double_of_.hpp>
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // add_with_carry, ...
+
+#include <stdint.h>         // uint64_t
+
+#include <algorithm>        // std::(copy, fill, max, min, swap)
+#include <memory>           // std::unique_ptr
+#include <string>           // std::string
+#include <string_view>      // std::string_view
+#include <type_traits>      // std::(enable_if_t, is_integral_v, is_signed_v)
+#include <utility>          // std::move
+#include <vector>           // std::vector
+
+namespace kickstart::large_integers::_definitions {
+    namespace kl = kickstart::language;
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL, KS_FAIL_
+    using namespace kickstart::text_conversion;     // ""s, operator<<
+
+    using   kl::C_str, kl::Truth;
+    using   std::copy, std::fill, std::max, std::min,
+            std::unique_ptr,
+            std::string,
+            std::string_view,
+            std::enable_if_t, std::is_integral_v, std::is_signed_v,
+            std::move,
+            std::vector;
+
+    // Arbitrary precision unsigned integer. The 64-bit units are stored contiguously in little
+    // endian order, inline for values of up to `n_inline_units` units, and otherwise in a heap
+    // allocated buffer. Multiplication uses the schoolbook method, Karatsuba or Toom-3 depending
+    // on the operand sizes, and the decimal conversions divide and conquer via powers of 10.
+    // Division by a large power is via its reciprocal, so that also it uses the faster methods.
+    class Big_uint
+    {
+    public:
+        using Unit = uint64_t;
+        static constexpr int n_inline_units = 4;
+
+    private:
+        using Self = Big_uint;
+
+        int                 m_size;             // Number of significant units, 0 for the value 0.
+        int                 m_capacity;
+        unique_ptr<Unit[]>  m_heap_units;       // Null when the inline units are used.
+        Unit                m_inline_units[n_inline_units];
+
+        auto data() -> Unit* { return (m_heap_units? m_heap_units.get() : m_inline_units); }
+        auto data() const -> const Unit* { return (m_heap_units? m_heap_units.get() : m_inline_units); }
+
+        inline void reserve( const int n );
+        inline void resize( const int n );      // New units are zeroed.
+        inline void trim();
+
+    public:
+        Big_uint():
+            m_size( 0 ),
+            m_capacity( n_inline_units ),
+            m_heap_units(),
+            m_inline_units()
+        {}
+
+        template< class Integer, class = enable_if_t<is_integral_v<Integer>> >
+        Big_uint( const Integer value ):
+            Big_uint()
+        {
+            hopefully( not( is_signed_v<Integer> and value < 0 ) )
+                or KS_FAIL_( std_exception::out_of_range, "A negative value can't be represented as Big_uint." );
+            m_inline_units[0] = Unit( value );
+            m_size = (value != 0);
+        }
+
+        Big_uint( const Uint_128& value ):
+            Big_uint()
+        {
+            m_inline_units[0] = value.representation().parts[0];
+            m_inline_units[1] = value.representation().parts[1];
+            m_size = 2;
+            trim();
+        }
+
+        template< int n_bits >
+        Big_uint( const Fixed_uint_<n_bits>& value ):
+            Big_uint()
+        {
+            resize( Fixed_uint_<n_bits>::n_units );
+            for( int i = 0; i < m_size; ++i ) { data()[i] = value.unit( i ); }
+            trim();
+        }
+
+        inline Big_uint( const Self& other );
+        inline Big_uint( Self&& other ) noexcept;
+        inline auto operator=( const Self& other ) -> Self&;
+        inline auto operator=( Self&& other ) noexcept -> Self&;
+
+        static inline auto from_units( const Unit* p_first, const int n ) -> Self;
+
+        auto n_units() const -> int { return m_size; }
+        auto units() const -> const Unit* { return data(); }
+        auto unit( const int i ) const -> Unit { return (i < m_size? data()[i] : 0); }
+        auto is_zero() const -> Truth { return (m_size == 0); }
+        auto modulo_64_bits() const -> Unit { return unit( 0 ); }
+        inline auto bit_width() const -> int;
+
+        inline void operator++();
+        inline void operator--();
+
+        inline void operator+=( const Self& other );
+        inline void operator-=( const Self& other );
+        inline void operator*=( const Self& other );
+        inline void operator/=( const Self& other );
+        inline void operator%=( const Self& other );
+
+        inline void add_64_bit( const Unit a );
+        inline void multiply_by_64_bit( const Unit a );
+
+        struct Divmod_result;
+        inline auto divmod_by_64_bit( const Unit b ) const -> Divmod_result;
+
+        friend inline auto operator*( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+        friend inline auto divmod( const Big_uint& a, const Big_uint& b ) -> Big_uint::Divmod_result;
+    };
+
+    struct Big_uint::Divmod_result
+    {
+        Big_uint    remainder;
+        Big_uint    quotient;
+    };
+
+    inline auto operator+( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+    inline auto operator-( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+    inline auto operator*( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+
+    inline auto divmod( const Big_uint& a, const Big_uint& b ) -> Big_uint::Divmod_result;
+    inline auto operator/( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+    inline auto operator%( const Big_uint& a, const Big_uint& b ) -> Big_uint;
+
+    inline auto compare( const Big_uint& a, const Big_uint& b ) -> int;
+    inline auto operator<( const Big_uint& a, const Big_uint& b ) -> Truth;
+    inline auto operator<=( const Big_uint& a, const Big_uint& b ) -> Truth;
+    inline auto operator==( const Big_uint& a, const Big_uint& b ) -> Truth;
+    inline auto operator>=( const Big_uint& a, const Big_uint& b ) -> Truth;
+    inline auto operator>( const Big_uint& a, const Big_uint& b ) -> Truth;
+    inline auto operator!=( const Big_uint& a, const Big_uint& b ) -> Truth;
+
+    inline auto operator<<( string& s, const Big_uint& v ) -> string&;
+    inline auto str( const Big_uint& v ) -> string;
+
+    inline auto parse_big_uint( const string_view& spec ) -> Parsing_result_<Big_uint>;
+    inline auto to_big_uint( const string_view& spec ) -> Big_uint;
+    inline auto operator""_big( const C_str spec ) -> Big_uint;
+
+
+    //--------------------------------------------------------------------------------------------------
+
+    // Operations on sequences of units, used to implement `Big_uint`.
+    namespace impl::big_uint {
+        using Unit      = Big_uint::Unit;
+        using Product   = Uint_double_of_<Unit>;
+
+        // Operand sizes in units from which the faster multiplication algorithms are used.
+        constexpr int karatsuba_min_units   = 32;
+        constexpr int toom_3_min_units      = 160;
+
+        // Size in units up to which a decimal conversion is done without dividing and conquering.
+        constexpr int radix_conversion_max_simple_units = 24;
+
+        // Divisor and quotient size in units from which a decimal conversion divides via a
+        // reciprocal instead of by long division.
+        constexpr int reciprocal_division_min_units = 400;
+
+        // r[0..n) = a[0..n) + b[0..n) + carry. Returns the carry out. `r` may be `a` or `b`.
+        inline auto add_n( Unit* r, const Unit* a, const Unit* b, const int n, Truth carry = false )
+            -> Truth
+        {
+            for( int i = 0; i < n; ++i ) { r[i] = add_with_carry( a[i], b[i], carry ); }
+            return carry;
+        }
+
+        // r[0..n) = a[0..n) - b[0..n) - borrow. Returns the borrow out. `r` may be `a` or `b`.
+        inline auto subtract_n( Unit* r, const Unit* a, const Unit* b, const int n, Truth borrow = false )
+            -> Truth
+        {
+            for( int i = 0; i < n; ++i ) { r[i] = subtract_with_borrow( a[i], b[i], borrow ); }
+            return borrow;
+        }
+
+        // r[0..nr) += b[0..nb), where nr >= nb. Returns the carry out.
+        inline auto add_into( Unit* r, const int nr, const Unit* b, const int nb )
+            -> Truth
+        {
+            Truth carry = add_n( r, r, b, nb );
+            for( int i = nb; carry and i < nr; ++i ) { carry = (++r[i] == 0); }
+            return carry;
+        }
+
+        // r[0..nr) -= b[0..nb), where nr >= nb. Returns the borrow out.
+        inline auto subtract_from( Unit* r, const int nr, const Unit* b, const int nb )
+            -> Truth
+        {
+            Truth borrow = subtract_n( r, r, b, nb );
+            for( int i = nb; borrow and i < nr; ++i ) { borrow = (r[i]-- == 0); }
+            return borrow;
+        }
+
+        // r[0..n) += a[0..n)·m. Returns the carry out, a whole unit.
+        inline auto multiply_add_unit( Unit* r, const Unit* a, const int n, const Unit m )
+            -> Unit
+        {
+            Unit carry = 0;
+            for( int i = 0; i < n; ++i ) {
+                #ifdef KS_HAS_NATIVE_UINT_128
+                    const Native_uint_128 t = Native_uint_128( a[i] )*m + r[i] + carry;
+                    r[i] = Unit( t );  carry = Unit( t >> 64 );
+                #else
+                    const Product p = Product::product_of( a[i], m );
+                    Truth c1 = false;   const Unit low = add_with_carry( p.parts[0], carry, c1 );
+                    Truth c2 = false;   r[i] = add_with_carry( r[i], low, c2 );
+                    carry = p.parts[1] + +c1 + +c2;     // Can't overflow since p.parts[1] < 2^64 - 1.
+                #endif
+            }
+            return carry;
+        }
+
+        // r[0..n) = a[0..n)·m. Returns the carry out, a whole unit. `r` may be `a`.
+        inline auto multiply_unit( Unit* r, const Unit* a, const int n, const Unit m )
+            -> Unit
+        {
+            Unit carry = 0;
+            for( int i = 0; i < n; ++i ) {
+                #ifdef KS_HAS_NATIVE_UINT_128
+                    const Native_uint_128 t = Native_uint_128( a[i] )*m + carry;
+                    r[i] = Unit( t );  carry = Unit( t >> 64 );
+                #else
+                    const Product p = Product::product_of( a[i], m );
+                    Truth c = false;
+                    r[i] = add_with_carry( p.parts[0], carry, c );
+                    carry = p.parts[1] + +c;
+                #endif
+            }
+            return carry;
+        }
+
+        inline auto n_significant( const Unit* a, int n )
+            -> int
+        {
+            while( n > 0 and a[n - 1] == 0 ) { --n; }
+            return n;
+        }
+
+        inline void multiply( Unit* r, const Unit* a, int na, const Unit* b, int nb );
+
+        // r[0..na + nb) = a·b, where `r` doesn't overlap the operands.
+        inline void multiply_schoolbook( Unit* r, const Unit* a, const int na, const Unit* b, const int nb )
+        {
+            fill( r, r + na, Unit( 0 ) );
+            for( int i = 0; i < nb; ++i ) {
+                r[na + i] = multiply_add_unit( r + i, a, na, b[i] );
+            }
+        }
+
+        // r[0..na + nb) = a·b with a split in halves of h units, where na >= nb > h. The middle
+        // term is (a0 + a1)·(b0 + b1) - a0·b0 - a1·b1, so 3 half size products are needed.
+        inline void multiply_karatsuba( Unit* r, const Unit* a, const int na, const Unit* b, const int nb )
+        {
+            const int h = (na + 1)/2;
+            const int n = na + nb;
+            multiply( r, a, h, b, h );                          // low  = a0·b0, in r[0..2h).
+            multiply( r + 2*h, a + h, na - h, b + h, nb - h );  // high = a1·b1, in r[2h..n).
+
+            vector<Unit> sum_a( a, a + h );     sum_a.push_back( 0 );
+            vector<Unit> sum_b( b, b + h );     sum_b.push_back( 0 );
+            add_into( sum_a.data(), h + 1, a + h, na - h );
+            add_into( sum_b.data(), h + 1, b + h, nb - h );
+
+            const int n_sum_a = n_significant( sum_a.data(), h + 1 );
+            const int n_sum_b = n_significant( sum_b.data(), h + 1 );
+            vector<Unit> mid( n_sum_a + n_sum_b );
+            if( n_sum_a > 0 and n_sum_b > 0 ) {
+                multiply( mid.data(), sum_a.data(), n_sum_a, sum_b.data(), n_sum_b );
+            }
+            const int n_mid = int( mid.size() );
+            subtract_from( mid.data(), n_mid, r, n_significant( r, 2*h ) );
+            subtract_from( mid.data(), n_mid, r + 2*h, n_significant( r + 2*h, n - 2*h ) );
+            add_into( r + h, n - h, mid.data(), n_significant( mid.data(), n_mid ) );
+        }
+
+        // Unsigned number as a vector of units, for the Toom-3 evaluation and interpolation.
+        using Units = vector<Unit>;
+
+        inline auto units_of( const Unit* a, const int n )
+            -> Units
+        { return Units( a, a + n_significant( a, n ) ); }
+
+        inline void trim( Units& a ) { a.resize( n_significant( a.data(), int( a.size() ) ) ); }
+
+        inline auto compare( const Units& a, const Units& b )
+            -> int
+        {
+            if( a.size() != b.size() ) { return (a.size() < b.size()? -1 : +1); }
+            for( int i = int( a.size() ) - 1; i >= 0; --i ) {
+                if( a[i] != b[i] ) { return (a[i] < b[i]? -1 : +1); }
+            }
+            return 0;
+        }
+
+        inline auto sum_of( const Units& a, const Units& b )
+            -> Units
+        {
+            const Units& longer     = (a.size() >= b.size()? a : b);
+            const Units& shorter    = (a.size() >= b.size()? b : a);
+            Units result( longer.size() + 1 );
+            copy( longer.begin(), longer.end(), result.begin() );
+            add_into( result.data(), int( result.size() ), shorter.data(), int( shorter.size() ) );
+            trim( result );
+            return result;
+        }
+
+        // Requires a >= b.
+        inline auto difference_of( const Units& a, const Units& b )
+            -> Units
+        {
+            Units result = a;
+            subtract_from( result.data(), int( result.size() ), b.data(), int( b.size() ) );
+            trim( result );
+            return result;
+        }
+
+        inline auto product_of( const Units& a, const Units& b )
+            -> Units
+        {
+            if( a.empty() or b.empty() ) { return {}; }
+            Units result( a.size() + b.size() );
+            multiply( result.data(), a.data(), int( a.size() ), b.data(), int( b.size() ) );
+            trim( result );
+            return result;
+        }
+
+        inline auto shifted_left( const Units& a, const int n_bits )    // 1 <= n_bits < 64
+            -> Units
+        {
+            Units result( a.size() + 1 );
+            for( int i = 0; i < int( a.size() ); ++i ) {
+                result[i] |= a[i] << n_bits;
+                result[i + 1] = a[i] >> (64 - n_bits);
+            }
+            trim( result );
+            return result;
+        }
+
+        inline auto halved( const Units& a )
+            -> Units
+        {
+            Units result( a.size() );
+            for( int i = 0; i < int( a.size() ); ++i ) {
+                const Unit next = (i + 1 < int( a.size() )? a[i + 1] : 0);
+                result[i] = a[i] >> 1 | next << 63;
+            }
+            trim( result );
+            return result;
+        }
+
+        // Requires that 3 divides a.
+        inline auto third_of( const Units& a )
+            -> Units
+        {
+            Units result( a.size() );
+            Unit remainder = 0;
+            for( int i = int( a.size() ) - 1; i >= 0; --i ) {
+                result[i] = divide_double_unit( remainder, a[i], Unit( 3 ), remainder );
+            }
+            trim( result );
+            return result;
+        }
+
+        // r[0..na + nb) = a·b by evaluating the polynomials with 3 coefficients of k units each,
+        // at 0, 1, -1, 2 and ∞, and interpolating the product polynomial c0 + c1·x + ... + c4·x⁴
+        // from the 5 products. Only the value at -1 can be negative, so it's held as a magnitude
+        // plus a sign. Requires na >= nb > 2k where k = ⌈na/3⌉.
+        inline void multiply_toom_3( Unit* r, const Unit* a, const int na, const Unit* b, const int nb )
+        {
+            const int k = (na + 2)/3;
+            const Units a0 = units_of( a, k );   const Units a1 = units_of( a + k, k );
+            const Units a2 = units_of( a + 2*k, na - 2*k );
+            const Units b0 = units_of( b, k );   const Units b1 = units_of( b + k, k );
+            const Units b2 = units_of( b + 2*k, nb - 2*k );
+
+            struct Signed_units{ Units magnitude; Truth is_negative; };
+            const auto value_at_minus_1 = []( const Units& x0, const Units& x1, const Units& x2 )
+                -> Signed_units
+            {
+                const Units even = sum_of( x0, x2 );
+                return (compare( even, x1 ) >= 0
+                    ? Signed_units{ difference_of( even, x1 ), false }
+                    : Signed_units{ difference_of( x1, even ), true }
+                    );
+            };
+            const auto value_at_2 = []( const Units& x0, const Units& x1, const Units& x2 )
+                -> Units
+            { return sum_of( shifted_left( sum_of( shifted_left( x2, 1 ), x1 ), 1 ), x0 ); };
+
+            const Signed_units a_minus_1 = value_at_minus_1( a0, a1, a2 );
+            const Signed_units b_minus_1 = value_at_minus_1( b0, b1, b2 );
+
+            const Units v0      = product_of( a0, b0 );
+            const Units v1      = product_of( sum_of( sum_of( a0, a1 ), a2 ), sum_of( sum_of( b0, b1 ), b2 ) );
+            const Units vm1     = product_of( a_minus_1.magnitude, b_minus_1.magnitude );
+            const Truth vm1_is_negative = (a_minus_1.is_negative != b_minus_1.is_negative);
+            const Units v2      = product_of( value_at_2( a0, a1, a2 ), value_at_2( b0, b1, b2 ) );
+            const Units v_inf   = product_of( a2, b2 );
+
+            // v1 + vm1 = 2(c0 + c2 + c4), and v1 - vm1 = 2(c1 + c3).
+            const Units even_sum    = (vm1_is_negative? difference_of( v1, vm1 ) : sum_of( v1, vm1 ));
+            const Units odd_sum     = (vm1_is_negative? sum_of( v1, vm1 ) : difference_of( v1, vm1 ));
+            const Units& c0 = v0;
+            const Units& c4 = v_inf;
+            const Units c2 = difference_of( halved( even_sum ), sum_of( c0, c4 ) );
+            const Units c1_plus_c3 = halved( odd_sum );
+
+            // v2 - c0 - 4·c2 - 16·c4 = 2·c1 + 8·c3, so halving and subtracting c1 + c3 gives 3·c3.
+            const Units known = sum_of( sum_of( c0, shifted_left( c2, 2 ) ), shifted_left( c4, 4 ) );
+            const Units c3 = third_of( difference_of( halved( difference_of( v2, known ) ), c1_plus_c3 ) );
+            const Units c1 = difference_of( c1_plus_c3, c3 );
+
+            const int n = na + nb;
+            fill( r, r + n, Unit( 0 ) );
+            const Units* const coefficients[] = { &c0, &c1, &c2, &c3, &c4 };
+            for( int i = 0; i < 5; ++i ) {
+                const Units& c = *coefficients[i];
+                if( not c.empty() ) { add_into( r + i*k, n - i*k, c.data(), int( c.size() ) ); }
+            }
+        }
+
+        // r[0..na + nb) = a·b, where `r` doesn't overlap the operands.
+        inline void multiply( Unit* r, const Unit* a, int na, const Unit* b, int nb )
+        {
+            if( na < nb ) { std::swap( a, b );  std::swap( na, nb ); }
+            if( nb < karatsuba_min_units ) {
+                multiply_schoolbook( r, a, na, b, nb );
+            } else if( 2*nb <= na + 1 ) {
+                // Unbalanced: a is multiplied in pieces of nb units, and the products are summed.
+                fill( r, r + na + nb, Unit( 0 ) );
+                vector<Unit> piece_product( 2*nb );
+                for( int i = 0; i < na; i += nb ) {
+                    const int n_piece = min( nb, na - i );
+                    multiply( piece_product.data(), a + i, n_piece, b, nb );
+                    add_into( r + i, na + nb - i, piece_product.data(), n_piece + nb );
+                }
+            } else if( nb < toom_3_min_units or nb <= 2*((na + 2)/3) ) {
+                multiply_karatsuba( r, a, na, b, nb );
+            } else {
+                multiply_toom_3( r, a, na, b, nb );
+            }
+        }
+
+        // r[0..n) = a[0..n) << n_bits, where 0 <= n_bits < 64. Returns the bits shifted out.
+        inline auto shift_left( Unit* r, const Unit* a, const int n, const int n_bits )
+            -> Unit
+        {
+            if( n_bits == 0 ) { copy( a, a + n, r );  return 0; }
+            Unit carry = 0;
+            for( int i = 0; i < n; ++i ) {
+                const Unit next_carry = a[i] >> (64 - n_bits);
+                r[i] = a[i] << n_bits | carry;
+                carry = next_carry;
+            }
+            return carry;
+        }
+
+        // r[0..n) = a[0..n + 1) >> n_bits, where 0 <= n_bits < 64.
+        inline void shift_right( Unit* r, const Unit* a, const int n, const int n_bits )
+        {
+            if( n_bits == 0 ) { copy( a, a + n, r );  return; }
+            for( int i = 0; i < n; ++i ) {
+                r[i] = a[i] >> n_bits | a[i + 1] << (64 - n_bits);
+            }
+        }
+
+        // Knuth's algorithm D: q[0..nu - nv] = u/v and r[0..nv) = u%v, where nu >= nv >= 2 and
+        // the most significant unit of v is non-zero.
+        inline void divide( Unit* q, Unit* r, const Unit* u, const int nu, const Unit* v, const int nv )
+        {
+            const int n_shifts = n_leading_zeros_in( v[nv - 1] );
+            vector<Unit> vn( nv );      vector<Unit> un( nu + 1 );
+            shift_left( vn.data(), v, nv, n_shifts );
+            un[nu] = shift_left( un.data(), u, nu, n_shifts );
+
+            const Unit v_top    = vn[nv - 1];
+            const Unit v_next   = vn[nv - 2];
+            for( int j = nu - nv; j >= 0; --j ) {
+                Unit* const window = un.data() + j;     // The nv + 1 units being divided.
+
+                // Estimate the quotient unit from the top units, then correct the estimate so
+                // that it's exact or 1 too large.
+                Unit q_hat = 0;     Unit r_hat = 0;     Truth r_hat_overflowed = false;
+                if( window[nv] >= v_top ) {             // Then they're equal.
+                    q_hat = Unit( -1 );
+                    r_hat = window[nv - 1] + v_top;
+                    r_hat_overflowed = (r_hat < v_top);
+                } else {
+                    q_hat = divide_double_unit( window[nv], window[nv - 1], v_top, r_hat );
+                }
+                while( not r_hat_overflowed ) {
+                    const Product p = Product::product_of( q_hat, v_next );
+                    const Truth is_too_large = (p.parts[1] > r_hat
+                        or (p.parts[1] == r_hat and p.parts[0] > window[nv - 2])
+                        );
+                    if( not is_too_large ) { break; }
+                    --q_hat;
+                    r_hat += v_top;
+                    r_hat_overflowed = (r_hat < v_top);
+                }
+
+                // Multiply and subtract, and add back if the estimate was 1 too large.
+                Unit carry = 0;     Truth borrow = false;
+                for( int i = 0; i < nv; ++i ) {
+                    const Product p = Product::product_of( q_hat, vn[i] );
+                    Truth c = false;
+                    const Unit low = add_with_carry( p.parts[0], carry, c );
+                    carry = p.parts[1] + +c;
+                    window[i] = subtract_with_borrow( window[i], low, borrow );
+                }
+                window[nv] = subtract_with_borrow( window[nv], carry, borrow );
+                if( borrow ) {
+                    --q_hat;
+                    window[nv] += +add_n( window, window, vn.data(), nv );
+                }
+                q[j] = q_hat;
+            }
+            shift_right( r, un.data(), nv, n_shifts );
+        }
+
+        // v·β^n, where β = 2^64.
+        inline auto units_shifted_up( const Big_uint& v, const int n )
+            -> Big_uint
+        {
+            if( v.is_zero() ) { return v; }
+            vector<Unit> units( n + v.n_units() );
+            copy( v.units(), v.units() + v.n_units(), units.begin() + n );
+            return Big_uint::from_units( units.data(), int( units.size() ) );
+        }
+
+        // v/β^n rounded down, where β = 2^64.
+        inline auto units_shifted_down( const Big_uint& v, const int n )
+            -> Big_uint
+        {
+            if( v.n_units() <= n ) { return Big_uint(); }
+            return Big_uint::from_units( v.units() + n, v.n_units() - n );
+        }
+
+        // An approximation of the reciprocal ⌊β^(2k)/d⌋ for `divmod_by_reciprocal`, where d
+        // has k units. The result is at most 3 less than the reciprocal and never greater.
+        //
+        // For small d it's computed by long division. Otherwise the reciprocal of the h ≈ k/2
+        // most significant units of d gives an approximation X with relative error ε of about
+        // β^(1-h), and one Newton step X + X·(β^(2k) - d·X)/β^(2k), which is (1 - ε²)·β^(2k)/d,
+        // reduces the error to less than 1 plus the 2 lost by rounding down. So the cost is about
+        // two products of k by k/2 units at each of log k levels, dominated by the top level.
+        inline auto reciprocal_of( const Big_uint& d )
+            -> Big_uint
+        {
+            const int k = d.n_units();
+            const Big_uint b_2k = units_shifted_up( Big_uint( 1 ), 2*k );
+            if( k <= radix_conversion_max_simple_units ) {
+                return divmod( b_2k, d ).quotient;
+            }
+
+            const int h = (k + 5)/2;        // So that 2h >= k + 4, for ε²·β^(2k)/d < 1.
+            const Big_uint x_high = reciprocal_of( units_shifted_down( d, k - h ) );
+            const Big_uint x = units_shifted_up( x_high, k - h );
+
+            // With X = x_high·β^(k-h) the products are of k and h unit numbers.
+            const Big_uint dx = units_shifted_up( d*x_high, k - h );
+            if( dx <= b_2k ) {
+                return x + units_shifted_down( x_high*(b_2k - dx), k + h );
+            } else {
+                return x - units_shifted_down( x_high*(dx - b_2k), k + h ) - Big_uint( 1 );
+            }
+        }
+
+        // Barrett division of v < β^(2k) by d with k units, where `reciprocal` is
+        // `reciprocal_of( d )`. The quotient estimate ⌊⌊v/β^(k-1)⌋·reciprocal/β^(k+1)⌋ is at
+        // most 5 less than the quotient, so the cost is essentially two multiplications.
+        inline auto divmod_by_reciprocal( const Big_uint& v, const Big_uint& d, const Big_uint& reciprocal )
+            -> Big_uint::Divmod_result
+        {
+            const int k = d.n_units();
+            Big_uint::Divmod_result result;
+            result.quotient = units_shifted_down( units_shifted_down( v, k - 1 )*reciprocal, k + 1 );
+            result.remainder = v - result.quotient*d;
+            while( result.remainder >= d ) {
+                result.remainder -= d;
+                ++result.quotient;
+            }
+            return result;
+        }
+
+        // The values 10^(19·2^i) for i = 0, 1, 2, ... up to and including the first that's
+        // greater than `limit`, or up to an exponent of at least `min_digits`.
+        inline auto decimal_powers( const Big_uint& limit, const int min_digits = 0 )
+            -> vector<Big_uint>
+        {
+            vector<Big_uint> result = { Big_uint( pow10_19 ) };
+            int n_digits = 19;
+            while( result.back() <= limit or n_digits < min_digits ) {
+                result.push_back( result.back()*result.back() );
+                n_digits *= 2;
+            }
+            return result;
+        }
+
+        // Appends the decimal digits of `v` that has at most `radix_conversion_max_simple_units`
+        // units, left padded with zeros to `min_digits` digits.
+        inline void append_decimal_simply( string& s, const Big_uint& v, const int min_digits )
+        {
+            constexpr int max_units     = radix_conversion_max_simple_units;
+            constexpr int max_chunks    = max_units + 1;    // Each chunk has 19 of ≈19.3 digits.
+
+            Unit units[max_units];
+            int n = v.n_units();
+            copy( v.units(), v.units() + n, units );
+
+            Unit chunks[max_chunks];
+            int n_chunks = 0;
+            while( n > 0 ) {
+                Unit remainder = 0;
+                for( int i = n - 1; i >= 0; --i ) {
+                    units[i] = divide_double_unit( remainder, units[i], pow10_19, remainder );
+                }
+                chunks[n_chunks++] = remainder;
+                n = n_significant( units, n );
+            }
+
+            char digits[max_chunks*19];
+            char* p_beyond = digits;
+            if( n_chunks > 0 ) {
+                p_beyond = write_decimal_digits( chunks[n_chunks - 1], p_beyond );
+                for( int i = n_chunks - 2; i >= 0; --i ) {
+                    write_decimal_digits( chunks[i], 19, p_beyond );
+                    p_beyond += 19;
+                }
+            }
+            const int n_digits = int( p_beyond - digits );
+            if( n_digits < min_digits ) { s.append( min_digits - n_digits, '0' ); }
+            s.append( digits, n_digits );
+        }
+
+        // Appends the decimal digits of `v` < `powers[i_power]`², left padded with zeros to
+        // the 2·19·2^i_power digits of that limit if `pad` is true. The value is split as
+        // quotient and remainder of division by `powers[i_power]`, which are converted
+        // recursively. For a large divisor and quotient the division is via a reciprocal of the
+        // power, computed when first needed, so that it costs a few multiplications and the
+        // conversion as a whole is subquadratic. An empty `reciprocals[i]` is not yet computed.
+        inline void append_decimal(
+            string&                     s,
+            const Big_uint&             v,
+            const vector<Big_uint>&     powers,
+            vector<Big_uint>&           reciprocals,
+            const int                   i_power,
+            const Truth                 pad
+            )
+        {
+            if( v.n_units() <= radix_conversion_max_simple_units ) {
+                append_decimal_simply( s, v, (pad? 2*19 << i_power : 0) );
+                return;
+            }
+
+            const Big_uint& power = powers[i_power];
+            const int n_quotient_units = v.n_units() - power.n_units() + 1;
+            Big_uint::Divmod_result split;
+            if( min( power.n_units(), n_quotient_units ) >= reciprocal_division_min_units ) {
+                Big_uint& reciprocal = reciprocals[i_power];
+                if( reciprocal.is_zero() ) { reciprocal = reciprocal_of( power ); }
+                split = divmod_by_reciprocal( v, power, reciprocal );
+            } else {
+                split = divmod( v, power );
+            }
+
+            if( not pad and split.quotient.is_zero() ) {
+                append_decimal( s, split.remainder, powers, reciprocals, i_power - 1, false );
+            } else {
+                append_decimal( s, split.quotient, powers, reciprocals, i_power - 1, pad );
+                append_decimal( s, split.remainder, powers, reciprocals, i_power - 1, true );
+            }
+        }
+
+        // The value of 1 through 19 decimal digits.
+        inline auto value_of_decimal_digits( const char* p, const int n )
+            -> Unit
+        {
+            Unit result = 0;
+            int i = 0;
+            for( ; i + 8 <= n; i += 8 ) {
+                result = result*pow10_table[8] + swar::value_of_8_decimal_digits( swar::load_8_chars( p + i ) );
+            }
+            for( ; i < n; ++i ) { result = result*10 + Unit( p[i] - '0' ); }
+            return result;
+        }
+
+        // The value of the decimal `digits`, split in a high part and a low part with 19·2^i
+        // digits for the largest such power less than the number of digits, where the parts
+        // are converted recursively.
+        inline auto value_of_decimal( const string_view& digits, const vector<Big_uint>& powers )
+            -> Big_uint
+        {
+            const int n = int( digits.size() );
+            if( n <= 19*radix_conversion_max_simple_units ) {
+                Big_uint result;
+                int i = 0;
+                if( const int n_first = n % 19; n_first > 0 ) {
+                    result = value_of_decimal_digits( digits.data(), n_first );
+                    i = n_first;
+                }
+                for( ; i < n; i += 19 ) {
+                    result.multiply_by_64_bit( pow10_19 );
+                    result.add_64_bit( value_of_decimal_digits( digits.data() + i, 19 ) );
+                }
+                return result;
+            }
+
+            int i_power = 0;
+            while( (19 << (i_power + 1)) < n ) { ++i_power; }
+            const int n_low_digits = 19 << i_power;
+            Big_uint result = value_of_decimal( digits.substr( 0, n - n_low_digits ), powers );
+            result *= powers[i_power];
+            result += value_of_decimal( digits.substr( n - n_low_digits ), powers );
+            return result;
+        }
+    }  // namespace impl::big_uint
+
+    inline void Big_uint::reserve( const int n )
+    {
+        if( n <= m_capacity ) { return; }
+        const int new_capacity = max( n, 2*m_capacity );
+        auto p_new_units = unique_ptr<Unit[]>( new Unit[new_capacity] );
+        copy( data(), data() + m_size, p_new_units.get() );
+        m_heap_units = move( p_new_units );
+        m_capacity = new_capacity;
+    }
+
+    inline void Big_uint::resize( const int n )
+    {
+        reserve( n );
+        if( n > m_size ) { fill( data() + m_size, data() + n, Unit( 0 ) ); }
+        m_size = n;
+    }
+
+    inline void Big_uint::trim()
+    {
+        m_size = impl::big_uint::n_significant( data(), m_size );
+    }
+
+    inline Big_uint::Big_uint( const Self& other ):
+        Big_uint()
+    { *this = other; }
+
+    inline Big_uint::Big_uint( Self&& other ) noexcept:
+        m_size( other.m_size ),
+        m_capacity( other.m_capacity ),
+        m_heap_units( move( other.m_heap_units ) ),
+        m_inline_units()
+    {
+        if( not m_heap_units ) { copy( other.m_inline_units, other.m_inline_units + m_size, m_inline_units ); }
+        other.m_size = 0;
+        other.m_capacity = n_inline_units;
+    }
+
+    inline auto Big_uint::operator=( const Self& other )
+        -> Self&
+    {
+        if( &other != this ) {
+            reserve( other.m_size );
+            copy( other.data(), other.data() + other.m_size, data() );
+            m_size = other.m_size;
+        }
+        return *this;
+    }
+
+    inline auto Big_uint::operator=( Self&& other ) noexcept
+        -> Self&
+    {
+        if( &other != this ) {
+            m_size = other.m_size;
+            m_capacity = other.m_capacity;
+            m_heap_units = move( other.m_heap_units );
+            if( not m_heap_units ) { copy( other.m_inline_units, other.m_inline_units + m_size, m_inline_units ); }
+            other.m_size = 0;
+            other.m_capacity = n_inline_units;
+        }
+        return *this;
+    }
+
+    inline auto Big_uint::from_units( const Unit* const p_first, const int n )
+        -> Self
+    {
+        Self result;
+        result.resize( n );
+        copy( p_first, p_first + n, result.data() );
+        result.trim();
+        return result;
+    }
+
+    inline auto Big_uint::bit_width() const
+        -> int
+    { return (m_size == 0? 0 : 64*m_size - n_leading_zeros_in( data()[m_size - 1] )); }
+
+    inline void Big_uint::operator++() { add_64_bit( 1 ); }
+    inline void Big_uint::operator--() { *this -= Self( 1 ); }
+
+    inline void Big_uint::operator+=( const Self& other )
+    {
+        const int n = max( m_size, other.m_size ) + 1;
+        const int n_other = other.m_size;       // Before a resize, in case `other` is `*this`.
+        resize( n );
+        impl::big_uint::add_into( data(), n, other.data(), n_other );
+        trim();
+    }
+
+    inline void Big_uint::operator-=( const Self& other )
+    {
+        hopefully( other <= *this )
+            or KS_FAIL_( std_exception::out_of_range, "A Big_uint subtraction result would be negative." );
+        impl::big_uint::subtract_from( data(), m_size, other.data(), other.m_size );
+        trim();
+    }
+
+    inline void Big_uint::operator*=( const Self& other ) { *this = *this * other; }
+    inline void Big_uint::operator/=( const Self& other ) { *this = divmod( *this, other ).quotient; }
+    inline void Big_uint::operator%=( const Self& other ) { *this = divmod( *this, other ).remainder; }
+
+    inline void Big_uint::add_64_bit( const Unit a )
+    {
+        const Unit addend[1] = { a };
+        resize( m_size + 1 );
+        impl::big_uint::add_into( data(), m_size, addend, 1 );
+        trim();
+    }
+
+    inline void Big_uint::multiply_by_64_bit( const Unit a )
+    {
+        const int n = m_size;
+        resize( n + 1 );
+        data()[n] = impl::big_uint::multiply_unit( data(), data(), n, a );
+        trim();
+    }
+
+    inline auto Big_uint::divmod_by_64_bit( const Unit b ) const
+        -> Divmod_result
+    {
+        hopefully( b != 0 ) or KS_FAIL( "Division by zero." );
+        Divmod_result result;
+        result.quotient.resize( m_size );
+        Unit remainder = 0;
+        for( int i = m_size - 1; i >= 0; --i ) {
+            result.quotient.data()[i] = divide_double_unit( remainder, data()[i], b, remainder );
+        }
+        result.quotient.trim();
+        result.remainder = remainder;
+        return result;
+    }
+
+    inline auto operator+( const Big_uint& a, const Big_uint& b )
+        -> Big_uint
+    {
+        Big_uint result = a;
+        result += b;
+        return result;
+    }
+
+    inline auto operator-( const Big_uint& a, const Big_uint& b )
+        -> Big_uint
+    {
+        Big_uint result = a;
+        result -= b;
+        return result;
+    }
+
+    inline auto operator*( const Big_uint& a, const Big_uint& b )
+        -> Big_uint
+    {
+        if( a.is_zero() or b.is_zero() ) { return Big_uint(); }
+        Big_uint result;
+        result.resize( a.m_size + b.m_size );
+        impl::big_uint::multiply( result.data(), a.data(), a.m_size, b.data(), b.m_size );
+        result.trim();
+        return result;
+    }
+
+    inline auto divmod( const Big_uint& a, const Big_uint& b )
+        -> Big_uint::Divmod_result
+    {
+        hopefully( not b.is_zero() ) or KS_FAIL( "Division by zero." );
+        if( b.m_size == 1 ) { return a.divmod_by_64_bit( b.data()[0] ); }
+        if( a < b ) { return Big_uint::Divmod_result{ a, Big_uint() }; }
+
+        Big_uint::Divmod_result result;
+        result.quotient.resize( a.m_size - b.m_size + 1 );
+        result.remainder.resize( b.m_size );
+        impl::big_uint::divide(
+            result.quotient.data(), result.remainder.data(), a.data(), a.m_size, b.data(), b.m_size
+            );
+        result.quotient.trim();
+        result.remainder.trim();
+        return result;
+    }
+
+    inline auto operator/( const Big_uint& a, const Big_uint& b )
+        -> Big_uint
+    { return divmod( a, b ).quotient; }
+
+    inline auto operator%( const Big_uint& a, const Big_uint& b )
+        -> Big_uint
+    { return divmod( a, b ).remainder; }
+
+    inline auto compare( const Big_uint& a, const Big_uint& b )
+        -> int
+    {
+        if( a.n_units() != b.n_units() ) { return (a.n_units() < b.n_units()? -1 : +1); }
+        for( int i = a.n_units() - 1; i >= 0; --i ) {
+            if( const int r = compare( a.units()[i], b.units()[i] ) ) { return r; }
+        }
+        return 0;
+    }
+
+    inline auto operator<( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) < 0); }
+
+    inline auto operator<=( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) <= 0); }
+
+    inline auto operator==( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) == 0); }
+
+    inline auto operator>=( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) >= 0); }
+
+    inline auto operator>( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) > 0); }
+
+    inline auto operator!=( const Big_uint& a, const Big_uint& b )
+        -> Truth
+    { return (compare( a, b ) != 0); }
+
+    inline auto operator<<( string& s, const Big_uint& v )
+        -> string&
+    {
+        using namespace impl::big_uint;
+        if( v.is_zero() ) {
+            s += '0';
+        } else if( v.n_units() <= radix_conversion_max_simple_units ) {
+            append_decimal_simply( s, v, 0 );
+        } else {
+            const vector<Big_uint> powers = decimal_powers( v );
+            vector<Big_uint> reciprocals( powers.size() );
+            append_decimal( s, v, powers, reciprocals, int( powers.size() ) - 2, false );
+        }
+        return s;
+    }
+
+    inline auto str( const Big_uint& v )
+        -> string
+    {
+        string result;
+        result << v;
+        return result;
+    }
+
+    // Parses a value specified like for `parse_uint_128`, i.e. decimal or `0x` hexadecimal or
+    // `0b` binary, with optional apostrophes between digits. Only `E::no_digits`,
+    // `E::invalid_character` and `E::misplaced_separator` errors are possible.
+    inline auto parse_big_uint( const string_view& spec )
+        -> Parsing_result_<Big_uint>
+    {
+        using E = Parsing_error;
+        using Unit = Big_uint::Unit;
+
+        const int n = int( spec.size() );
+        int radix = 10;
+        int i_first = 0;
+        if( n >= 2 and spec[0] == '0' ) {
+            const char ch = spec[1];
+            if( ch == 'x' or ch == 'X' ) {
+                radix = 16;  i_first = 2;
+            } else if( ch == 'b' or ch == 'B' ) {
+                radix = 2;  i_first = 2;
+            }
+        }
+
+        string digits;
+        digits.reserve( n - i_first );
+        for( int i = i_first; i < n; ++i ) {
+            const char ch = spec[i];
+            if( impl::digit_value( ch, radix ) >= 0 ) {
+                digits += ch;
+            } else if( ch == apostrophe ) {
+                const Truth is_between_digits = (i > i_first and i + 1 < n
+                    and impl::digit_value( spec[i - 1], radix ) >= 0
+                    and impl::digit_value( spec[i + 1], radix ) >= 0
+                    );
+                if( not is_between_digits ) { return {Big_uint(), E::misplaced_separator, i}; }
+            } else {
+                return {Big_uint(), E::invalid_character, i};
+            }
+        }
+        if( digits.empty() ) { return {Big_uint(), E::no_digits, n}; }
+
+        if( radix == 10 ) {
+            const int n_digits = int( digits.size() );
+            vector<Big_uint> powers;
+            if( n_digits > 19*impl::big_uint::radix_conversion_max_simple_units ) {
+                powers = impl::big_uint::decimal_powers( Big_uint(), n_digits/2 );
+            }
+            return {impl::big_uint::value_of_decimal( digits, powers ), E::none, n};
+        }
+
+        // A power of 2 radix maps directly to bits of the units, from the least significant.
+        const int bits_per_digit = (radix == 16? 4 : 1);
+        const int n_bits = int( digits.size() )*bits_per_digit;
+        vector<Unit> units( (n_bits + 63)/64 );
+        int i_bit = 0;
+        for( int i = int( digits.size() ) - 1; i >= 0; --i ) {
+            units[i_bit/64] |= Unit( impl::digit_value( digits[i], radix ) ) << (i_bit % 64);
+            i_bit += bits_per_digit;
+        }
+        return {Big_uint::from_units( units.data(), int( units.size() ) ), E::none, n};
+    }
+
+    // Like `parse_big_uint`, but reports failure by throwing a `std::runtime_error`.
+    inline auto to_big_uint( const string_view& spec )
+        -> Big_uint
+    {
+        Parsing_result_<Big_uint> r = parse_big_uint( spec );
+        if( not r.is_ok() ) {
+            impl::throw_parsing_exception( r.error, spec, r.position, "Big_uint" );
+        }
+        return move( r.value );
+    }
+
+    inline auto operator""_big( const C_str spec )
+        -> Big_uint
+    { return to_big_uint( string_view( spec ) ); }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Big_uint,
+        d::parse_big_uint,
+        d::to_big_uint,
+        d::operator""_big;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,696 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/language/type-aliases.hpp>             // C_str
+#include <kickstart/core/large-integers/Big_uint.hpp>           // Big_uint, for a wide division
+#include <kickstart/core/large-integers/decimal-digits.hpp>     // pow10_table, pow10_19
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>        // Uint_256, wide_product_of
+#include <kickstart/core/large-integers/Int_128.hpp>
+#include <kickstart/core/large-integers/Uint_128.hpp>
+
+#include <string>           // string
+#include <string_view>      // string_view
+
+// Fixed-point decimal numbers represented as an `Int_128` count of units of 10^-scale, e.g.
+// cents with scale 2, for amounts of money. `Decimal_128` has a run time scale, and
+// `Decimal_128_<scale>` has a compile time scale. Addition and subtraction are exact, while
+// multiplication and division round the result according to a `Rounding::Enum`, by default
+// `Rounding::half_even`. Results that are out of range are reported by throwing a
+// `std::out_of_range`. The text conversions work directly with the digits, not via `double`.
+
+namespace kickstart::large_integers::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    namespace kl = kickstart::language;
+    using   kl::C_str, kl::Truth;
+    using   std::string,
+            std::string_view;
+
+    struct Rounding{ enum Enum{ half_even, half_away_from_zero, toward_zero, floor, ceiling }; };
+
+    namespace impl::decimal {
+        using Unit = Uint_128::Unit;
+
+        constexpr int               max_scale           = 38;       // 10^38 < 2^127 < 10^39.
+        constexpr Rounding::Enum    default_rounding    = Rounding::half_even;
+
+        // 1 + 39 digits + a decimal point, or "-0." + 38 digits.
+        constexpr int               max_text_length     = 1 + Uint_128::max_decimal_digits + 1;
+
+        inline constexpr auto pow10( const int n )
+            -> Uint_128
+        { return (n <= 19? Uint_128( pow10_table[n] ) : pow10_table[n - 19]*Uint_128( pow10_19 )); }
+
+        inline void check_scale( const int scale )
+        {
+            hopefully( 0 <= scale and scale <= max_scale )
+                or KS_FAIL_( std_exception::out_of_range, "A Decimal_128 scale must be in the range 0 through 38." );
+        }
+
+        // Whether a truncated magnitude quotient `q` should be incremented, given the position
+        // of the remainder relative to half the divisor.
+        inline constexpr auto is_rounded_away(
+            const Rounding::Enum    rounding,
+            const Truth             is_negative,
+            const Truth             q_is_odd,
+            const Truth             remainder_is_zero,
+            const int               remainder_vs_half       // <0, 0 or >0.
+            ) -> Truth
+        {
+            switch( rounding ) {
+                case Rounding::half_even:           return (remainder_vs_half > 0 or (remainder_vs_half == 0 and q_is_odd));
+                case Rounding::half_away_from_zero: return (remainder_vs_half >= 0 and not remainder_is_zero);
+                case Rounding::toward_zero:         return false;
+                case Rounding::floor:               return (is_negative and not remainder_is_zero);
+                case Rounding::ceiling:             return (not is_negative and not remainder_is_zero);
+            }
+            return false;   // Not reached.
+        }
+
+        inline auto rounded(
+            const Uint_128&         q,
+            const Uint_128&         remainder,
+            const Uint_128&         divisor,
+            const Truth             is_negative,
+            const Rounding::Enum    rounding
+            ) -> Uint_128
+        {
+            // Comparing r with d - r avoids computing 2r, which could wrap.
+            const Truth round_away = is_rounded_away( rounding, is_negative,
+                lsb_is_set_in( q.modulo_64_bits() ), remainder == 0, compare( remainder, divisor - remainder )
+                );
+            if( not round_away ) { return q; }
+            hopefully( q != ~Uint_128() )
+                or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+            return q + 1;
+        }
+
+        inline constexpr auto max_magnitude_for( const Truth is_negative )
+            -> Uint_128
+        { return Uint_128( tag::From_parts(), Unit( is_negative? 0 : -1 ), (Unit( 1 ) << 63) - (is_negative? 0 : 1) ); }
+
+        inline auto int_128_from( const Uint_128& magnitude, const Truth is_negative )
+            -> Int_128
+        {
+            hopefully( magnitude <= max_magnitude_for( is_negative ) )
+                or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+            const auto value = Int_128::from_bits( magnitude );
+            return (is_negative? -value : value);
+        }
+
+        inline auto sum_of( const Int_128& a, const Int_128& b )
+            -> Int_128
+        {
+            Int_128 result = a;
+            hopefully( result.add( b ) == Int_128::Result_kind::math_exact )
+                or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+            return result;
+        }
+
+        inline auto difference_of( const Int_128& a, const Int_128& b )
+            -> Int_128
+        {
+            Int_128 result = a;
+            hopefully( result.subtract( b ) == Int_128::Result_kind::math_exact )
+                or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+            return result;
+        }
+
+        // `units`·10^(to - from), rounded when that is a division.
+        inline auto rescaled( const Int_128& units, const int from, const int to, const Rounding::Enum rounding )
+            -> Int_128
+        {
+            const Truth is_negative = units.is_negative();
+            Uint_128 magnitude = units.magnitude();
+            if( to >= from ) {
+                hopefully( magnitude.multiply( pow10( to - from ) ) == Uint_128::Result_kind::math_exact )
+                    or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+                return int_128_from( magnitude, is_negative );
+            }
+            const Uint_128 divisor = pow10( from - to );
+            const Uint_128::Divmod_result split = divmod( magnitude, divisor );
+            return int_128_from( rounded( split.quotient, split.remainder, divisor, is_negative, rounding ), is_negative );
+        }
+
+        // `a`·`b`/10^scale, rounded. The full product has up to 256 bits.
+        inline auto product_of( const Int_128& a, const Int_128& b, const int scale, const Rounding::Enum rounding )
+            -> Int_128
+        {
+            const Truth is_negative = (a.is_negative() != b.is_negative());
+            const Uint_256 product = wide_product_of( a.magnitude(), b.magnitude() );
+
+            // Divides by 10^scale in at most two steps with 64-bit divisors.
+            const int first_scale = (scale <= 19? scale : 19);
+            const Uint_256::Divmod_result split_1 = product.divmod_by_64_bit( pow10_table[first_scale] );
+            Uint_256 quotient = split_1.quotient;
+            Uint_128 remainder = split_1.remainder.representation().parts[0];
+            if( scale > first_scale ) {
+                const Uint_256::Divmod_result split_2 = quotient.divmod_by_64_bit( pow10_table[scale - first_scale] );
+                quotient = split_2.quotient;
+                remainder += split_2.remainder.representation().parts[0].modulo_64_bits()*Uint_128( pow10_19 );
+            }
+
+            hopefully( quotient.representation().parts[1] == 0 )
+                or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+            const Uint_128 q = rounded( quotient.representation().parts[0], remainder, pow10( scale ), is_negative, rounding );
+            return int_128_from( q, is_negative );
+        }
+
+        // `a`·10^scale/`b`, rounded. The dividend has up to 256 bits.
+        inline auto quotient_of( const Int_128& a, const Int_128& b, const int scale, const Rounding::Enum rounding )
+            -> Int_128
+        {
+            hopefully( b != 0 )
+                or KS_FAIL_( std_exception::out_of_range, "Decimal_128 division by zero." );
+            const Truth is_negative = (a.is_negative() != b.is_negative());
+            const Uint_256 dividend = wide_product_of( a.magnitude(), pow10( scale ) );
+            const Uint_128 divisor = b.magnitude();
+
+            Uint_128 q;
+            Uint_128 remainder;
+            if( divisor.is_in_64_bit_range() ) {
+                const Uint_256::Divmod_result split = dividend.divmod_by_64_bit( divisor.modulo_64_bits() );
+                hopefully( split.quotient.representation().parts[1] == 0 )
+                    or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+                q = split.quotient.representation().parts[0];
+                remainder = split.remainder.representation().parts[0];
+            } else {
+                const Big_uint::Divmod_result split = divmod( Big_uint( dividend ), Big_uint( divisor ) );
+                hopefully( split.quotient.n_units() <= 2 )
+                    or KS_FAIL_( std_exception::out_of_range, "The Decimal_128 range was exceeded." );
+                q = Uint_128( tag::From_parts(), split.quotient.unit( 0 ), split.quotient.unit( 1 ) );
+                remainder = Uint_128( tag::From_parts(), split.remainder.unit( 0 ), split.remainder.unit( 1 ) );
+            }
+            return int_128_from( rounded( q, remainder, divisor, is_negative, rounding ), is_negative );
+        }
+
+        // Exact comparison of values with possibly different scales, via 256-bit magnitudes.
+        inline auto compare( const Int_128& a, const int a_scale, const Int_128& b, const int b_scale )
+            -> int
+        {
+            if( a_scale == b_scale or a.is_negative() != b.is_negative() ) {
+                return _definitions::compare( a, b );
+            }
+            const int scale = (a_scale > b_scale? a_scale : b_scale);
+            const int r = _definitions::compare(
+                wide_product_of( a.magnitude(), pow10( scale - a_scale ) ),
+                wide_product_of( b.magnitude(), pow10( scale - b_scale ) )
+                );
+            return (a.is_negative()? -r : r);
+        }
+
+        // Writes e.g. "-12.34" for `units` -1234 with `scale` 2, and returns a pointer to beyond
+        // the text. The buffer must have room for `max_text_length` chars.
+        inline constexpr auto write_text( const Int_128& units, const int scale, char* const p_first )
+            -> char*
+        {
+            char digits[Uint_128::max_decimal_digits] = {};
+            const int n_digits = int( write_decimal_digits( units.magnitude(), digits ) - digits );
+
+            char* p = p_first;
+            if( units.is_negative() ) { *p++ = '-'; }
+            const auto copy = [&p, &digits]( const int i_first, const int i_beyond ) constexpr
+            {
+                for( int i = i_first; i < i_beyond; ++i ) { *p++ = digits[i]; }
+            };
+
+            if( scale == 0 ) {
+                copy( 0, n_digits );
+            } else if( n_digits <= scale ) {
+                *p++ = '0';  *p++ = '.';
+                for( int i = n_digits; i < scale; ++i ) { *p++ = '0'; }
+                copy( 0, n_digits );
+            } else {
+                copy( 0, n_digits - scale );
+                *p++ = '.';
+                copy( n_digits - scale, n_digits );
+            }
+            return p;
+        }
+
+        struct Parsed_units
+        {
+            Int_128     units;
+            int         scale;
+        };
+
+        // Parses e.g. "-12.345" with optional apostrophes between digits. With `scale` -1 the
+        // result scale is the number of fractional digits, and otherwise excess fractional
+        // digits are rounded away.
+        inline constexpr auto parse( const string_view& spec, const int scale, const Rounding::Enum rounding ) noexcept
+            -> Parsing_result_<Parsed_units>
+        {
+            using E = Parsing_error;
+            using R = Uint_128::Result_kind;
+
+            const char* const   chars   = spec.data();
+            const int           n       = int( spec.size() );
+            const Truth         has_sign    = (n > 0 and (chars[0] == '-' or chars[0] == '+'));
+            const Truth         is_negative = (has_sign and chars[0] == '-');
+            const int           i_first     = (has_sign? 1 : 0);
+            const auto is_digit = []( const char ch ) constexpr -> Truth { return ('0' <= ch and ch <= '9'); };
+
+            // Digits are accumulated in 64-bit chunks of up to 19 digits.
+            Uint_128    magnitude       = 0;
+            Unit        chunk           = 0;
+            int         n_chunk_digits  = 0;
+            Truth       is_overflow     = false;
+            const auto flush = [&]() constexpr
+            {
+                const R::Enum r1 = magnitude.multiply_by_64_bit( pow10_table[n_chunk_digits] );
+                const R::Enum r2 = magnitude.add_64_bit( chunk );
+                is_overflow = (is_overflow or r1 == R::wrapped or r2 == R::wrapped);
+                chunk = 0;  n_chunk_digits = 0;
+            };
+
+            int     n_digits            = 0;
+            int     i_point             = -1;
+            int     n_fraction_digits   = 0;
+            int     first_excess_digit  = -1;
+            Truth   has_nonzero_beyond  = false;    // Beyond the first excess digit.
+            for( int i = i_first; i < n; ++i ) {
+                const char ch = chars[i];
+                if( is_digit( ch ) ) {
+                    const int digit = ch - '0';
+                    ++n_digits;
+                    if( i_point >= 0 ) {
+                        if( scale >= 0 and n_fraction_digits >= scale ) {
+                            if( first_excess_digit < 0 ) {
+                                first_excess_digit = digit;
+                            } else if( digit != 0 ) {
+                                has_nonzero_beyond = true;
+                            }
+                            continue;
+                        }
+                        ++n_fraction_digits;
+                    }
+                    chunk = 10*chunk + Unit( digit );
+                    if( ++n_chunk_digits == 19 ) { flush(); }
+                } else if( ch == '.' and i_point < 0 ) {
+                    i_point = i;
+                } else if( ch == apostrophe ) {
+                    const Truth is_between_digits = (i > i_first and i + 1 < n
+                        and is_digit( chars[i - 1] ) and is_digit( chars[i + 1] )
+                        );
+                    if( not is_between_digits ) { return {{}, E::misplaced_separator, i}; }
+                } else {
+                    return {{}, E::invalid_character, i};
+                }
+            }
+            if( n_digits == 0 ) { return {{}, E::no_digits, n}; }
+            flush();
+
+            const int result_scale = (scale >= 0? scale : n_fraction_digits);
+            if( result_scale > max_scale ) { return {{}, E::range_exceeded, n}; }
+            if( n_fraction_digits < result_scale ) {
+                is_overflow = (is_overflow or magnitude.multiply( pow10( result_scale - n_fraction_digits ) ) == R::wrapped);
+            }
+
+            if( first_excess_digit >= 0 ) {
+                const int remainder_vs_half = (first_excess_digit != 5?  first_excess_digit - 5 : +has_nonzero_beyond);
+                const Truth remainder_is_zero = (first_excess_digit == 0 and not has_nonzero_beyond);
+                const Truth round_away = is_rounded_away( rounding, is_negative,
+                    lsb_is_set_in( magnitude.modulo_64_bits() ), remainder_is_zero, remainder_vs_half
+                    );
+                if( round_away ) { is_overflow = (is_overflow or magnitude.add_64_bit( 1 ) == R::wrapped); }
+            }
+
+            if( is_overflow or magnitude > max_magnitude_for( is_negative ) ) {
+                return {{}, E::range_exceeded, n};
+            }
+            const auto value = Int_128::from_bits( magnitude );
+            return {{(is_negative? -value : value), result_scale}, E::none, n};
+        }
+    }  // namespace impl::decimal
+
+    class Decimal_128
+    {
+    public:
+        static constexpr int    max_scale           = impl::decimal::max_scale;
+        static constexpr int    max_text_length     = impl::decimal::max_text_length;
+
+    private:
+        using Self = Decimal_128;
+
+        Int_128     m_units;
+        int         m_scale;
+
+    public:
+        constexpr Decimal_128():
+            m_units(), m_scale( 0 )
+        {}
+
+        // The whole number `value` represented with the specified scale, e.g. `Decimal_128( 12, 2 )`
+        // is 12.00.
+        Decimal_128( const Int_128& value, const int scale = 0 ):
+            m_units(), m_scale( scale )
+        {
+            impl::decimal::check_scale( scale );
+            m_units = impl::decimal::rescaled( value, 0, scale, impl::decimal::default_rounding );
+        }
+
+        // E.g. `Decimal_128::from_units( 1234, 2 )` is 12.34.
+        static auto from_units( const Int_128& units, const int scale )
+            -> Self
+        {
+            impl::decimal::check_scale( scale );
+            Self result;
+            result.m_units = units;  result.m_scale = scale;
+            return result;
+        }
+
+        constexpr auto units() const -> const Int_128& { return m_units; }
+        constexpr auto scale() const -> int { return m_scale; }
+        constexpr auto is_negative() const -> Truth { return m_units.is_negative(); }
+
+        auto rescaled( const int new_scale, const Rounding::Enum rounding = impl::decimal::default_rounding ) const
+            -> Self
+        {
+            impl::decimal::check_scale( new_scale );
+            return from_units( impl::decimal::rescaled( m_units, m_scale, new_scale, rounding ), new_scale );
+        }
+
+        // The result scale of a binary operation is the larger of the operand scales.
+        inline void operator+=( const Self& other );
+        inline void operator-=( const Self& other );
+        inline void operator*=( const Self& other );
+        inline void operator/=( const Self& other );
+    };
+
+    template< int scale_param >
+    class Decimal_128_
+    {
+        static_assert( 0 <= scale_param and scale_param <= impl::decimal::max_scale );
+
+    public:
+        static constexpr int    scale               = scale_param;
+        static constexpr int    max_text_length     = impl::decimal::max_text_length;
+
+    private:
+        using Self = Decimal_128_;
+
+        Int_128     m_units;
+
+    public:
+        constexpr Decimal_128_():
+            m_units()
+        {}
+
+        // The whole number `value`, e.g. `Decimal_128_<2>( 12 )` is 12.00.
+        Decimal_128_( const Int_128& value ):
+            m_units( impl::decimal::rescaled( value, 0, scale, impl::decimal::default_rounding ) )
+        {}
+
+        // E.g. `Decimal_128_<2>::from_units( 1234 )` is 12.34.
+        static constexpr auto from_units( const Int_128& units )
+            -> Self
+        {
+            Self result;
+            result.m_units = units;
+            return result;
+        }
+
+        static auto from( const Decimal_128& value, const Rounding::Enum rounding = impl::decimal::default_rounding )
+            -> Self
+        { return from_units( impl::decimal::rescaled( value.units(), value.scale(), scale, rounding ) ); }
+
+        constexpr auto units() const -> const Int_128& { return m_units; }
+        constexpr auto is_negative() const -> Truth { return m_units.is_negative(); }
+
+        operator Decimal_128() const { return Decimal_128::from_units( m_units, scale ); }
+
+        void operator+=( const Self& other ) { m_units = impl::decimal::sum_of( m_units, other.m_units ); }
+        void operator-=( const Self& other ) { m_units = impl::decimal::difference_of( m_units, other.m_units ); }
+        void operator*=( const Self& other ) { *this = product_of( *this, other ); }
+        void operator/=( const Self& other ) { *this = quotient_of( *this, other ); }
+
+        friend auto operator+( const Self& a ) -> Self { return a; }
+        friend auto operator-( const Self& a ) -> Self { return from_units( impl::decimal::difference_of( 0, a.m_units ) ); }
+
+        friend auto operator+( const Self& a, const Self& b ) -> Self { Self r = a; r += b; return r; }
+        friend auto operator-( const Self& a, const Self& b ) -> Self { Self r = a; r -= b; return r; }
+        friend auto operator*( const Self& a, const Self& b ) -> Self { return product_of( a, b ); }
+        friend auto operator/( const Self& a, const Self& b ) -> Self { return quotient_of( a, b ); }
+
+        friend auto product_of( const Self& a, const Self& b, const Rounding::Enum rounding = impl::decimal::default_rounding )
+            -> Self
+        { return from_units( impl::decimal::product_of( a.m_units, b.m_units, scale, rounding ) ); }
+
+        friend auto quotient_of( const Self& a, const Self& b, const Rounding::Enum rounding = impl::decimal::default_rounding )
+            -> Self
+        { return from_units( impl::decimal::quotient_of( a.m_units, b.m_units, scale, rounding ) ); }
+
+        friend constexpr auto compare( const Self& a, const Self& b ) -> int { return compare( a.m_units, b.m_units ); }
+        friend constexpr auto operator<( const Self& a, const Self& b ) -> Truth { return (a.m_units < b.m_units); }
+        friend constexpr auto operator<=( const Self& a, const Self& b ) -> Truth { return (a.m_units <= b.m_units); }
+        friend constexpr auto operator==( const Self& a, const Self& b ) -> Truth { return (a.m_units == b.m_units); }
+        friend constexpr auto operator>=( const Self& a, const Self& b ) -> Truth { return (a.m_units >= b.m_units); }
+        friend constexpr auto operator>( const Self& a, const Self& b ) -> Truth { return (a.m_units > b.m_units); }
+        friend constexpr auto operator!=( const Self& a, const Self& b ) -> Truth { return (a.m_units != b.m_units); }
+
+        // The buffer must have room for `max_text_length` chars.
+        friend constexpr auto write_text( const Self& v, char* const p_first )
+            -> char*
+        { return impl::decimal::write_text( v.m_units, scale, p_first ); }
+
+        friend auto operator<<( string& s, const Self& v )
+            -> string&
+        {
+            char chars[max_text_length];
+            const char* const p_beyond = write_text( v, chars );
+            return s.append( chars, p_beyond - chars );
+        }
+
+        friend auto str( const Self& v ) -> string { string result; result << v; return result; }
+    };
+
+    inline auto operator+( const Decimal_128& ) -> Decimal_128;
+    inline auto operator-( const Decimal_128& ) -> Decimal_128;
+
+    inline auto operator+( const Decimal_128& a, const Decimal_128& b ) -> Decimal_128;
+    inline auto operator-( const Decimal_128& a, const Decimal_128& b ) -> Decimal_128;
+    inline auto operator*( const Decimal_128& a, const Decimal_128& b ) -> Decimal_128;
+    inline auto operator/( const Decimal_128& a, const Decimal_128& b ) -> Decimal_128;
+
+    inline auto product_of( const Decimal_128& a, const Decimal_128& b,
+        const Rounding::Enum rounding = impl::decimal::default_rounding ) -> Decimal_128;
+    inline auto quotient_of( const Decimal_128& a, const Decimal_128& b,
+        const Rounding::Enum rounding = impl::decimal::default_rounding ) -> Decimal_128;
+
+    // Comparisons are by value, so e.g. 1.5 with scale 1 is equal to 1.50 with scale 2.
+    inline auto compare( const Decimal_128& a, const Decimal_128& b ) -> int;
+    inline auto operator<( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+    inline auto operator<=( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+    inline auto operator==( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+    inline auto operator>=( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+    inline auto operator>( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+    inline auto operator!=( const Decimal_128& a, const Decimal_128& b ) -> Truth;
+
+    inline constexpr auto write_text( const Decimal_128& v, char* const p_first ) -> char*;
+    inline auto operator<<( string& s, const Decimal_128& v ) -> string&;
+    inline auto str( const Decimal_128& v ) -> string;
+
+    inline auto parse_decimal_128( const string_view& spec ) noexcept -> Parsing_result_<Decimal_128>;
+    inline auto parse_decimal_128( const string_view& spec, const int scale,
+        const Rounding::Enum rounding = impl::decimal::default_rounding ) noexcept -> Parsing_result_<Decimal_128>;
+    inline auto to_decimal_128( const string_view& spec ) -> Decimal_128;
+    inline auto to_decimal_128( const string_view& spec, const int scale,
+        const Rounding::Enum rounding = impl::decimal::default_rounding ) -> Decimal_128;
+
+
+    //--------------------------------------------------------------------------------------------------
+
+    inline void Decimal_128::operator+=( const Self& other ) { *this = *this + other; }
+    inline void Decimal_128::operator-=( const Self& other ) { *this = *this - other; }
+    inline void Decimal_128::operator*=( const Self& other ) { *this = *this*other; }
+    inline void Decimal_128::operator/=( const Self& other ) { *this = *this/other; }
+
+    namespace impl::decimal {
+        inline auto common_scale_of( const Decimal_128& a, const Decimal_128& b )
+            -> int
+        { return (a.scale() > b.scale()? a.scale() : b.scale()); }
+    }  // namespace impl::decimal
+
+    inline auto operator+( const Decimal_128& v )
+        -> Decimal_128
+    { return v; }
+
+    inline auto operator-( const Decimal_128& v )
+        -> Decimal_128
+    { return Decimal_128::from_units( impl::decimal::difference_of( 0, v.units() ), v.scale() ); }
+
+    inline auto operator+( const Decimal_128& a, const Decimal_128& b )
+        -> Decimal_128
+    {
+        const int scale = impl::decimal::common_scale_of( a, b );
+        return Decimal_128::from_units( impl::decimal::sum_of(
+            a.rescaled( scale ).units(), b.rescaled( scale ).units()
+            ), scale );
+    }
+
+    inline auto operator-( const Decimal_128& a, const Decimal_128& b )
+        -> Decimal_128
+    {
+        const int scale = impl::decimal::common_scale_of( a, b );
+        return Decimal_128::from_units( impl::decimal::difference_of(
+            a.rescaled( scale ).units(), b.rescaled( scale ).units()
+            ), scale );
+    }
+
+    inline auto operator*( const Decimal_128& a, const Decimal_128& b )
+        -> Decimal_128
+    { return product_of( a, b ); }
+
+    inline auto operator/( const Decimal_128& a, const Decimal_128& b )
+        -> Decimal_128
+    { return quotient_of( a, b ); }
+
+    // With scales sa and sb the product of the units has scale sa + sb, which is reduced to
+    // the common scale in the same division that rounds.
+    inline auto product_of( const Decimal_128& a, const Decimal_128& b, const Rounding::Enum rounding )
+        -> Decimal_128
+    {
+        const int scale = impl::decimal::common_scale_of( a, b );
+        const Int_128 b_units = b.rescaled( scale ).units();
+        return Decimal_128::from_units( impl::decimal::product_of( a.rescaled( scale ).units(), b_units, scale, rounding ), scale );
+    }
+
+    inline auto quotient_of( const Decimal_128& a, const Decimal_128& b, const Rounding::Enum rounding )
+        -> Decimal_128
+    {
+        const int scale = impl::decimal::common_scale_of( a, b );
+        const Int_128 b_units = b.rescaled( scale ).units();
+        return Decimal_128::from_units( impl::decimal::quotient_of( a.rescaled( scale ).units(), b_units, scale, rounding ), scale );
+    }
+
+    inline auto compare( const Decimal_128& a, const Decimal_128& b )
+        -> int
+    { return impl::decimal::compare( a.units(), a.scale(), b.units(), b.scale() ); }
+
+    inline auto operator<( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) < 0); }
+
+    inline auto operator<=( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) <= 0); }
+
+    inline auto operator==( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) == 0); }
+
+    inline auto operator>=( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) >= 0); }
+
+    inline auto operator>( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) > 0); }
+
+    inline auto operator!=( const Decimal_128& a, const Decimal_128& b )
+        -> Truth
+    { return (compare( a, b ) != 0); }
+
+    // The buffer must have room for `Decimal_128::max_text_length` chars.
+    inline constexpr auto write_text( const Decimal_128& v, char* const p_first )
+        -> char*
+    { return impl::decimal::write_text( v.units(), v.scale(), p_first ); }
+
+    inline auto operator<<( string& s, const Decimal_128& v )
+        -> string&
+    {
+        char chars[Decimal_128::max_text_length];
+        const char* const p_beyond = write_text( v, chars );
+        return s.append( chars, p_beyond - chars );
+    }
+
+    inline auto str( const Decimal_128& v )
+        -> string
+    {
+        string result;
+        result << v;
+        return result;
+    }
+
+    namespace impl::decimal {
+        inline auto as_decimal_128( const Parsing_result_<Parsed_units>& r )
+            -> Parsing_result_<Decimal_128>
+        {
+            if( not r.is_ok() ) { return {{}, r.error, r.position}; }
+            return {Decimal_128::from_units( r.value.units, r.value.scale ), r.error, r.position};
+        }
+    }  // namespace impl::decimal
+
+    // The scale is the number of digits after the decimal point, if any, in `spec`.
+    inline auto parse_decimal_128( const string_view& spec ) noexcept
+        -> Parsing_result_<Decimal_128>
+    { return impl::decimal::as_decimal_128( impl::decimal::parse( spec, -1, impl::decimal::default_rounding ) ); }
+
+    // Excess digits after the decimal point are rounded away according to `rounding`.
+    inline auto parse_decimal_128( const string_view& spec, const int scale, const Rounding::Enum rounding ) noexcept
+        -> Parsing_result_<Decimal_128>
+    {
+        if( not (0 <= scale and scale <= Decimal_128::max_scale) ) {
+            return {{}, Parsing_error::range_exceeded, 0};
+        }
+        return impl::decimal::as_decimal_128( impl::decimal::parse( spec, scale, rounding ) );
+    }
+
+    // Like `parse_decimal_128`, but reports failure by throwing a `std::runtime_error`.
+    inline auto to_decimal_128( const string_view& spec )
+        -> Decimal_128
+    {
+        const Parsing_result_<Decimal_128> r = parse_decimal_128( spec );
+        if( not r.is_ok() ) {
+            impl::throw_parsing_exception( r.error, spec, r.position, "Decimal_128" );
+        }
+        return r.value;
+    }
+
+    inline auto to_decimal_128( const string_view& spec, const int scale, const Rounding::Enum rounding )
+        -> Decimal_128
+    {
+        const Parsing_result_<Decimal_128> r = parse_decimal_128( spec, scale, rounding );
+        if( not r.is_ok() ) {
+            impl::throw_parsing_exception( r.error, spec, r.position, "Decimal_128" );
+        }
+        return r.value;
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Rounding,
+        d::Decimal_128,
+        d::Decimal_128_,
+        d::parse_decimal_128,
+        d::to_decimal_128;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
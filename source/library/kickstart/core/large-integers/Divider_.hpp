@@ -0,0 +1,174 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/language/lx/bits_per_.hpp>             // lx::bits_per_
+#include <kickstart/core/large-integers/Uint_double_of_.hpp>
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // n_leading_zeros_in, divide_double_unit, ...
+
+#include <type_traits>      // is_unsigned_v
+
+// A `Divider_` precomputes a reciprocal of a divisor, so that each division by it is a
+// multiplication and a shift, as in the libdivide library. This pays off when the same
+// divisor is used for many divisions. The constructor is `constexpr`, so with a constant
+// divisor, e.g. `constexpr auto by_1000 = Divider_<uint32_t>( 1000 );`, all of the set up
+// happens at compile time. `Divider_<Uint_128>` is specialized in “Uint_128.hpp”.
+
+namespace kickstart::large_integers::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    namespace kl = kickstart::language;
+    using   kl::lx::bits_per_,
+            kl::Truth;
+    using   std::is_unsigned_v;
+
+    template< class Unit_param >
+    class Divider_
+    {
+        static_assert( is_unsigned_v<Unit_param> );
+
+    public:
+        using Unit = Unit_param;
+        struct Divmod_result{ Unit remainder; Unit quotient; };
+
+    private:
+        struct Method{ enum Enum{ shift, multiply, multiply_add }; };
+
+        Unit                    m_divisor;
+        typename Method::Enum   m_method;
+        Unit                    m_multiplier;           // The “magic number” for a single Unit dividend.
+        int                     m_n_shifts;             // ⌊log2( m_divisor )⌋.
+        int                     m_n_normalizing_shifts; // Such that the shifted divisor has its msb set.
+        Unit                    m_reciprocal;           // ⌊(radix² - 1)/normalized divisor⌋ - radix.
+
+        static constexpr auto high_product_of( const Unit a, const Unit b )
+            -> Unit
+        { return Uint_double_of_<Unit>::product_of( a, b ).parts[1]; }
+
+    public:
+        constexpr explicit Divider_( const Unit divisor ):
+            m_divisor( divisor ),
+            m_method( Method::shift ),
+            m_multiplier( 0 ),
+            m_n_shifts( bits_per_<Unit> - 1 - n_leading_zeros_in( divisor ) ),
+            m_n_normalizing_shifts( n_leading_zeros_in( divisor ) ),
+            m_reciprocal( 0 )
+        {
+            hopefully( divisor != 0 )
+                or KS_FAIL_( std_exception::invalid_argument, "The divisor must be non-zero." );
+
+            const Unit power = Unit( Unit( 1 ) << m_n_shifts );
+            if( divisor != power ) {
+                // With m = ⌊radix·2^n_shifts/divisor⌋ + 1 the high half of a product m·x, shifted
+                // right n_shifts, is x/divisor when the rounding error e is small enough. Else
+                // a multiplier with 1 more bit is used, where the top bit is handled as an add.
+                Unit remainder = 0;
+                const Unit m = _definitions::divide_double_unit( power, Unit( 0 ), divisor, remainder );
+                const Unit e = Unit( divisor - remainder );
+                if( e < power ) {
+                    m_method = Method::multiply;
+                    m_multiplier = Unit( m + 1 );
+                } else {
+                    const Unit twice_remainder = Unit( remainder + remainder );
+                    const Truth carry = (twice_remainder >= divisor or twice_remainder < remainder);
+                    m_method = Method::multiply_add;
+                    m_multiplier = Unit( m + m + +carry + 1 );
+                }
+            }
+
+            const Unit normalized = Unit( divisor << m_n_normalizing_shifts );
+            Unit ignored_remainder = 0;
+            m_reciprocal = _definitions::divide_double_unit( Unit( ~normalized ), Unit( ~Unit( 0 ) ), normalized, ignored_remainder );
+        }
+
+        constexpr auto divisor() const -> Unit { return m_divisor; }
+
+        constexpr auto quotient_of( const Unit x ) const
+            -> Unit
+        {
+            switch( m_method ) {
+                case Method::shift: {
+                    return Unit( x >> m_n_shifts );
+                }
+                case Method::multiply: {
+                    return Unit( high_product_of( m_multiplier, x ) >> m_n_shifts );
+                }
+                case Method::multiply_add: {
+                    const Unit t = high_product_of( m_multiplier, x );
+                    return Unit( (Unit( Unit( x - t ) >> 1 ) + t) >> m_n_shifts );
+                }
+            }
+            return 0;   // Not reached.
+        }
+
+        constexpr auto divmod( const Unit x ) const
+            -> Divmod_result
+        {
+            const Unit q = quotient_of( x );
+            return Divmod_result{ Unit( x - q*m_divisor ), q };
+        }
+
+        // Returns (high·radix + low)/divisor and sets `remainder`, where radix = 2^bits_per_<Unit>.
+        // Requires high < divisor, which means that the quotient fits in a Unit. This is the
+        // division of a double Unit by an invariant Unit in Möller and Granlund's “Improved
+        // division by invariant integers”, with 1 multiplication and at most 2 adjustments.
+        constexpr auto divide_double_unit( const Unit high, const Unit low, Unit& remainder ) const
+            -> Unit
+        {
+            const int   s   = m_n_normalizing_shifts;
+            const Unit  d   = Unit( m_divisor << s );
+            const Unit  u1  = Unit( high << s | (s == 0? 0 : low >> (bits_per_<Unit> - s)) );
+            const Unit  u0  = Unit( low << s );
+
+            const Uint_double_of_<Unit> product = Uint_double_of_<Unit>::product_of( m_reciprocal, u1 );
+            Truth carry = false;
+            const Unit q0 = add_with_carry( product.parts[0], u0, carry );
+            Unit q1 = add_with_carry( product.parts[1], Unit( u1 + 1 ), carry );
+            Unit r = Unit( u0 - q1*d );
+            if( r > q0 ) { --q1; r = Unit( r + d ); }
+            if( r >= d ) { ++q1; r = Unit( r - d ); }
+            remainder = Unit( r >> s );
+            return q1;
+        }
+
+        friend constexpr auto operator/( const Unit x, const Divider_& divider )
+            -> Unit
+        { return divider.quotient_of( x ); }
+
+        friend constexpr auto operator%( const Unit x, const Divider_& divider )
+            -> Unit
+        { return divider.divmod( x ).remainder; }
+    };
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Divider_;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,452 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/large-integers/decimal-digits.hpp>     // write_decimal_digits
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/large-integers/Uint_double_of_.hpp>
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // add_with_carry, ...
+
+#include <stdint.h>         // uint64_t
+
+#include <string>           // string
+#include <type_traits>      // enable_if_t, is_integral_v, is_signed_v
+
+namespace kickstart::large_integers::_definitions {
+    namespace kl = kickstart::language;
+
+    using   kl::Truth;
+    using   std::string,
+            std::enable_if_t, std::is_integral_v, std::is_signed_v;
+
+    // Fixed width unsigned integers of 256, 512, 1024 etc. bits, where each width is a
+    // `Uint_double_of_` the half width, down to `Uint_128`. Like `Uint_128` the operations
+    // wrap, and they can all be evaluated at compile time.
+    template< int n_bits_param > class Fixed_uint_;
+
+    using Uint_256  = Fixed_uint_<256>;
+    using Uint_512  = Fixed_uint_<512>;
+    using Uint_1024 = Fixed_uint_<1024>;
+
+    // Full products, `wide_product_of`, with at least this number of bits per factor are
+    // computed with Karatsuba's 3 half width multiplications instead of the schoolbook method's
+    // 4. With g++ on x86-64 that paid off from 1024 bits, where the extra additions cost less
+    // than a 512-bit product.
+    //
+    // The wrapped product of `*` doesn't use Karatsuba directly. It needs only one full half
+    // width product plus two wrapped ones, which is cheaper than Karatsuba's three full half
+    // width products, e.g. about 1/3 of the time for 1024 bits. The full half width product
+    // uses Karatsuba when the half width is at least this number of bits, i.e. from 2048 bits.
+    constexpr int karatsuba_min_bits = 1024;
+
+    namespace impl {
+        template< int n_bits > struct Half_of_fixed_uint_t_     { using T = Fixed_uint_<n_bits/2>; };
+        template<> struct Half_of_fixed_uint_t_<256>            { using T = Uint_128; };
+
+        template< class Uint > struct Wide_t_;
+        template<> struct Wide_t_<uint64_t>                     { using T = Uint_128; };
+        template<> struct Wide_t_<Uint_128>                     { using T = Fixed_uint_<256>; };
+        template< int n_bits > struct Wide_t_<Fixed_uint_<n_bits>> { using T = Fixed_uint_<2*n_bits>; };
+    }  // namespace impl
+
+    // The unsigned type with twice the number of bits of `Uint`.
+    template< class Uint > using Wide_ = typename impl::Wide_t_<Uint>::T;
+
+    template< int n_bits_param >
+    class Fixed_uint_
+    {
+        static_assert( n_bits_param >= 256 and (n_bits_param & (n_bits_param - 1)) == 0 );
+
+    public:
+        using Unit      = uint64_t;
+        using Half      = typename impl::Half_of_fixed_uint_t_<n_bits_param>::T;
+        using Parts     = Uint_double_of_<Half>;
+        static constexpr int n_bits     = n_bits_param;
+        static constexpr int n_units    = n_bits/64;
+        static constexpr int max_decimal_digits = n_bits*30103/100000 + 1;     // log10(2) ≈ 0.30103
+
+    private:
+        using Self = Fixed_uint_;
+
+        Parts   m_value;
+
+    public:
+        constexpr Fixed_uint_():
+            m_value()
+        {}
+
+        // Yields `value` modulo 2^n_bits.
+        template< class Integer, class = enable_if_t<is_integral_v<Integer>> >
+        constexpr Fixed_uint_( const Integer value ):
+            m_value{ Half( value ), Half( is_signed_v<Integer> and value < 0? -1 : 0 ) }
+        {}
+
+        constexpr Fixed_uint_( const Uint_128& value ):
+            m_value{ Half( value ), Half() }
+        {}
+
+        constexpr Fixed_uint_( tag::From_parts, const Half& lsp, const Half& msp = Half() ):
+            m_value{ lsp, msp }
+        {}
+
+        constexpr auto representation() const -> const Parts& { return m_value; }
+
+        // The i'th 64-bit unit, where unit 0 is the least significant.
+        constexpr auto unit( const int i ) const
+            -> Unit
+        {
+            if constexpr( n_bits == 256 ) {
+                return m_value.parts[i/2].representation().parts[i%2];
+            } else {
+                constexpr int n_half_units = n_units/2;
+                return (i < n_half_units? m_value.parts[0].unit( i ) : m_value.parts[1].unit( i - n_half_units ));
+            }
+        }
+
+        constexpr auto modulo_64_bits() const -> Unit { return unit( 0 ); }
+
+        constexpr auto operator~() const
+            -> Self
+        { return Self( tag::From_parts(), ~m_value.parts[0], ~m_value.parts[1] ); }
+
+        constexpr void operator++() { *this += Self( 1 ); }
+        constexpr void operator--() { *this -= Self( 1 ); }
+
+        constexpr void operator+=( const Self& other ) { add( other ); }
+        constexpr void operator-=( const Self& other ) { subtract( other ); }
+        inline constexpr void operator*=( const Self& other );
+
+        struct Divmod_result;
+        inline constexpr auto divmod_by_64_bit( const Unit b ) const -> Divmod_result;
+
+        using Result_kind = Uint_128::Result_kind;
+        inline constexpr auto add( const Self& other ) -> Result_kind::Enum;
+        inline constexpr auto subtract( const Self& other ) -> Result_kind::Enum;
+
+        friend constexpr auto operator+( const Self& value ) -> Self { return value; }
+        friend constexpr auto operator-( const Self& value ) -> Self { Self r = ~value; ++r; return r; }
+
+        friend constexpr auto operator+( const Self& a, const Self& b ) -> Self { Self r = a; r += b; return r; }
+        friend constexpr auto operator-( const Self& a, const Self& b ) -> Self { Self r = a; r -= b; return r; }
+        friend constexpr auto operator*( const Self& a, const Self& b ) -> Self { Self r = a; r *= b; return r; }
+
+        friend constexpr auto operator/( const Self& a, const Unit b ) -> Self { return a.divmod_by_64_bit( b ).quotient; }
+        friend constexpr auto operator%( const Self& a, const Unit b ) -> Self { return a.divmod_by_64_bit( b ).remainder; }
+
+        friend constexpr auto compare( const Self& a, const Self& b ) -> int { return compare( a.m_value, b.m_value ); }
+        friend constexpr auto operator<( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) < 0); }
+        friend constexpr auto operator<=( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) <= 0); }
+        friend constexpr auto operator==( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) == 0); }
+        friend constexpr auto operator>=( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) >= 0); }
+        friend constexpr auto operator>( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) > 0); }
+        friend constexpr auto operator!=( const Self& a, const Self& b ) -> Truth { return (compare( a, b ) != 0); }
+    };
+
+    template< int n_bits >
+    inline constexpr auto add_with_carry( const Fixed_uint_<n_bits>& a, const Fixed_uint_<n_bits>& b, Truth& carry )
+        -> Fixed_uint_<n_bits>;
+
+    template< int n_bits >
+    inline constexpr auto subtract_with_borrow( const Fixed_uint_<n_bits>& a, const Fixed_uint_<n_bits>& b, Truth& borrow )
+        -> Fixed_uint_<n_bits>;
+
+    inline constexpr auto wide_product_of( const uint64_t a, const uint64_t b ) -> Uint_128;
+    inline constexpr auto wide_product_of( const Uint_128& a, const Uint_128& b ) -> Uint_256;
+
+    template< class Uint >
+    inline constexpr auto wide_product_of( const Uint& a, const Uint& b ) -> Wide_<Uint>;
+
+    template< int n_bits >
+    inline constexpr auto write_decimal_digits( const Fixed_uint_<n_bits>& v, char* const p_first ) -> char*;
+
+    template< int n_bits >
+    inline auto operator<<( string& s, const Fixed_uint_<n_bits>& v ) -> string&;
+
+    template< int n_bits >
+    inline auto str( const Fixed_uint_<n_bits>& v ) -> string;
+
+
+    //--------------------------------------------------------------------------------------------------
+
+    namespace impl {
+        // The product modulo 2^n, where n is the number of bits of the type: a0·b0 + 2^h·(a0·b1
+        // + a1·b0), where h is the half width and only the full a0·b0 is needed.
+        inline constexpr auto wrapped_product_of( const Uint_128& a, const Uint_128& b )
+            -> Uint_128
+        { return a*b; }
+
+        template< int n_bits >
+        inline constexpr auto wrapped_product_of( const Fixed_uint_<n_bits>& a, const Fixed_uint_<n_bits>& b )
+            -> Fixed_uint_<n_bits>
+        {
+            using Half = typename Fixed_uint_<n_bits>::Half;
+            const Half& a0 = a.representation().parts[0];
+            const Half& a1 = a.representation().parts[1];
+            const Half& b0 = b.representation().parts[0];
+            const Half& b1 = b.representation().parts[1];
+
+            Fixed_uint_<n_bits> result = wide_product_of( a0, b0 );
+            result += Fixed_uint_<n_bits>( tag::From_parts(), Half(),
+                wrapped_product_of( a0, b1 ) + wrapped_product_of( a1, b0 )
+                );
+            return result;
+        }
+
+        // Divides the number `remainder`·2^n + `a` by `b`, where n is the number of bits of `a`,
+        // and `remainder` < `b`. Updates `remainder` and returns the quotient.
+        inline constexpr auto divided_by_64_bit( const uint64_t a, const uint64_t b, uint64_t& remainder )
+            -> uint64_t
+        { return divide_double_unit( remainder, a, b, remainder ); }
+
+        template< class Uint >
+        inline constexpr auto divided_by_64_bit( const Uint& a, const uint64_t b, uint64_t& remainder )
+            -> Uint
+        {
+            using Half = typename Uint::Parts::Unit;
+            const Half q_high   = divided_by_64_bit( a.representation().parts[1], b, remainder );
+            const Half q_low    = divided_by_64_bit( a.representation().parts[0], b, remainder );
+            return Uint( tag::From_parts(), q_low, q_high );
+        }
+    }  // namespace impl
+
+    template< int n_bits >
+    inline constexpr void Fixed_uint_<n_bits>::operator*=( const Self& other )
+    {
+        *this = impl::wrapped_product_of( *this, other );
+    }
+
+    template< int n_bits >
+    struct Fixed_uint_<n_bits>::Divmod_result
+    {
+        Fixed_uint_     remainder;
+        Fixed_uint_     quotient;
+    };
+
+    // Division by 0 yields all 1-bits for both quotient and remainder.
+    template< int n_bits >
+    inline constexpr auto Fixed_uint_<n_bits>::divmod_by_64_bit( const Unit b ) const
+        -> Divmod_result
+    {
+        if( b == 0 ) { return Divmod_result{ ~Self(), ~Self() }; }
+
+        // Schoolbook division with 64-bit digits, from the most significant digit down.
+        Unit remainder = 0;
+        const Self quotient = impl::divided_by_64_bit( *this, b, remainder );
+        return Divmod_result{ Self( remainder ), quotient };
+    }
+
+    template< int n_bits >
+    inline constexpr auto Fixed_uint_<n_bits>::add( const Self& other )
+        -> Result_kind::Enum
+    {
+        using R = Result_kind;
+        Truth carry = false;
+        *this = add_with_carry( *this, other, carry );
+        return (carry? R::wrapped : R::math_exact);
+    }
+
+    template< int n_bits >
+    inline constexpr auto Fixed_uint_<n_bits>::subtract( const Self& other )
+        -> Result_kind::Enum
+    {
+        using R = Result_kind;
+        Truth borrow = false;
+        *this = subtract_with_borrow( *this, other, borrow );
+        return (borrow? R::wrapped : R::math_exact);
+    }
+
+    template< int n_bits >
+    inline constexpr auto add_with_carry( const Fixed_uint_<n_bits>& a, const Fixed_uint_<n_bits>& b, Truth& carry )
+        -> Fixed_uint_<n_bits>
+    {
+        using Half = typename Fixed_uint_<n_bits>::Half;
+        const Half low  = add_with_carry( a.representation().parts[0], b.representation().parts[0], carry );
+        const Half high = add_with_carry( a.representation().parts[1], b.representation().parts[1], carry );
+        return Fixed_uint_<n_bits>( tag::From_parts(), low, high );
+    }
+
+    template< int n_bits >
+    inline constexpr auto subtract_with_borrow( const Fixed_uint_<n_bits>& a, const Fixed_uint_<n_bits>& b, Truth& borrow )
+        -> Fixed_uint_<n_bits>
+    {
+        using Half = typename Fixed_uint_<n_bits>::Half;
+        const Half low  = subtract_with_borrow( a.representation().parts[0], b.representation().parts[0], borrow );
+        const Half high = subtract_with_borrow( a.representation().parts[1], b.representation().parts[1], borrow );
+        return Fixed_uint_<n_bits>( tag::From_parts(), low, high );
+    }
+
+    inline constexpr auto wide_product_of( const uint64_t a, const uint64_t b )
+        -> Uint_128
+    {
+        const Uint_128::Parts product = Uint_128::Parts::product_of( a, b );
+        return Uint_128( tag::From_parts(), product.parts[0], product.parts[1] );
+    }
+
+    // The four 64×64→128 products are combined with `Uint_128` additions, which are native
+    // where available; no carry out of the high half is possible.
+    inline constexpr auto wide_product_of( const Uint_128& a, const Uint_128& b )
+        -> Uint_256
+    {
+        using Unit = Uint_128::Unit;
+        const Unit a0 = a.representation().parts[0];    const Unit a1 = a.representation().parts[1];
+        const Unit b0 = b.representation().parts[0];    const Unit b1 = b.representation().parts[1];
+
+        const Uint_128 p00 = wide_product_of( a0, b0 );
+        const Uint_128 p01 = wide_product_of( a0, b1 );
+        const Uint_128 p10 = wide_product_of( a1, b0 );
+        const Uint_128 p11 = wide_product_of( a1, b1 );
+        const auto low_of   = []( const Uint_128& v ) -> Unit { return v.representation().parts[0]; };
+        const auto high_of  = []( const Uint_128& v ) -> Unit { return v.representation().parts[1]; };
+
+        const Uint_128 mid = Uint_128( high_of( p00 ) ) + low_of( p01 ) + low_of( p10 );   // < 3·2^64.
+        const Uint_128 high = p11 + high_of( p01 ) + high_of( p10 ) + high_of( mid );
+        return Uint_256( tag::From_parts(),
+            Uint_128( tag::From_parts(), low_of( p00 ), low_of( mid ) ),
+            high
+            );
+    }
+
+    // The full product, e.g. a `Uint_512` for two `Uint_256` factors. It's computed recursively
+    // from products of the halves, 4 of them with the schoolbook method, or 3 with Karatsuba's.
+    template< class Uint >
+    inline constexpr auto wide_product_of( const Uint& a, const Uint& b )
+        -> Wide_<Uint>
+    {
+        using Half = typename Uint::Parts::Unit;
+        const Half& a0 = a.representation().parts[0];
+        const Half& a1 = a.representation().parts[1];
+        const Half& b0 = b.representation().parts[0];
+        const Half& b1 = b.representation().parts[1];
+
+        const Uint low  = wide_product_of( a0, b0 );
+        const Uint high = wide_product_of( a1, b1 );
+        Half q[4] = {           // Quarters of the result, in little endian order.
+            low.representation().parts[0], low.representation().parts[1],
+            high.representation().parts[0], high.representation().parts[1]
+            };
+
+        // Adds `value` + `extra`·2^(2h) to the result at offset h, where h is the half width.
+        const auto add_at_offset_1 = [&q]( const Uint& value, const Half& extra = Half() )
+        {
+            Truth carry = false;
+            q[1] = add_with_carry( q[1], value.representation().parts[0], carry );
+            q[2] = add_with_carry( q[2], value.representation().parts[1], carry );
+            q[3] = add_with_carry( q[3], extra, carry );
+        };
+
+        if constexpr( Uint::n_bits < karatsuba_min_bits ) {
+            add_at_offset_1( wide_product_of( a0, b1 ) );
+            add_at_offset_1( wide_product_of( a1, b0 ) );
+        } else {
+            // mid = (a0 + a1)·(b0 + b1) - low - high = a0·b1 + a1·b0, which has at most 2h + 1
+            // bits. The sums can have h + 1 bits, so their carries are dealt with separately,
+            // and the bits of `mid` above the 2h least significant are kept in `mid_extra`.
+            Truth carry_a = false;     Truth carry_b = false;
+            const Half sum_a = add_with_carry( a0, a1, carry_a );
+            const Half sum_b = add_with_carry( b0, b1, carry_b );
+            const Uint sums_product = wide_product_of( sum_a, sum_b );
+
+            Half mid[2] = { sums_product.representation().parts[0], sums_product.representation().parts[1] };
+            int mid_extra = +(carry_a and carry_b);
+            const auto add_to_mid_high = [&]( const Half& value )
+            {
+                Truth carry = false;
+                mid[1] = add_with_carry( mid[1], value, carry );
+                mid_extra += +carry;
+            };
+            const auto subtract_from_mid = [&]( const Uint& value )
+            {
+                Truth borrow = false;
+                mid[0] = subtract_with_borrow( mid[0], value.representation().parts[0], borrow );
+                mid[1] = subtract_with_borrow( mid[1], value.representation().parts[1], borrow );
+                mid_extra -= +borrow;
+            };
+
+            if( carry_a ) { add_to_mid_high( sum_b ); }
+            if( carry_b ) { add_to_mid_high( sum_a ); }
+            subtract_from_mid( low );
+            subtract_from_mid( high );
+            add_at_offset_1( Uint( tag::From_parts(), mid[0], mid[1] ), Half( mid_extra ) );
+        }
+        return Wide_<Uint>( tag::From_parts(),
+            Uint( tag::From_parts(), q[0], q[1] ), Uint( tag::From_parts(), q[2], q[3] )
+            );
+    }
+
+    // Writes the shortest decimal representation of `v` starting at `p_first`, and returns a
+    // pointer to beyond the last digit. The buffer must have room for `max_decimal_digits`
+    // chars. The value is split in chunks of 19 digits that are converted with 64-bit arithmetic.
+    template< int n_bits >
+    inline constexpr auto write_decimal_digits( const Fixed_uint_<n_bits>& v, char* const p_first )
+        -> char*
+    {
+        using Uint = Fixed_uint_<n_bits>;
+        uint64_t chunks[Uint::n_units + 1] = {};
+        int n_chunks = 0;
+        Uint upper = v;
+        do {
+            const typename Uint::Divmod_result split = upper.divmod_by_64_bit( pow10_19 );
+            chunks[n_chunks++] = split.remainder.modulo_64_bits();
+            upper = split.quotient;
+        } while( upper != Uint( 0 ) );
+
+        char* p_beyond = write_decimal_digits( chunks[n_chunks - 1], p_first );
+        for( int i = n_chunks - 2; i >= 0; --i ) {
+            write_decimal_digits( chunks[i], 19, p_beyond );
+            p_beyond += 19;
+        }
+        return p_beyond;
+    }
+
+    template< int n_bits >
+    inline auto operator<<( string& s, const Fixed_uint_<n_bits>& v )
+        -> string&
+    {
+        char digits[Fixed_uint_<n_bits>::max_decimal_digits];
+        const char* const p_beyond = write_decimal_digits( v, digits );
+        return s.append( digits, p_beyond - digits );
+    }
+
+    template< int n_bits >
+    inline auto str( const Fixed_uint_<n_bits>& v )
+        -> string
+    {
+        string result;
+        result << v;
+        return result;
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Fixed_uint_,
+        d::Uint_256, d::Uint_512, d::Uint_1024,
+        d::Wide_,
+        d::wide_product_of;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,359 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/language/Truth.hpp>                // Truth
+#include <kickstart/core/language/type-aliases.hpp>         // C_str, Int64
+
+#include <string>           // string
+#include <string_view>      // string_view
+#include <type_traits>      // enable_if_t, is_integral_v
+
+namespace kickstart::large_integers::_definitions {
+    namespace kl = kickstart::language;
+
+    using   kl::C_str, kl::Int64, kl::Truth;
+    using   std::string,
+            std::string_view,
+            std::enable_if_t, std::is_integral_v;
+
+    // Two's complement signed 128-bit integer. The arithmetic is done by `Uint_128`, so the
+    // native backend is used where available, and like `Uint_128` the operations wrap.
+    class Int_128
+    {
+    public:
+        using Unit      = Uint_128::Unit;
+        static constexpr int n_bits = Uint_128::n_bits;
+        static constexpr int max_decimal_digits = Uint_128::max_decimal_digits;
+        static constexpr int max_text_length    = 1 + max_decimal_digits;   // With a minus sign.
+
+    private:
+        using Self = Int_128;
+
+        Uint_128    m_bits;
+
+    public:
+        Int_128( tag::Uninitialized ):
+            m_bits( tag::Uninitialized() )
+        {}
+
+        constexpr Int_128():
+            m_bits()
+        {}
+
+        template< class Integer, class = enable_if_t<is_integral_v<Integer>> >
+        constexpr Int_128( const Integer value ):
+            m_bits( value )         // Sign extension for a negative value.
+        {}
+
+        constexpr Int_128( tag::From_parts, const Unit lsp, const Unit msp = 0 ):
+            m_bits( tag::From_parts(), lsp, msp )
+        {}
+
+        static constexpr auto from_bits( const Uint_128& bits ) -> Self { Self result; result.m_bits = bits; return result; }
+        constexpr auto bits() const -> const Uint_128& { return m_bits; }
+
+        #ifdef KS_HAS_NATIVE_UINT_128
+            static constexpr auto from_native( const Native_int_128 value )
+                -> Self
+            { return from_bits( Uint_128::from_native( Native_uint_128( value ) ) ); }
+
+            constexpr auto as_native() const
+                -> Native_int_128
+            { return Native_int_128( m_bits.as_native() ); }
+        #endif
+
+        constexpr auto is_negative() const -> Truth { return msb_is_set_in( m_bits.representation().parts[1] ); }
+        constexpr auto is_in_64_bit_range() const -> Truth;
+        constexpr auto modulo_64_bits() const -> Int64 { return Int64( m_bits.modulo_64_bits() ); }
+
+        // The absolute value, which for the most negative value is not representable as `Int_128`.
+        inline constexpr auto magnitude() const -> Uint_128;
+
+        constexpr void operator++() { ++m_bits; }
+        constexpr void operator--() { --m_bits; }
+
+        constexpr void operator+=( const Self& other ) { m_bits += other.m_bits; }
+        constexpr void operator-=( const Self& other ) { m_bits -= other.m_bits; }
+        inline constexpr void operator*=( const Self& other );
+        inline constexpr void operator/=( const Self& other );
+        inline constexpr void operator%=( const Self& other );
+
+        struct Divmod_result;
+        using Result_kind = Uint_128::Result_kind;
+        inline constexpr auto add( const Self& other ) -> Result_kind::Enum;
+        inline constexpr auto subtract( const Self& other ) -> Result_kind::Enum;
+    };
+
+    inline constexpr auto operator+( const Int_128& ) -> Int_128;
+    inline constexpr auto operator-( const Int_128& ) -> Int_128;
+
+    inline constexpr auto operator+( const Int_128& a, const Int_128& b ) -> Int_128;
+    inline constexpr auto operator-( const Int_128& a, const Int_128& b ) -> Int_128;
+    inline constexpr auto operator*( const Int_128& a, const Int_128& b ) -> Int_128;
+
+    inline constexpr auto divmod( const Int_128& a, const Int_128& b ) -> Int_128::Divmod_result;
+    inline constexpr auto operator/( const Int_128& a, const Int_128& b ) -> Int_128;
+    inline constexpr auto operator%( const Int_128& a, const Int_128& b ) -> Int_128;
+
+    inline constexpr auto compare( const Int_128& a, const Int_128& b ) -> int;
+    inline constexpr auto operator<( const Int_128& a, const Int_128& b ) -> Truth;
+    inline constexpr auto operator<=( const Int_128& a, const Int_128& b ) -> Truth;
+    inline constexpr auto operator==( const Int_128& a, const Int_128& b ) -> Truth;
+    inline constexpr auto operator>=( const Int_128& a, const Int_128& b ) -> Truth;
+    inline constexpr auto operator>( const Int_128& a, const Int_128& b ) -> Truth;
+    inline constexpr auto operator!=( const Int_128& a, const Int_128& b ) -> Truth;
+
+    inline constexpr auto write_decimal_digits( const Int_128& v, char* const p_first ) -> char*;
+    inline auto operator<<( string& s, const Int_128& v ) -> string&;
+    inline auto str( const Int_128& v ) -> string;
+
+
+    //--------------------------------------------------------------------------------------------------
+
+    constexpr auto Int_128::is_in_64_bit_range() const
+        -> Truth
+    {
+        const Uint_128::Parts& parts = m_bits.representation();
+        return (parts.parts[1] == Unit( 0 - +msb_is_set_in( parts.parts[0] ) ));
+    }
+
+    inline constexpr auto Int_128::magnitude() const
+        -> Uint_128
+    { return (is_negative()? -m_bits : m_bits); }
+
+    struct Int_128::Divmod_result
+    {
+        Int_128     remainder;
+        Int_128     quotient;
+    };
+
+    inline constexpr void Int_128::operator*=( const Self& other )
+    {
+        *this = *this * other;
+    }
+
+    inline constexpr void Int_128::operator/=( const Self& other )
+    {
+        *this = divmod( *this, other ).quotient;
+    }
+
+    inline constexpr void Int_128::operator%=( const Self& other )
+    {
+        *this = divmod( *this, other ).remainder;
+    }
+
+    // Overflow iff the operands have the same sign and the result has the other sign.
+    inline constexpr auto Int_128::add( const Self& other )
+        -> Result_kind::Enum
+    {
+        using R = Result_kind;
+        Truth overflow = false;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            Native_int_128 sum = 0;
+            overflow = __builtin_add_overflow( as_native(), other.as_native(), &sum );
+            *this = from_native( sum );
+        #else
+            const Truth signs_are_equal = (is_negative() == other.is_negative());
+            m_bits += other.m_bits;
+            overflow = (signs_are_equal and is_negative() != other.is_negative());
+        #endif
+        return (overflow? R::wrapped : R::math_exact);
+    }
+
+    // Overflow iff the operands have different signs and the result has the subtrahend's sign.
+    inline constexpr auto Int_128::subtract( const Self& other )
+        -> Result_kind::Enum
+    {
+        using R = Result_kind;
+        Truth overflow = false;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            Native_int_128 difference = 0;
+            overflow = __builtin_sub_overflow( as_native(), other.as_native(), &difference );
+            *this = from_native( difference );
+        #else
+            const Truth signs_differ = (is_negative() != other.is_negative());
+            m_bits -= other.m_bits;
+            overflow = (signs_differ and is_negative() == other.is_negative());
+        #endif
+        return (overflow? R::wrapped : R::math_exact);
+    }
+
+    inline constexpr auto operator+( const Int_128& value )
+        -> Int_128
+    { return value; }
+
+    inline constexpr auto operator-( const Int_128& value )
+        -> Int_128
+    { return Int_128::from_bits( -value.bits() ); }
+
+    inline constexpr auto operator+( const Int_128& a, const Int_128& b )
+        -> Int_128
+    { return Int_128::from_bits( a.bits() + b.bits() ); }
+
+    inline constexpr auto operator-( const Int_128& a, const Int_128& b )
+        -> Int_128
+    { return Int_128::from_bits( a.bits() - b.bits() ); }
+
+    // The low 128 bits of a product are the same for signed and unsigned operands.
+    inline constexpr auto operator*( const Int_128& a, const Int_128& b )
+        -> Int_128
+    { return Int_128::from_bits( a.bits()*b.bits() ); }
+
+    // Truncating division, as with the built-in types: the quotient is rounded towards zero,
+    // and a non-zero remainder has the sign of the dividend. Division by 0 yields all 1-bits,
+    // i.e. -1, for both quotient and remainder. Dividing the most negative value by -1 wraps.
+    inline constexpr auto divmod( const Int_128& a, const Int_128& b )
+        -> Int_128::Divmod_result
+    {
+        if( b == 0 ) { return Int_128::Divmod_result{ -1, -1 }; }
+
+        const Uint_128::Divmod_result r = divmod( a.magnitude(), b.magnitude() );
+        const Uint_128 quotient_bits    = (a.is_negative() != b.is_negative()? -r.quotient : r.quotient);
+        const Uint_128 remainder_bits   = (a.is_negative()? -r.remainder : r.remainder);
+        return Int_128::Divmod_result{ Int_128::from_bits( remainder_bits ), Int_128::from_bits( quotient_bits ) };
+    }
+
+    inline constexpr auto operator/( const Int_128& a, const Int_128& b )
+        -> Int_128
+    { return divmod( a, b ).quotient; }
+
+    inline constexpr auto operator%( const Int_128& a, const Int_128& b )
+        -> Int_128
+    { return divmod( a, b ).remainder; }
+
+    inline constexpr auto compare( const Int_128& a, const Int_128& b )
+        -> int
+    {
+        #ifdef KS_HAS_NATIVE_UINT_128
+            const Native_int_128 native_a = a.as_native();
+            const Native_int_128 native_b = b.as_native();
+            return (native_a > native_b) - (native_a < native_b);
+        #else
+            const Uint_128::Parts& pa = a.bits().representation();
+            const Uint_128::Parts& pb = b.bits().representation();
+            if( const int r = compare( Int64( pa.parts[1] ), Int64( pb.parts[1] ) ) ) {
+                return r;
+            }
+            return compare( pa.parts[0], pb.parts[0] );
+        #endif
+    }
+
+    inline constexpr auto operator<( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (compare( a, b ) < 0); }
+
+    inline constexpr auto operator<=( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (compare( a, b ) <= 0); }
+
+    inline constexpr auto operator==( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (a.bits() == b.bits()); }
+
+    inline constexpr auto operator>=( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (compare( a, b ) >= 0); }
+
+    inline constexpr auto operator>( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (compare( a, b ) > 0); }
+
+    inline constexpr auto operator!=( const Int_128& a, const Int_128& b )
+        -> Truth
+    { return (a.bits() != b.bits()); }
+
+    // The buffer must have room for `Int_128::max_text_length` chars.
+    inline constexpr auto write_decimal_digits( const Int_128& v, char* const p_first )
+        -> char*
+    {
+        char* p = p_first;
+        if( v.is_negative() ) { *p++ = '-'; }
+        return write_decimal_digits( v.magnitude(), p );
+    }
+
+    inline auto operator<<( string& s, const Int_128& v )
+        -> string&
+    {
+        char chars[Int_128::max_text_length];
+        const char* const p_beyond = write_decimal_digits( v, chars );
+        return s.append( chars, p_beyond - chars );
+    }
+
+    inline auto str( const Int_128& v )
+        -> string
+    {
+        string result;
+        result << v;
+        return result;
+    }
+
+    // Like `parse_uint_128` but with an optional leading sign, `+` or `-`.
+    inline constexpr auto parse_int_128( const string_view& spec ) noexcept
+        -> Parsing_result_<Int_128>
+    {
+        using E = Parsing_error;
+        const Truth has_sign        = (spec.size() > 0 and (spec[0] == '-' or spec[0] == '+'));
+        const Truth is_negative     = (has_sign and spec[0] == '-');
+        const int   i_first         = (has_sign? 1 : 0);
+
+        const Parsing_result_<Uint_128> r = parse_uint_128( spec.substr( i_first ) );
+        if( not r.is_ok() ) { return {0, r.error, i_first + r.position}; }
+
+        const auto max_magnitude = Uint_128( tag::From_parts(), 0, Uint_128::Unit( 1 ) << 63 );  // 2^127
+        if( r.value > max_magnitude or (r.value == max_magnitude and not is_negative) ) {
+            return {0, E::range_exceeded, int( spec.size() )};
+        }
+        const auto value = Int_128::from_bits( r.value );
+        return {(is_negative? -value : value), E::none, int( spec.size() )};
+    }
+
+    // Like `parse_int_128`, but reports failure by throwing a `std::runtime_error`.
+    inline constexpr auto to_int_128( const string_view& spec )
+        -> Int_128
+    {
+        const Parsing_result_<Int_128> r = parse_int_128( spec );
+        if( not r.is_ok() ) {
+            impl::throw_parsing_exception( r.error, spec, r.position, "Int_128" );
+        }
+        return r.value;
+    }
+
+    // A negative literal like `-1_i128` is the negation of a literal.
+    inline constexpr auto operator""_i128( const C_str spec )
+        -> Int_128
+    { return to_int_128( string_view( spec ) ); }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Int_128,
+        d::parse_int_128,
+        d::to_int_128,
+        d::operator""_i128;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -27,7 +27,10 @@
 #include <kickstart/core/language/Truth.hpp>                // Truth
 #include <kickstart/core/language/type-aliases.hpp>         // C_str
 #include <kickstart/core/language/lx/bit-checking.hpp>
+#include <kickstart/core/large-integers/decimal-digits.hpp>     // write_decimal_digits
+#include <kickstart/core/large-integers/Divider_.hpp>
 #include <kickstart/core/large-integers/Uint_double_of_.hpp>
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // Native_uint_128, add_with_carry, ...
 #include <kickstart/core/stdlib-extensions/limits.hpp>      // bits_per_
 #include <kickstart/core/stdlib-extensions/strings.hpp>     // spaces
 
@@ -36,11 +39,12 @@
 
 #include <array>
 #include <bitset>
+#include <functional>       // std::hash
 #include <optional>
 #include <stdexcept>        // runtime_error
 #include <string>           // string
 #include <string_view>      // string_view
-#include <type_traits>      // is_integral_v
+#include <type_traits>      // enable_if_t, is_integral_v
 #include <utility>          // swap
 
 namespace kickstart::tag {
@@ -52,6 +56,7 @@ namespace kickstart::tag {
 namespace kickstart::large_integers::_definitions {
     using namespace kickstart::strings;
     using namespace kickstart::text_conversion;     // string <<
+    using kickstart::text_conversion::operator<<;   // Not hidden by the `Uint_128` overload.
     
     namespace kl = kickstart::language;
     namespace klx = kickstart::language::lx;
@@ -65,7 +70,7 @@ namespace kickstart::large_integers::_definitions {
             std::runtime_error,
             std::string,
             std::string_view,
-            std::is_integral_v,
+            std::enable_if_t, std::is_integral_v,
             std::swap;
 
     class Uint_128
@@ -74,6 +79,7 @@ namespace kickstart::large_integers::_definitions {
         using Unit      = uint64_t;
         using Parts     = Uint_double_of_<Unit>;
         static constexpr int n_bits = 2*bits_per_<Unit>;
+        static constexpr int max_decimal_digits = 39;
 
     private:
         using Self = Uint_128;
@@ -89,11 +95,10 @@ namespace kickstart::large_integers::_definitions {
         {}
 
         // Yields `value` modulo 2^128.
-        template< class Integer >
+        template< class Integer, class = enable_if_t<is_integral_v<Integer>> >
         constexpr Uint_128( const Integer value ):
             m_value{ Unit( value ), 0 }
         {
-            static_assert( is_integral_v<Integer> );
             if constexpr( sizeof( Integer ) > sizeof( Unit ) ) {
                 m_value.parts[1] = Unit( value >> bits_per_<Unit> );
             } else if( value < 0 ) {
@@ -108,7 +113,13 @@ namespace kickstart::large_integers::_definitions {
         constexpr Uint_128( const Self& ) = default;
         auto constexpr operator=( const Self& ) -> Self& = default;
 
+        #ifdef KS_HAS_NATIVE_UINT_128
+            static inline constexpr auto from_native( const Native_uint_128 value ) -> Self;
+            inline constexpr auto as_native() const -> Native_uint_128;
+        #endif
+
         inline constexpr auto representation() const -> const Parts&;
+        static inline auto from_bitset( const bitset<n_bits>& bits ) -> Self;
         inline auto to_bitset() const -> bitset<n_bits>;
         inline constexpr auto modulo_64_bits() const -> Unit;
         inline constexpr auto is_in_64_bit_range() const -> Truth;
@@ -119,10 +130,21 @@ namespace kickstart::large_integers::_definitions {
 
         inline constexpr void operator+=( const Self& other );
         inline constexpr void operator-=( const Self& other );
+        inline constexpr void operator*=( const Self& other );
+        inline constexpr void operator/=( const Self& other );
+        inline constexpr void operator%=( const Self& other );
 
         inline constexpr void shift_left();
         inline constexpr void shift_right();
 
+        // Shift counts of `n_bits` or more yield 0. Negative shift counts are not supported.
+        inline constexpr void operator<<=( const int n );
+        inline constexpr void operator>>=( const int n );
+
+        inline constexpr void operator&=( const Self& other );
+        inline constexpr void operator|=( const Self& other );
+        inline constexpr void operator^=( const Self& other );
+
         struct Divmod_result;
         inline constexpr auto divmod_by_64_bit( const Unit b ) const -> Divmod_result;
 
@@ -135,9 +157,7 @@ namespace kickstart::large_integers::_definitions {
 
         inline constexpr auto add( const Self& a ) -> Result_kind::Enum;
         inline constexpr auto subtract( const Self& other ) -> Result_kind::Enum;
-
-        //inline constexpr void operator*=( const Unit a );
-        //inline constexpr void operator/=( const Unit a );
+        inline constexpr auto multiply( const Self& other ) -> Result_kind::Enum;
     };
 
     inline constexpr auto operator+( const Uint_128& ) -> Uint_128;
@@ -147,9 +167,14 @@ namespace kickstart::large_integers::_definitions {
     inline constexpr auto operator-( const Uint_128& a, const Uint_128& b ) -> Uint_128;
 
     inline constexpr auto operator*( const Uint_128::Unit a, const Uint_128& b ) -> Uint_128;
+    inline constexpr auto operator*( const Uint_128& a, const Uint_128& b ) -> Uint_128;
     inline constexpr auto operator/( const Uint_128& a, const Uint_128::Unit b ) -> Uint_128;
     inline constexpr auto operator%( const Uint_128& a, const Uint_128::Unit b ) -> Uint_128;
 
+    inline constexpr auto divmod( const Uint_128& a, const Uint_128& b ) -> Uint_128::Divmod_result;
+    inline constexpr auto operator/( const Uint_128& a, const Uint_128& b ) -> Uint_128;
+    inline constexpr auto operator%( const Uint_128& a, const Uint_128& b ) -> Uint_128;
+
     inline constexpr auto compare( const Uint_128& a, const Uint_128& b ) -> int;
     inline constexpr auto operator<( const Uint_128& a, const Uint_128& b ) -> Truth;
     inline constexpr auto operator<=( const Uint_128& a, const Uint_128& b ) -> Truth;
@@ -158,26 +183,56 @@ namespace kickstart::large_integers::_definitions {
     inline constexpr auto operator>( const Uint_128& a, const Uint_128& b ) -> Truth;
     inline constexpr auto operator!=( const Uint_128& a, const Uint_128& b ) -> Truth;
 
+    inline constexpr auto operator<<( const Uint_128& a, const int n ) -> Uint_128;
+    inline constexpr auto operator>>( const Uint_128& a, const int n ) -> Uint_128;
+    inline constexpr auto operator&( const Uint_128& a, const Uint_128& b ) -> Uint_128;
+    inline constexpr auto operator|( const Uint_128& a, const Uint_128& b ) -> Uint_128;
+    inline constexpr auto operator^( const Uint_128& a, const Uint_128& b ) -> Uint_128;
+
+    // Named as the C++20 `<bit>` functions.
+    inline constexpr auto countl_zero( const Uint_128& v ) -> int;
+    inline constexpr auto countr_zero( const Uint_128& v ) -> int;
+    inline constexpr auto popcount( const Uint_128& v ) -> int;
+    inline constexpr auto bit_width( const Uint_128& v ) -> int;
+
+    inline constexpr auto add_with_carry( const Uint_128& a, const Uint_128& b, Truth& carry ) -> Uint_128;
+    inline constexpr auto subtract_with_borrow( const Uint_128& a, const Uint_128& b, Truth& borrow ) -> Uint_128;
+
+    inline constexpr auto write_decimal_digits( const Uint_128& v, char* const p_first ) -> char*;
+    inline auto operator<<( string& s, const Uint_128& v ) -> string&;
     inline auto str( const Uint_128& v ) -> string;
 
 
     //--------------------------------------------------------------------------------------------------
 
+    #ifdef KS_HAS_NATIVE_UINT_128
+        inline constexpr auto Uint_128::from_native( const Native_uint_128 value )
+            -> Self
+        { return Uint_128( tag::From_parts(), Unit( value ), Unit( value >> bits_per_<Unit> ) ); }
+
+        inline constexpr auto Uint_128::as_native() const
+            -> Native_uint_128
+        { return Native_uint_128( m_value.parts[1] ) << bits_per_<Unit> | m_value.parts[0]; }
+    #endif
+
     inline constexpr auto Uint_128::representation() const
         -> const Parts&
     { return m_value; }
 
-    inline auto Uint_128::to_bitset() const
-        -> bitset<n_bits>
+    // The conversions are word-level: `bitset` shifts and masks operate on whole words.
+    inline auto Uint_128::from_bitset( const bitset<n_bits>& bits )
+        -> Self
     {
-        auto bits = bitset<n_bits>( m_value.parts[0] );
-        for( int i = 0; i < bits_per_<Unit>; ++i ) {
-            const int bit = (m_value.parts[1] >> i) & 1;
-            bits.set( i + bits_per_<Unit>, !!bit );
-        }
-        return bits;
+        const auto low_mask = bitset<n_bits>( Unit( -1 ) );
+        return Uint_128( tag::From_parts(),
+            (bits & low_mask).to_ullong(), (bits >> bits_per_<Unit>).to_ullong()
+            );
     }
 
+    inline auto Uint_128::to_bitset() const
+        -> bitset<n_bits>
+    { return bitset<n_bits>( m_value.parts[1] ) << bits_per_<Unit> | bitset<n_bits>( m_value.parts[0] ); }
+
     inline constexpr auto Uint_128::modulo_64_bits() const
         -> Unit
     { return m_value.parts[0]; }
@@ -208,14 +263,37 @@ namespace kickstart::large_integers::_definitions {
 
     inline constexpr void Uint_128::operator+=( const Self& other )
     {
-        m_value.parts[0] += other.m_value.parts[0];
-        const Truth carry = (m_value.parts[0] < other.m_value.parts[0]);
-        m_value.parts[1] += Unit( other.m_value.parts[1] + +carry );
+        #ifdef KS_HAS_NATIVE_UINT_128
+            *this = from_native( as_native() + other.as_native() );
+        #else
+            Truth carry = false;
+            m_value.parts[0] = add_with_carry( m_value.parts[0], other.m_value.parts[0], carry );
+            m_value.parts[1] = add_with_carry( m_value.parts[1], other.m_value.parts[1], carry );
+        #endif
     }
 
     inline constexpr void Uint_128::operator-=( const Self& other )
     {
-        *this += -other;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            *this = from_native( as_native() - other.as_native() );
+        #else
+            Truth borrow = false;
+            m_value.parts[0] = subtract_with_borrow( m_value.parts[0], other.m_value.parts[0], borrow );
+            m_value.parts[1] = subtract_with_borrow( m_value.parts[1], other.m_value.parts[1], borrow );
+        #endif
+    }
+
+    // The product modulo 2^128. The high half of a1·b1 and of the cross products are beyond.
+    inline constexpr void Uint_128::operator*=( const Self& other )
+    {
+        #ifdef KS_HAS_NATIVE_UINT_128
+            *this = from_native( as_native()*other.as_native() );
+        #else
+            const Parts& a = m_value;
+            const Parts& b = other.m_value;
+            const Parts low = Parts::product_of( a.parts[0], b.parts[0] );
+            m_value = { low.parts[0], low.parts[1] + a.parts[0]*b.parts[1] + a.parts[1]*b.parts[0] };
+        #endif
     }
 
     inline constexpr void Uint_128::shift_left()
@@ -234,12 +312,67 @@ namespace kickstart::large_integers::_definitions {
         m_value.parts[0] |= (Unit( +carry ) << (bits_per_<Unit> - 1));
     }
 
+    inline constexpr void Uint_128::operator<<=( const int n )
+    {
+        assert( n >= 0 );
+        #ifdef KS_HAS_NATIVE_UINT_128
+            *this = (n < n_bits? from_native( as_native() << n ) : Uint_128());
+        #else
+            constexpr int w = bits_per_<Unit>;
+            const Unit low = m_value.parts[0];
+            const Unit high = m_value.parts[1];
+            m_value = (0?Parts()
+                : n == 0?       m_value
+                : n < w?        Parts{ low << n, high << n | low >> (w - n) }
+                : n < n_bits?   Parts{ 0, low << (n - w) }
+                :               Parts{ 0, 0 }
+                );
+        #endif
+    }
+
+    inline constexpr void Uint_128::operator>>=( const int n )
+    {
+        assert( n >= 0 );
+        #ifdef KS_HAS_NATIVE_UINT_128
+            *this = (n < n_bits? from_native( as_native() >> n ) : Uint_128());
+        #else
+            constexpr int w = bits_per_<Unit>;
+            const Unit low = m_value.parts[0];
+            const Unit high = m_value.parts[1];
+            m_value = (0?Parts()
+                : n == 0?       m_value
+                : n < w?        Parts{ low >> n | high << (w - n), high >> n }
+                : n < n_bits?   Parts{ high >> (n - w), 0 }
+                :               Parts{ 0, 0 }
+                );
+        #endif
+    }
+
+    inline constexpr void Uint_128::operator&=( const Self& other )
+    {
+        m_value.parts[0] &= other.m_value.parts[0];
+        m_value.parts[1] &= other.m_value.parts[1];
+    }
+
+    inline constexpr void Uint_128::operator|=( const Self& other )
+    {
+        m_value.parts[0] |= other.m_value.parts[0];
+        m_value.parts[1] |= other.m_value.parts[1];
+    }
+
+    inline constexpr void Uint_128::operator^=( const Self& other )
+    {
+        m_value.parts[0] ^= other.m_value.parts[0];
+        m_value.parts[1] ^= other.m_value.parts[1];
+    }
+
     struct Uint_128::Divmod_result
     {
         Uint_128   remainder;
         Uint_128   quotient;
     };
 
+    // Division by 0 yields all 1-bits for both quotient and remainder.
     inline constexpr auto Uint_128::divmod_by_64_bit( const Uint_128::Unit b ) const
         -> Divmod_result
     {
@@ -251,45 +384,32 @@ namespace kickstart::large_integers::_definitions {
             }
         #endif
 
-        Unit divisor = b;
-        int n_shifts = 0;
-        while( not msb_is_set_in( divisor ) ) {
-            divisor <<= 1;
-            ++n_shifts;
-        }
-
-        const int n_q_digits = 1 + n_shifts + bits_per_<Unit>;
-        Divmod_result result = {*this, 0};
-        Truth carry = false;
-        for( int i = 0;; ) {
-            if( carry or divisor <= result.remainder.m_value.parts[1] ) {
-                result.remainder.m_value.parts[1] -= divisor;
-                result.quotient.m_value.parts[0] |= 1;
-            }
+        // Two steps of schoolbook division with 64-bit digits. The first step's remainder
+        // is less than `b`, so the second step's quotient digit fits in 64 bits.
+        const Unit  q_high      = m_value.parts[1] / b;
+        Unit        remainder   = m_value.parts[1] % b;
+        const Unit  q_low       = divide_double_unit( remainder, m_value.parts[0], b, remainder );
+        return Divmod_result{ remainder, Uint_128( tag::From_parts(), q_low, q_high ) };
+    }
 
-            ++i;
-            if( i == n_q_digits ) {
-                break;
-            }
+    inline constexpr void Uint_128::operator/=( const Self& other )
+    {
+        *this = divmod( *this, other ).quotient;
+    }
 
-            result.quotient.shift_left();
-            carry = msb_is_set_in( result.remainder.representation().parts[1] );
-            result.remainder.shift_left();
-        }
-        assert( result.remainder.m_value.parts[0] == 0 );
-        swap( result.remainder.m_value.parts[0], result.remainder.m_value.parts[1] );
-        result.remainder.m_value.parts[0] >>= n_shifts;
-        return result;
+    inline constexpr void Uint_128::operator%=( const Self& other )
+    {
+        *this = divmod( *this, other ).remainder;
     }
 
     inline constexpr auto Uint_128::add_64_bit( const Unit a )
         -> Result_kind::Enum
     {
         using R = Result_kind;
-        m_value.parts[0] += a;
-        const Truth carry = (m_value.parts[0] < a);
-        m_value.parts[1] += +carry;
-        return (m_value.parts[1] == 0 and m_value.parts[0] < a? R::wrapped : R::math_exact);
+        Truth carry = false;
+        m_value.parts[0] = add_with_carry( m_value.parts[0], a, carry );
+        m_value.parts[1] = add_with_carry( m_value.parts[1], Unit( 0 ), carry );
+        return (carry? R::wrapped : R::math_exact);
     }
 
     inline constexpr auto Uint_128::subtract_64_bit( const Unit a )
@@ -301,11 +421,10 @@ namespace kickstart::large_integers::_definitions {
     {
         const Parts lo  = Parts::product_of( a, m_value.parts[0] );
         const Parts hi  = Parts::product_of( a, m_value.parts[1] );
-        const Truth intermediate_overflow = (hi.parts[1] != 0);
-        m_value = { lo.parts[0], lo.parts[1] + hi.parts[0] };
-        const Truth final_overflow = (m_value.parts[1] < lo.parts[1]);
+        Truth carry = false;
+        m_value = { lo.parts[0], add_with_carry( lo.parts[1], hi.parts[0], carry ) };
         using R = Result_kind;
-        return (intermediate_overflow or final_overflow? R::wrapped : R::math_exact);
+        return (carry or hi.parts[1] != 0? R::wrapped : R::math_exact);
     }
 
     inline constexpr auto Uint_128::divide_by_64_bit( const Unit a )
@@ -326,17 +445,60 @@ namespace kickstart::large_integers::_definitions {
         -> Result_kind::Enum
     {
         using R = Result_kind;
-        operator+=( other );
-        return (*this < other? R::wrapped : R::math_exact);
+        Truth carry = false;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            Native_uint_128 sum = 0;
+            carry = __builtin_add_overflow( as_native(), other.as_native(), &sum );
+            *this = from_native( sum );
+        #else
+            m_value.parts[0] = add_with_carry( m_value.parts[0], other.m_value.parts[0], carry );
+            m_value.parts[1] = add_with_carry( m_value.parts[1], other.m_value.parts[1], carry );
+        #endif
+        return (carry? R::wrapped : R::math_exact);
     }
 
     inline constexpr auto Uint_128::subtract( const Self& other )
         -> Result_kind::Enum
     {
         using R = Result_kind;
-        const Truth wrapping = (other > *this);
-        operator-=( other );
-        return (wrapping? R::wrapped : R::math_exact);
+        Truth borrow = false;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            Native_uint_128 difference = 0;
+            borrow = __builtin_sub_overflow( as_native(), other.as_native(), &difference );
+            *this = from_native( difference );
+        #else
+            m_value.parts[0] = subtract_with_borrow( m_value.parts[0], other.m_value.parts[0], borrow );
+            m_value.parts[1] = subtract_with_borrow( m_value.parts[1], other.m_value.parts[1], borrow );
+        #endif
+        return (borrow? R::wrapped : R::math_exact);
+    }
+
+    inline constexpr auto Uint_128::multiply( const Self& other )
+        -> Result_kind::Enum
+    {
+        using R = Result_kind;
+        Truth overflow = false;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            Native_uint_128 product = 0;
+            overflow = __builtin_mul_overflow( as_native(), other.as_native(), &product );
+            *this = from_native( product );
+        #else
+            // The math product is a0·b0 + (a0·b1 + a1·b0)·2^64 + a1·b1·2^128.
+            const Parts& a = m_value;
+            const Parts& b = other.m_value;
+            const Parts low     = Parts::product_of( a.parts[0], b.parts[0] );
+            const Parts cross_1 = Parts::product_of( a.parts[0], b.parts[1] );
+            const Parts cross_2 = Parts::product_of( a.parts[1], b.parts[0] );
+            Truth carry_1 = false;      Truth carry_2 = false;
+            Unit high = add_with_carry( low.parts[1], cross_1.parts[0], carry_1 );
+            high = add_with_carry( high, cross_2.parts[0], carry_2 );
+            overflow = (carry_1 or carry_2
+                or (a.parts[1] != 0 and b.parts[1] != 0)
+                or cross_1.parts[1] != 0 or cross_2.parts[1] != 0
+                );
+            m_value = { low.parts[0], high };
+        #endif
+        return (overflow? R::wrapped : R::math_exact);
     }
 
     inline constexpr auto operator+( const Uint_128& value )
@@ -371,6 +533,14 @@ namespace kickstart::large_integers::_definitions {
         return result;
     }
 
+    inline constexpr auto operator*( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        Uint_128 result = a;
+        result *= b;
+        return result;
+    }
+
     inline constexpr auto operator/( const Uint_128& a, const Uint_128::Unit b )
         -> Uint_128
     { return a.divmod_by_64_bit( b ).quotient; }
@@ -379,9 +549,64 @@ namespace kickstart::large_integers::_definitions {
         -> Uint_128
     { return a.divmod_by_64_bit( b ).remainder; }
 
+    // Division by 0 yields all 1-bits for both quotient and remainder.
+    inline constexpr auto divmod( const Uint_128& a, const Uint_128& b )
+        -> Uint_128::Divmod_result
+    {
+        using Unit = Uint_128::Unit;
+        const Unit a_high   = a.representation().parts[1];
+        const Unit b_high   = b.representation().parts[1];
+        const Unit b_low    = b.representation().parts[0];
+
+        if( b_high == 0 ) {
+            return a.divmod_by_64_bit( b_low );
+        }
+
+        #ifndef KS_TEST_DIVISION_PLEASE
+            if( a < b ) { return Uint_128::Divmod_result{ a, 0 }; }
+        #endif
+
+        // The divisor has 65 or more significant bits, so the quotient fits in 64 bits. An
+        // estimate from the divisor's 64 most significant bits is exact or 1 too large.
+        // This is algorithm D specialized for a 1-digit quotient, as in “Hacker's Delight”.
+        const int   n_shifts    = n_leading_zeros_in( b_high );
+        const Unit  b_top       = (n_shifts == 0? b_high
+            : b_high << n_shifts | b_low >> (bits_per_<Unit> - n_shifts));
+        const Unit  a_half_high = a_high >> 1;
+        const Unit  a_half_low  = a_high << (bits_per_<Unit> - 1) | a.representation().parts[0] >> 1;
+
+        Unit ignored_remainder = 0;
+        const Unit q_estimate = divide_double_unit( a_half_high, a_half_low, b_top, ignored_remainder );
+        Unit q = (q_estimate >> (bits_per_<Unit> - 1 - n_shifts));
+        if( q != 0 ) { --q; }       // Now q is exact or 1 too small.
+
+        Uint_128 remainder = a - q*b;
+        if( remainder >= b ) {
+            ++q;
+            remainder -= b;
+        }
+        return Uint_128::Divmod_result{ remainder, q };
+    }
+
+    inline constexpr auto operator/( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    { return divmod( a, b ).quotient; }
+
+    inline constexpr auto operator%( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    { return divmod( a, b ).remainder; }
+
     inline constexpr auto compare( const Uint_128& a, const Uint_128& b )
         -> int
-    { return compare( a.representation(), b.representation() ); }
+    {
+        #ifdef KS_HAS_NATIVE_UINT_128
+            const Native_uint_128 native_a = a.as_native();
+            const Native_uint_128 native_b = b.as_native();
+            return (native_a > native_b) - (native_a < native_b);
+        #else
+            return compare( a.representation(), b.representation() );
+        #endif
+    }
 
     inline constexpr auto operator<( const Uint_128& a, const Uint_128& b )
         -> Truth
@@ -407,49 +632,372 @@ namespace kickstart::large_integers::_definitions {
         -> Truth
     { return (compare( a, b ) != 0); }
 
-    inline auto str( const Uint_128& v )
-        -> string
+    inline constexpr auto operator<<( const Uint_128& a, const int n )
+        -> Uint_128
+    {
+        Uint_128 result = a;
+        result <<= n;
+        return result;
+    }
+
+    inline constexpr auto operator>>( const Uint_128& a, const int n )
+        -> Uint_128
     {
-        if( v == 0 ) { return "0"; }
+        Uint_128 result = a;
+        result >>= n;
+        return result;
+    }
 
-        string digits;
-        Uint_128 a = v;
-        while( a != 0 ) {
-            const auto r = a.divmod_by_64_bit( 10 );
-            digits += "0123456789"[r.remainder.modulo_64_bits()];
-            a = r.quotient;
+    inline constexpr auto operator&( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        Uint_128 result = a;
+        result &= b;
+        return result;
+    }
+
+    inline constexpr auto operator|( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        Uint_128 result = a;
+        result |= b;
+        return result;
+    }
+
+    inline constexpr auto operator^( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        Uint_128 result = a;
+        result ^= b;
+        return result;
+    }
+
+    inline constexpr auto countl_zero( const Uint_128& v )
+        -> int
+    {
+        const Uint_128::Parts& parts = v.representation();
+        return (parts.parts[1] != 0
+            ? n_leading_zeros_in( parts.parts[1] )
+            : bits_per_<Uint_128::Unit> + n_leading_zeros_in( parts.parts[0] )
+            );
+    }
+
+    inline constexpr auto countr_zero( const Uint_128& v )
+        -> int
+    {
+        const Uint_128::Parts& parts = v.representation();
+        return (parts.parts[0] != 0
+            ? n_trailing_zeros_in( parts.parts[0] )
+            : bits_per_<Uint_128::Unit> + n_trailing_zeros_in( parts.parts[1] )
+            );
+    }
+
+    inline constexpr auto popcount( const Uint_128& v )
+        -> int
+    {
+        const Uint_128::Parts& parts = v.representation();
+        return n_ones_in( parts.parts[0] ) + n_ones_in( parts.parts[1] );
+    }
+
+    inline constexpr auto bit_width( const Uint_128& v )
+        -> int
+    { return Uint_128::n_bits - countl_zero( v ); }
+
+    // The unit arithmetic functions for `Uint_128` as the unit of a wider integer, `Fixed_uint_`.
+    inline constexpr auto add_with_carry( const Uint_128& a, const Uint_128& b, Truth& carry )
+        -> Uint_128
+    {
+        const Uint_128::Parts& parts_a = a.representation();
+        const Uint_128::Parts& parts_b = b.representation();
+        const Uint_128::Unit low    = add_with_carry( parts_a.parts[0], parts_b.parts[0], carry );
+        const Uint_128::Unit high   = add_with_carry( parts_a.parts[1], parts_b.parts[1], carry );
+        return Uint_128( tag::From_parts(), low, high );
+    }
+
+    inline constexpr auto subtract_with_borrow( const Uint_128& a, const Uint_128& b, Truth& borrow )
+        -> Uint_128
+    {
+        const Uint_128::Parts& parts_a = a.representation();
+        const Uint_128::Parts& parts_b = b.representation();
+        const Uint_128::Unit low    = subtract_with_borrow( parts_a.parts[0], parts_b.parts[0], borrow );
+        const Uint_128::Unit high   = subtract_with_borrow( parts_a.parts[1], parts_b.parts[1], borrow );
+        return Uint_128( tag::From_parts(), low, high );
+    }
+
+    // Division of a `Uint_128` by an invariant `Uint_128`. A divisor that fits in 64 bits is
+    // handled with two 64-bit steps as in `divmod_by_64_bit`, and a larger divisor with the
+    // 1-digit quotient estimate as in `divmod`, where in both cases the 64-bit divisions are
+    // done by a `Divider_<uint64_t>`.
+    template<>
+    class Divider_<Uint_128>
+    {
+    public:
+        using Unit              = Uint_128::Unit;
+        using Divmod_result     = Uint_128::Divmod_result;
+
+    private:
+        Uint_128            m_divisor;
+        int                 m_n_shifts;         // Normalizing shifts of a divisor ≥ 2^64, else 0.
+        Divider_<Unit>      m_unit_divider;     // By the divisor if it fits, else by its top 64 bits.
+
+        static constexpr auto top_unit_of( const Uint_128& v, const int n_shifts )
+            -> Unit
+        {
+            const Uint_128::Parts& parts = v.representation();
+            return (0?0
+                : parts.parts[1] == 0?  parts.parts[0]
+                : n_shifts == 0?        parts.parts[1]
+                :                       parts.parts[1] << n_shifts | parts.parts[0] >> (bits_per_<Unit> - n_shifts)
+                );
+        }
+
+    public:
+        constexpr explicit Divider_( const Uint_128& divisor ):
+            m_divisor( divisor ),
+            m_n_shifts( n_leading_zeros_in( divisor.representation().parts[1] ) % bits_per_<Unit> ),
+            m_unit_divider( top_unit_of( divisor, m_n_shifts ) )
+        {}
+
+        constexpr auto divisor() const -> const Uint_128& { return m_divisor; }
+
+        constexpr auto divmod( const Uint_128& a ) const
+            -> Divmod_result
+        {
+            const Unit a_high   = a.representation().parts[1];
+            const Unit a_low    = a.representation().parts[0];
+
+            if( m_divisor.is_in_64_bit_range() ) {
+                const Divider_<Unit>::Divmod_result high_split = m_unit_divider.divmod( a_high );
+                Unit remainder = 0;
+                const Unit q_low = m_unit_divider.divide_double_unit( high_split.remainder, a_low, remainder );
+                return Divmod_result{ remainder, Uint_128( tag::From_parts(), q_low, high_split.quotient ) };
+            }
+
+            if( a < m_divisor ) { return Divmod_result{ a, 0 }; }
+
+            const Unit  a_half_high = a_high >> 1;
+            const Unit  a_half_low  = a_high << (bits_per_<Unit> - 1) | a_low >> 1;
+
+            Unit ignored_remainder = 0;
+            const Unit q_estimate = m_unit_divider.divide_double_unit( a_half_high, a_half_low, ignored_remainder );
+            Unit q = (q_estimate >> (bits_per_<Unit> - 1 - m_n_shifts));
+            if( q != 0 ) { --q; }       // Now q is exact or 1 too small.
+
+            Uint_128 remainder = a - q*m_divisor;
+            if( remainder >= m_divisor ) {
+                ++q;
+                remainder -= m_divisor;
+            }
+            return Divmod_result{ remainder, q };
+        }
+
+        constexpr auto quotient_of( const Uint_128& a ) const -> Uint_128 { return divmod( a ).quotient; }
+
+        friend constexpr auto operator/( const Uint_128& a, const Divider_& divider )
+            -> Uint_128
+        { return divider.divmod( a ).quotient; }
+
+        friend constexpr auto operator%( const Uint_128& a, const Divider_& divider )
+            -> Uint_128
+        { return divider.divmod( a ).remainder; }
+    };
+
+    namespace impl {
+        inline constexpr auto by_pow10_19 = Divider_<Uint_128>( pow10_19 );
+    }  // namespace impl
+
+    // Writes the shortest decimal representation of `v` starting at `p_first`, and returns a
+    // pointer to beyond the last digit. The buffer must have room for
+    // `Uint_128::max_decimal_digits` chars. The value is split in up to three chunks of at
+    // most 19 digits, where each chunk is converted with 64-bit arithmetic. The splitting
+    // divisions by 10^19 are multiplications via a precomputed `Divider_`.
+    inline constexpr auto write_decimal_digits( const Uint_128& v, char* const p_first )
+        -> char*
+    {
+        if( v.is_in_64_bit_range() ) {
+            return write_decimal_digits( v.modulo_64_bits(), p_first );
         }
-        reverse( begin( digits ), end( digits ) );
-        return digits;
+
+        const Uint_128::Divmod_result low_split = impl::by_pow10_19.divmod( v );
+        const Uint_128& upper = low_split.quotient;
+        char* p_beyond = p_first;
+        if( upper.is_in_64_bit_range() ) {
+            p_beyond = write_decimal_digits( upper.modulo_64_bits(), p_beyond );
+        } else {
+            const Uint_128::Divmod_result high_split = impl::by_pow10_19.divmod( upper );
+            p_beyond = write_decimal_digits( high_split.quotient.modulo_64_bits(), p_beyond );
+            write_decimal_digits( high_split.remainder.modulo_64_bits(), 19, p_beyond );
+            p_beyond += 19;
+        }
+        write_decimal_digits( low_split.remainder.modulo_64_bits(), 19, p_beyond );
+        return p_beyond + 19;
+    }
+
+    // Appends the decimal digits directly, without going via a temporary string.
+    inline auto operator<<( string& s, const Uint_128& v )
+        -> string&
+    {
+        char digits[Uint_128::max_decimal_digits];
+        const char* const p_beyond = write_decimal_digits( v, digits );
+        return s.append( digits, p_beyond - digits );
+    }
+
+    inline auto str( const Uint_128& v )
+        -> string
+    {
+        string result;
+        result << v;
+        return result;
     }
 
     const char  apostrophe  = '\'';
 
-    inline constexpr auto to_uint_128( const string_view& spec )
-        -> Uint_128
+    struct Parsing_error{ enum Enum{ none, no_digits, invalid_character, misplaced_separator, range_exceeded }; };
+
+    template< class Value >
+    struct Parsing_result_
     {
-        const auto ensure_is_valid = []( const char ch, const int index ) constexpr
+        Value                   value;
+        Parsing_error::Enum     error;
+        int                     position;   // Index of the offending char, or where the range was exceeded.
+
+        constexpr auto is_ok() const -> Truth { return (error == Parsing_error::none); }
+    };
+
+    namespace impl {
+        constexpr inline auto digit_value( const char ch, const int radix )
+            -> int
         {
-            const Truth is_valid = (('0' <= ch and ch <= '9') or (index > 0 and ch == apostrophe));
-            if( not is_valid ) {
-                throw runtime_error( "Invalid character ‘"s << ch << "’ in Uint_128 value spec." );
+            const int value = (0?0
+                : '0' <= ch and ch <= '9'?  ch - '0'
+                : 'a' <= ch and ch <= 'f'?  10 + (ch - 'a')
+                : 'A' <= ch and ch <= 'F'?  10 + (ch - 'A')
+                :                           radix
+                );
+            return (value < radix? value : -1);
+        }
+
+        // Appends the `n_bits` (1 through 64) least significant bits of `chunk` to `value`.
+        constexpr inline auto shift_in( const Uint_128::Unit chunk, const int n_bits, Uint_128& value )
+            -> Truth
+        {
+            using Unit = Uint_128::Unit;
+            const Unit low      = value.representation().parts[0];
+            const Unit high     = value.representation().parts[1];
+            if( n_bits == bits_per_<Unit> ) {
+                value = Uint_128( tag::From_parts(), chunk, low );
+                return (high == 0);
             }
-        };
+            value = Uint_128( tag::From_parts(),
+                low << n_bits | chunk, high << n_bits | low >> (bits_per_<Unit> - n_bits)
+                );
+            return (high >> (bits_per_<Unit> - n_bits) == 0);
+        }
 
+        inline void throw_parsing_exception(
+            const Parsing_error::Enum   error,
+            const string_view&          spec,
+            const int                   position,
+            const C_str                 type_name
+            )
+        {
+            using E = Parsing_error;
+            switch( error ) {
+                case E::none:                   return;
+                case E::no_digits:
+                    throw runtime_error( ""s << "No digits in " << type_name << " value spec." );
+                case E::invalid_character:
+                    throw runtime_error( ""s << "Invalid character ‘" << spec[position] << "’ in "
+                        << type_name << " value spec." );
+                case E::misplaced_separator:
+                    throw runtime_error( ""s << "Misplaced digit separator in " << type_name << " value spec." );
+                case E::range_exceeded:
+                    throw runtime_error( ""s << type_name << " value range exceeded for value spec." );
+            }
+        }
+    }  // namespace impl
+
+    // Parses a value specified in decimal, or in hexadecimal with prefix `0x` or binary with
+    // prefix `0b`, with optional apostrophes between digits as in C++ literals. Up to 19
+    // decimal digits are accumulated in 64 bits per 128-bit multiply-add, and runs of
+    // decimal digits are validated and converted 8 at a time with SWAR arithmetic.
+    inline constexpr auto parse_uint_128( const string_view& spec ) noexcept
+        -> Parsing_result_<Uint_128>
+    {
+        using E = Parsing_error;
         using R = Uint_128::Result_kind;
+        using Unit = Uint_128::Unit;
+
+        const char* const   chars   = spec.data();
+        const int           n       = int( spec.size() );
+
+        int radix = 10;
+        int i_first = 0;
+        if( n >= 2 and chars[0] == '0' ) {
+            const char ch = chars[1];
+            if( ch == 'x' or ch == 'X' ) {
+                radix = 16;  i_first = 2;
+            } else if( ch == 'b' or ch == 'B' ) {
+                radix = 2;  i_first = 2;
+            }
+        }
+        if( i_first == n ) { return {0, E::no_digits, n}; }
+
+        const int bits_per_digit    = (radix == 16? 4 : 1);
+        const int max_chunk_digits  = (radix == 10? 19 : bits_per_<Unit>/bits_per_digit);
+
         Uint_128 result = 0;
-        for( int i = 0; spec[i] != '\0'; ++i ) {
-            const char ch = spec[i];
-            ensure_is_valid( ch, i );
-            if( ch != apostrophe ) {
-                const R::Enum r1 = result.multiply_by_64_bit( 10 );
-                const R::Enum r2 = result.add_64_bit( ch - '0' );
-                if( r1 == R::wrapped or r2 == R::wrapped ) {
-                    throw runtime_error( "Uint_128 value range exceeded for value spec."s );
+        for( int i = i_first; i < n; ) {
+            Unit chunk = 0;
+            int n_chunk_digits = 0;
+            while( i < n and n_chunk_digits < max_chunk_digits ) {
+                if( radix == 10 and n - i >= 8 and n_chunk_digits <= max_chunk_digits - 8 ) {
+                    const uint64_t eight_chars = swar::load_8_chars( chars + i );
+                    if( swar::are_8_decimal_digits( eight_chars ) ) {
+                        chunk = chunk*pow10_table[8] + swar::value_of_8_decimal_digits( eight_chars );
+                        n_chunk_digits += 8;  i += 8;
+                        continue;
+                    }
+                }
+
+                const char ch = chars[i];
+                if( const int digit = impl::digit_value( ch, radix ); digit >= 0 ) {
+                    chunk = chunk*radix + digit;
+                    ++n_chunk_digits;
+                } else if( ch == apostrophe ) {
+                    const Truth is_between_digits = (i > i_first and i + 1 < n
+                        and impl::digit_value( chars[i - 1], radix ) >= 0
+                        and impl::digit_value( chars[i + 1], radix ) >= 0
+                        );
+                    if( not is_between_digits ) { return {0, E::misplaced_separator, i}; }
+                } else {
+                    return {0, E::invalid_character, i};
+                }
+                ++i;
+            }
+
+            if( radix == 10 ) {
+                const R::Enum r1 = result.multiply_by_64_bit( pow10_table[n_chunk_digits] );
+                const R::Enum r2 = result.add_64_bit( chunk );
+                if( r1 == R::wrapped or r2 == R::wrapped ) { return {0, E::range_exceeded, i}; }
+            } else {
+                if( not impl::shift_in( chunk, n_chunk_digits*bits_per_digit, result ) ) {
+                    return {0, E::range_exceeded, i};
                 }
             }
         }
-        return result;
+        return {result, E::none, n};
+    }
+
+    // Like `parse_uint_128`, but reports failure by throwing a `std::runtime_error`.
+    inline constexpr auto to_uint_128( const string_view& spec )
+        -> Uint_128
+    {
+        const Parsing_result_<Uint_128> r = parse_uint_128( spec );
+        if( not r.is_ok() ) {
+            impl::throw_parsing_exception( r.error, spec, r.position, "Uint_128" );
+        }
+        return r.value;
     }
 
     inline constexpr auto operator""_u128( const C_str spec )
@@ -457,11 +1005,45 @@ namespace kickstart::large_integers::_definitions {
     { return to_uint_128( string_view( spec ) ); }
 
 
+    namespace impl {
+        // The splitmix64 finalizer: xorshifts and multiplications by odd constants, which is a
+        // bijection that spreads each input bit over all output bits.
+        constexpr inline auto mixed( const Uint_128::Unit x )
+            -> Uint_128::Unit
+        {
+            using Unit = Uint_128::Unit;
+            Unit result = x;
+            result = (result ^ (result >> 30))*Unit( 0xBF58'476D'1CE4'E5B9 );
+            result = (result ^ (result >> 27))*Unit( 0x94D0'49BB'1331'11EB );
+            return result ^ (result >> 31);
+        }
+    }  // namespace impl
+
+    // A 64-bit hash for hashed containers. Values that differ only in the high word, or only in
+    // the low word, as with e.g. sequential IDs, get unrelated hash values.
+    constexpr inline auto hash_of( const Uint_128& v )
+        -> Uint_128::Unit
+    { return impl::mixed( v.representation().parts[0] ^ impl::mixed( v.representation().parts[1] ) ); }
+
+
     //----------------------------------------------------------- @exported:
     namespace d = _definitions;
     namespace exported_names { using
         d::Uint_128,
+        d::Parsing_error, d::Parsing_result_,
+        d::parse_uint_128,
         d::to_uint_128,
-        d::operator""_u128;
+        d::operator""_u128,
+        d::hash_of;
     }  // namespace exported_names
 }  // namespace kickstart::large_integers::_definitions
+
+namespace std {
+    template<>
+    struct hash<kickstart::large_integers::_definitions::Uint_128>
+    {
+        auto operator()( const kickstart::large_integers::_definitions::Uint_128& v ) const noexcept
+            -> size_t
+        { return size_t( kickstart::large_integers::_definitions::hash_of( v ) ); }
+    };
+}  // namespace std
@@ -25,6 +25,7 @@
 #include <kickstart/core/language/lx/bits_per_.hpp>             // lx::bits_per_
 #include <kickstart/core/language/Truth.hpp>                    // Truth
 #include <kickstart/core/language/type-aliases.hpp>             // Type_, Uint_
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // Native_uint_128
 #include <kickstart/core/stdlib-extensions/math/general-number-operations.h>    // compare
 
 namespace kickstart::large_integers::_definitions {
@@ -35,12 +36,14 @@ namespace kickstart::large_integers::_definitions {
             kl::Type_,
             kl::Uint_;
     using   kickstart::math::compare;
-    using   std::is_unsigned_v;
+    using   std::is_class_v, std::is_unsigned_v;
 
+    // `Uint_param` is a built-in unsigned type, or a class such as `Uint_128` that provides
+    // `compare`. `product_of` is only available for the built-in types.
     template< class Uint_param >
     struct Uint_double_of_
     {
-        static_assert( is_unsigned_v<Uint_param> );
+        static_assert( is_unsigned_v<Uint_param> or is_class_v<Uint_param> );
         using Unit = Uint_param;
 
         Unit parts[2];          // Parts in little endian order.
@@ -59,9 +62,16 @@ namespace kickstart::large_integers::_definitions {
             -> Uint_double_of_
         {
             if constexpr( bits_per_<Unit> <= 32 ) {
-                const int unit_radix = 1ULL << bits_per_<Unit>;
-                return { Unit( 1ULL*a*b % unit_radix ), Unit( 1ULL*a*b / unit_radix ) };
-            } else {
+                const auto product = 1ULL*a*b;
+                return { Unit( product ), Unit( product >> bits_per_<Unit> ) };
+            }
+            #ifdef KS_HAS_NATIVE_UINT_128
+            else if constexpr( bits_per_<Unit> == 64 ) {
+                const Native_uint_128 product = Native_uint_128( a )*b;
+                return { Unit( product ), Unit( product >> 64 ) };
+            }
+            #endif
+            else {
                 using Half_unit = Uint_<bits_per_<Unit>/2>;
 
                 const int half_shift = bits_per_<Half_unit>;
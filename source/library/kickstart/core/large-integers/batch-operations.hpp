@@ -0,0 +1,408 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/collection-util/Array_span_.hpp>      // Array_span_
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+#include <kickstart/core/large-integers/Uint_128.hpp>
+
+#include <stdint.h>         // uint64_t
+
+#include <algorithm>        // std::min
+#include <vector>           // std::vector
+
+#if defined( __AVX2__ ) || defined( __AVX512F__ )
+#   include <immintrin.h>
+#endif
+
+// Operations on arrays of `Uint_128` values, either as an `Array_span_<Uint_128>` or in the
+// split lanes layout `batch::Lanes` with the low and high 64-bit words in separate arrays.
+// The loops are plain word arithmetic without data dependent branches, so that g++ and
+// clang auto-vectorize them at -O3, and the sums, which can't be auto-vectorized with a
+// carry per element, accumulate 32-bit halves of the low words instead of carries. With
+// AVX2 or AVX-512 available the sums use those instructions directly.
+//
+// Multiplication by a 64-bit number needs 64×64→128 bit products that the SIMD instruction
+// sets don't offer, so it's just a loop of scalar multiplications.
+
+namespace kickstart::large_integers::_definitions::batch {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using namespace kickstart::text_conversion;     // ""s, operator<<
+
+    using   kickstart::collection_util::Array_span_;
+    using   kickstart::language::Size;
+    using   std::min, std::vector;
+
+    using Unit = Uint_128::Unit;
+
+    // The split lanes layout: the least and most significant 64 bits of the values in separate
+    // arrays, respectively `low` and `high`. `Word` is `Unit` or `const Unit`.
+    template< class Word >
+    struct Lanes_
+    {
+        Array_span_<Word>   low;
+        Array_span_<Word>   high;
+
+        Lanes_( const Array_span_<Word>& low_words, const Array_span_<Word>& high_words ):
+            low( low_words ),
+            high( high_words )
+        {
+            hopefully( low.size() == high.size() )
+                or KS_FAIL_( std_exception::invalid_argument, "The low and high lanes differ in size." );
+        }
+
+        template< class Other_word >
+        Lanes_( const Lanes_<Other_word>& other ):
+            low( other.low.data(), other.low.size() ),
+            high( other.high.data(), other.high.size() )
+        {}
+
+        auto size() const -> Size { return low.size(); }
+    };
+
+    using Lanes         = Lanes_<Unit>;
+    using Const_lanes   = Lanes_<const Unit>;
+
+    namespace impl {
+        template< class Array_1, class Array_2 >
+        inline void check_same_size( const Array_1& a, const Array_2& b )
+        {
+            hopefully( a.size() == b.size() )
+                or KS_FAIL_( std_exception::invalid_argument,
+                    ""s << "Batch sizes " << a.size() << " and " << b.size() << " differ."
+                    );
+        }
+
+        // Sums of the low and high 32-bit halves of the low words, and sum modulo 2^64 of the
+        // high words. Requires fewer than 2^32 values so that the half sums can't overflow.
+        struct Partial_sums{ Unit low_halves; Unit high_halves; Unit highs; };
+
+        inline auto as_uint_128( const Partial_sums& sums )
+            -> Uint_128
+        {
+            return Uint_128( tag::From_parts(), sums.low_halves, sums.highs )
+                + (Unit( 1 ) << 32)*Uint_128( sums.high_halves );
+        }
+
+        inline auto partial_sums_of( const Unit* const p_low, const Unit* const p_high, const Size n )
+            -> Partial_sums
+        {
+            constexpr Unit low_half_mask = 0xFFFF'FFFF;
+            Size i = 0;
+            Partial_sums result = {};
+            #if defined( __AVX512F__ )
+                __m512i low_halves  = _mm512_setzero_si512();
+                __m512i high_halves = _mm512_setzero_si512();
+                __m512i highs       = _mm512_setzero_si512();
+                const __m512i mask  = _mm512_set1_epi64( low_half_mask );
+                for( ; i + 8 <= n; i += 8 ) {
+                    const __m512i lows = _mm512_loadu_si512( p_low + i );
+                    low_halves  = _mm512_add_epi64( low_halves, _mm512_and_si512( lows, mask ) );
+                    high_halves = _mm512_add_epi64( high_halves, _mm512_srli_epi64( lows, 32 ) );
+                    highs       = _mm512_add_epi64( highs, _mm512_loadu_si512( p_high + i ) );
+                }
+                Unit words[3][8];
+                _mm512_storeu_si512( words[0], low_halves );
+                _mm512_storeu_si512( words[1], high_halves );
+                _mm512_storeu_si512( words[2], highs );
+                for( int lane = 0; lane < 8; ++lane ) {
+                    result.low_halves   += words[0][lane];
+                    result.high_halves  += words[1][lane];
+                    result.highs        += words[2][lane];
+                }
+            #elif defined( __AVX2__ )
+                __m256i low_halves  = _mm256_setzero_si256();
+                __m256i high_halves = _mm256_setzero_si256();
+                __m256i highs       = _mm256_setzero_si256();
+                const __m256i mask  = _mm256_set1_epi64x( low_half_mask );
+                for( ; i + 4 <= n; i += 4 ) {
+                    const __m256i lows = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p_low + i ) );
+                    low_halves  = _mm256_add_epi64( low_halves, _mm256_and_si256( lows, mask ) );
+                    high_halves = _mm256_add_epi64( high_halves, _mm256_srli_epi64( lows, 32 ) );
+                    highs       = _mm256_add_epi64( highs,
+                        _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p_high + i ) )
+                        );
+                }
+                Unit words[4];
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( words ), low_halves );
+                result.low_halves = words[0] + words[1] + words[2] + words[3];
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( words ), high_halves );
+                result.high_halves = words[0] + words[1] + words[2] + words[3];
+                _mm256_storeu_si256( reinterpret_cast<__m256i*>( words ), highs );
+                result.highs = words[0] + words[1] + words[2] + words[3];
+            #endif
+            for( ; i < n; ++i ) {
+                result.low_halves   += p_low[i] & low_half_mask;
+                result.high_halves  += p_low[i] >> 32;
+                result.highs        += p_high[i];
+            }
+            return result;
+        }
+
+        // As above for an array of `Uint_128`, where the words alternate between low and high.
+        inline auto partial_sums_of( const Uint_128* const p_values, const Size n )
+            -> Partial_sums
+        {
+            constexpr Unit low_half_mask = 0xFFFF'FFFF;
+            Size i = 0;
+            Partial_sums result = {};
+            #if defined( __AVX512F__ ) || defined( __AVX2__ )
+                const Unit* const p_words = reinterpret_cast<const Unit*>( p_values );     // Standard layout.
+
+                // Each 64-bit lane sees only low words or only high words. For a high word lane
+                // the masking keeps the whole word and the shifting contributes nothing.
+                #if defined( __AVX512F__ )
+                    __m512i masked  = _mm512_setzero_si512();
+                    __m512i shifted = _mm512_setzero_si512();
+                    const __m512i mask = _mm512_set_epi64( -1, low_half_mask, -1, low_half_mask,
+                        -1, low_half_mask, -1, low_half_mask );
+                    const __m512i shift_mask = _mm512_set_epi64( 0, -1, 0, -1, 0, -1, 0, -1 );
+                    for( ; i + 4 <= n; i += 4 ) {
+                        const __m512i words = _mm512_loadu_si512( p_words + 2*i );
+                        masked  = _mm512_add_epi64( masked, _mm512_and_si512( words, mask ) );
+                        shifted = _mm512_add_epi64( shifted,
+                            _mm512_and_si512( _mm512_srli_epi64( words, 32 ), shift_mask )
+                            );
+                    }
+                    constexpr int n_lanes = 8;
+                    Unit masked_words[n_lanes];     Unit shifted_words[n_lanes];
+                    _mm512_storeu_si512( masked_words, masked );
+                    _mm512_storeu_si512( shifted_words, shifted );
+                #else
+                    __m256i masked  = _mm256_setzero_si256();
+                    __m256i shifted = _mm256_setzero_si256();
+                    const __m256i mask = _mm256_set_epi64x( -1, low_half_mask, -1, low_half_mask );
+                    const __m256i shift_mask = _mm256_set_epi64x( 0, -1, 0, -1 );
+                    for( ; i + 2 <= n; i += 2 ) {
+                        const __m256i words = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p_words + 2*i ) );
+                        masked  = _mm256_add_epi64( masked, _mm256_and_si256( words, mask ) );
+                        shifted = _mm256_add_epi64( shifted,
+                            _mm256_and_si256( _mm256_srli_epi64( words, 32 ), shift_mask )
+                            );
+                    }
+                    constexpr int n_lanes = 4;
+                    Unit masked_words[n_lanes];     Unit shifted_words[n_lanes];
+                    _mm256_storeu_si256( reinterpret_cast<__m256i*>( masked_words ), masked );
+                    _mm256_storeu_si256( reinterpret_cast<__m256i*>( shifted_words ), shifted );
+                #endif
+                for( int lane = 0; lane < n_lanes; lane += 2 ) {
+                    result.low_halves   += masked_words[lane];
+                    result.high_halves  += shifted_words[lane];
+                    result.highs        += masked_words[lane + 1];
+                }
+            #endif
+            for( ; i < n; ++i ) {
+                const Uint_128::Parts& parts = p_values[i].representation();
+                result.low_halves   += parts.parts[0] & low_half_mask;
+                result.high_halves  += parts.parts[0] >> 32;
+                result.highs        += parts.parts[1];
+            }
+            return result;
+        }
+
+        constexpr Size max_partial_sums_size = Size( 1 ) << 31;
+    }  // namespace impl
+
+    // result[i] = a[i] + b[i], modulo 2^128. The result may be `a` or `b`.
+    inline void add(
+        const Array_span_<const Uint_128>&  a,
+        const Array_span_<const Uint_128>&  b,
+        Array_span_<Uint_128>               result
+        )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Uint_128* const pa = a.data();    const Uint_128* const pb = b.data();
+        Uint_128* const pr = result.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Uint_128::Parts& x = pa[i].representation();
+            const Uint_128::Parts& y = pb[i].representation();
+            const Unit low = x.parts[0] + y.parts[0];
+            const Unit carry = (low < x.parts[0]);
+            pr[i] = Uint_128( tag::From_parts(), low, x.parts[1] + y.parts[1] + carry );
+        }
+    }
+
+    // result[i] = a[i] - b[i], modulo 2^128. The result may be `a` or `b`.
+    inline void subtract(
+        const Array_span_<const Uint_128>&  a,
+        const Array_span_<const Uint_128>&  b,
+        Array_span_<Uint_128>               result
+        )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Uint_128* const pa = a.data();    const Uint_128* const pb = b.data();
+        Uint_128* const pr = result.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Uint_128::Parts& x = pa[i].representation();
+            const Uint_128::Parts& y = pb[i].representation();
+            const Unit borrow = (x.parts[0] < y.parts[0]);
+            pr[i] = Uint_128( tag::From_parts(), x.parts[0] - y.parts[0], x.parts[1] - y.parts[1] - borrow );
+        }
+    }
+
+    // result[i] = m·a[i], modulo 2^128. The result may be `a`.
+    inline void multiply_by_64_bit(
+        const Array_span_<const Uint_128>&  a,
+        const Unit                          m,
+        Array_span_<Uint_128>               result
+        )
+    {
+        impl::check_same_size( a, result );
+        const Uint_128* const pa = a.data();
+        Uint_128* const pr = result.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            pr[i] = m*pa[i];
+        }
+    }
+
+    // result[i] = compare( a[i], b[i] ), i.e. -1, 0 or +1.
+    inline void compare(
+        const Array_span_<const Uint_128>&  a,
+        const Array_span_<const Uint_128>&  b,
+        Array_span_<int>                    result
+        )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Uint_128* const pa = a.data();    const Uint_128* const pb = b.data();
+        int* const pr = result.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Uint_128::Parts& x = pa[i].representation();
+            const Uint_128::Parts& y = pb[i].representation();
+            const int is_greater    = (x.parts[1] > y.parts[1]) | ((x.parts[1] == y.parts[1]) & (x.parts[0] > y.parts[0]));
+            const int is_less       = (x.parts[1] < y.parts[1]) | ((x.parts[1] == y.parts[1]) & (x.parts[0] < y.parts[0]));
+            pr[i] = is_greater - is_less;
+        }
+    }
+
+    // The sum of the values modulo 2^128.
+    inline auto sum( const Array_span_<const Uint_128>& values )
+        -> Uint_128
+    {
+        Uint_128 result = 0;
+        for( Size i = 0, n = values.size(); i < n; i += impl::max_partial_sums_size ) {
+            const Size n_chunk = min( impl::max_partial_sums_size, n - i );
+            result += impl::as_uint_128( impl::partial_sums_of( values.data() + i, n_chunk ) );
+        }
+        return result;
+    }
+
+    // result[i] = a[i] + b[i], modulo 2^128. The result may be `a` or `b`.
+    inline void add( const Const_lanes& a, const Const_lanes& b, Lanes result )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Unit* const pa_low = a.low.data();    const Unit* const pa_high = a.high.data();
+        const Unit* const pb_low = b.low.data();    const Unit* const pb_high = b.high.data();
+        Unit* const pr_low = result.low.begin();    Unit* const pr_high = result.high.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Unit low = pa_low[i] + pb_low[i];
+            pr_high[i] = pa_high[i] + pb_high[i] + (low < pa_low[i]);
+            pr_low[i] = low;
+        }
+    }
+
+    // result[i] = a[i] - b[i], modulo 2^128. The result may be `a` or `b`.
+    inline void subtract( const Const_lanes& a, const Const_lanes& b, Lanes result )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Unit* const pa_low = a.low.data();    const Unit* const pa_high = a.high.data();
+        const Unit* const pb_low = b.low.data();    const Unit* const pb_high = b.high.data();
+        Unit* const pr_low = result.low.begin();    Unit* const pr_high = result.high.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Unit borrow = (pa_low[i] < pb_low[i]);
+            pr_high[i] = pa_high[i] - pb_high[i] - borrow;
+            pr_low[i] = pa_low[i] - pb_low[i];
+        }
+    }
+
+    // result[i] = m·a[i], modulo 2^128. The result may be `a`.
+    inline void multiply_by_64_bit( const Const_lanes& a, const Unit m, Lanes result )
+    {
+        impl::check_same_size( a, result );
+        const Unit* const pa_low = a.low.data();    const Unit* const pa_high = a.high.data();
+        Unit* const pr_low = result.low.begin();    Unit* const pr_high = result.high.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const Uint_128::Parts low_product = Uint_128::Parts::product_of( m, pa_low[i] );
+            pr_high[i] = low_product.parts[1] + m*pa_high[i];
+            pr_low[i] = low_product.parts[0];
+        }
+    }
+
+    // result[i] = compare( a[i], b[i] ), i.e. -1, 0 or +1.
+    inline void compare( const Const_lanes& a, const Const_lanes& b, Array_span_<int> result )
+    {
+        impl::check_same_size( a, b );  impl::check_same_size( a, result );
+        const Unit* const pa_low = a.low.data();    const Unit* const pa_high = a.high.data();
+        const Unit* const pb_low = b.low.data();    const Unit* const pb_high = b.high.data();
+        int* const pr = result.begin();
+        for( Size i = 0, n = a.size(); i < n; ++i ) {
+            const int is_greater    = (pa_high[i] > pb_high[i]) | ((pa_high[i] == pb_high[i]) & (pa_low[i] > pb_low[i]));
+            const int is_less       = (pa_high[i] < pb_high[i]) | ((pa_high[i] == pb_high[i]) & (pa_low[i] < pb_low[i]));
+            pr[i] = is_greater - is_less;
+        }
+    }
+
+    // The sum of the values modulo 2^128.
+    inline auto sum( const Const_lanes& values )
+        -> Uint_128
+    {
+        Uint_128 result = 0;
+        for( Size i = 0, n = values.size(); i < n; i += impl::max_partial_sums_size ) {
+            const Size n_chunk = min( impl::max_partial_sums_size, n - i );
+            result += impl::as_uint_128(
+                impl::partial_sums_of( values.low.data() + i, values.high.data() + i, n_chunk )
+                );
+        }
+        return result;
+    }
+
+    // Copies the values to the split lanes layout.
+    inline void split( const Array_span_<const Uint_128>& values, Lanes result )
+    {
+        impl::check_same_size( values, result );
+        for( Size i = 0, n = values.size(); i < n; ++i ) {
+            result.low.begin()[i]   = values[i].representation().parts[0];
+            result.high.begin()[i]  = values[i].representation().parts[1];
+        }
+    }
+
+    // Copies values in the split lanes layout to an array of `Uint_128`.
+    inline void join( const Const_lanes& values, Array_span_<Uint_128> result )
+    {
+        impl::check_same_size( values, result );
+        for( Size i = 0, n = values.size(); i < n; ++i ) {
+            result.begin()[i] = Uint_128( tag::From_parts(), values.low[i], values.high[i] );
+        }
+    }
+}  // namespace kickstart::large_integers::_definitions::batch
+
+namespace kickstart::large_integers::_definitions {
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names {
+        namespace batch = d::batch;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,194 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/large-integers/Uint_double_of_.hpp>
+#include <kickstart/core/large-integers/unit-arithmetic.hpp>    // add_with_carry, subtract_with_borrow
+
+#include <type_traits>      // enable_if_t, is_unsigned_v
+
+// Checked arithmetic where the result value and the overflow flag are produced together,
+// in one pass, e.g. via `__builtin_add_overflow`. A caller can then choose to accept the
+// wrapped value, to saturate, or to trap (throw):
+//
+//      const auto r = checked_sum_of( a, b );      // r.value is wrapped, r.overflow tells.
+//      const auto s = saturated_sum_of( a, b );    // Clamped to the range of the type.
+//      const auto t = checked_sum_of( a, b ).exact_value();    // Throws on overflow.
+//
+// Overloads are provided for `Uint_128` and, as templates, for the built-in unsigned types.
+
+namespace kickstart::large_integers::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    namespace kl = kickstart::language;
+    using   kl::Truth;
+    using   std::enable_if_t, std::is_unsigned_v;
+
+    template< class Value >
+    struct Checked_result_
+    {
+        Value       value;          // The result modulo 2^n.
+        Truth       overflow;       // The math result is not representable.
+
+        constexpr auto is_exact() const -> Truth { return not overflow; }
+
+        constexpr auto exact_value() const
+            -> const Value&
+        {
+            hopefully( not overflow )
+                or KS_FAIL_( std_exception::out_of_range, "The result is out of range." );
+            return value;
+        }
+    };
+
+    //------------------------------------------------------------ Built-in unsigned types:
+
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto checked_sum_of( const Unit a, const Unit b )
+        -> Checked_result_<Unit>
+    {
+        Truth carry = false;
+        const Unit sum = add_with_carry( a, b, carry );
+        return { sum, carry };
+    }
+
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto checked_difference_of( const Unit a, const Unit b )
+        -> Checked_result_<Unit>
+    {
+        Truth borrow = false;
+        const Unit difference = subtract_with_borrow( a, b, borrow );
+        return { difference, borrow };
+    }
+
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto checked_product_of( const Unit a, const Unit b )
+        -> Checked_result_<Unit>
+    {
+        #ifdef KS_HAS_GNU_BUILTINS
+            Unit product = 0;
+            const bool overflow = __builtin_mul_overflow( a, b, &product );
+            return { product, overflow };
+        #else
+            const Uint_double_of_<Unit> product = Uint_double_of_<Unit>::product_of( a, b );
+            return { product.parts[0], product.parts[1] != 0 };
+        #endif
+    }
+
+    // The saturated results are computed with masks, not branches.
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto saturated_sum_of( const Unit a, const Unit b )
+        -> Unit
+    {
+        const Checked_result_<Unit> r = checked_sum_of( a, b );
+        return Unit( r.value | Unit( 0 - +r.overflow ) );
+    }
+
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto saturated_difference_of( const Unit a, const Unit b )
+        -> Unit
+    {
+        const Checked_result_<Unit> r = checked_difference_of( a, b );
+        return Unit( r.value & Unit( +r.overflow - 1 ) );
+    }
+
+    template< class Unit, class = enable_if_t<is_unsigned_v<Unit>> >
+    constexpr inline auto saturated_product_of( const Unit a, const Unit b )
+        -> Unit
+    {
+        const Checked_result_<Unit> r = checked_product_of( a, b );
+        return Unit( r.value | Unit( 0 - +r.overflow ) );
+    }
+
+    //------------------------------------------------------------ Uint_128:
+
+    namespace impl {
+        // All 1-bits if `condition` is true, otherwise all 0-bits.
+        constexpr inline auto uint_128_mask_for( const Truth condition )
+            -> Uint_128
+        {
+            const auto mask = Uint_128::Unit( 0 - +condition );
+            return Uint_128( tag::From_parts(), mask, mask );
+        }
+    }  // namespace impl
+
+    constexpr inline auto checked_sum_of( const Uint_128& a, const Uint_128& b )
+        -> Checked_result_<Uint_128>
+    {
+        Uint_128 sum = a;
+        const Truth carry = (sum.add( b ) == Uint_128::Result_kind::wrapped);
+        return { sum, carry };
+    }
+
+    constexpr inline auto checked_difference_of( const Uint_128& a, const Uint_128& b )
+        -> Checked_result_<Uint_128>
+    {
+        Uint_128 difference = a;
+        const Truth borrow = (difference.subtract( b ) == Uint_128::Result_kind::wrapped);
+        return { difference, borrow };
+    }
+
+    constexpr inline auto checked_product_of( const Uint_128& a, const Uint_128& b )
+        -> Checked_result_<Uint_128>
+    {
+        Uint_128 product = a;
+        const Truth overflow = (product.multiply( b ) == Uint_128::Result_kind::wrapped);
+        return { product, overflow };
+    }
+
+    constexpr inline auto saturated_sum_of( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        const Checked_result_<Uint_128> r = checked_sum_of( a, b );
+        return r.value | impl::uint_128_mask_for( r.overflow );
+    }
+
+    constexpr inline auto saturated_difference_of( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        const Checked_result_<Uint_128> r = checked_difference_of( a, b );
+        return r.value & impl::uint_128_mask_for( not r.overflow );
+    }
+
+    constexpr inline auto saturated_product_of( const Uint_128& a, const Uint_128& b )
+        -> Uint_128
+    {
+        const Checked_result_<Uint_128> r = checked_product_of( a, b );
+        return r.value | impl::uint_128_mask_for( r.overflow );
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Checked_result_,
+        d::checked_sum_of, d::checked_difference_of, d::checked_product_of,
+        d::saturated_sum_of, d::saturated_difference_of, d::saturated_product_of;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,127 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdint.h>         // uint64_t
+
+namespace kickstart::large_integers::_definitions {
+    namespace impl {
+        constexpr char decimal_digit_pairs[] =
+            "00010203040506070809" "10111213141516171819" "20212223242526272829"
+            "30313233343536373839" "40414243444546474849" "50515253545556575859"
+            "60616263646566676869" "70717273747576777879" "80818283848586878889"
+            "90919293949596979899";
+    }  // namespace impl
+
+    constexpr uint64_t  pow10_19                = 10'000'000'000'000'000'000u;
+    constexpr int       max_decimal_digits_64   = 20;
+
+    // Returns the number of digits in the shortest decimal representation of `value`.
+    constexpr inline auto n_decimal_digits_in( const uint64_t value )
+        -> int
+    {
+        int n = 1;
+        for( uint64_t v = value; ; v /= 10'000 ) {
+            if( v < 10 )        { return n; }
+            if( v < 100 )       { return n + 1; }
+            if( v < 1'000 )     { return n + 2; }
+            if( v < 10'000 )    { return n + 3; }
+            n += 4;
+        }
+    }
+
+    // Writes exactly `n_digits` decimal digits of `value`, with leading zeros as necessary,
+    // starting at `p_first`. The digits are produced two at a time from a lookup table.
+    constexpr inline void write_decimal_digits( const uint64_t value, const int n_digits, char* const p_first )
+    {
+        uint64_t v = value;
+        char* p = p_first + n_digits;
+        while( p - p_first >= 2 ) {
+            const int i = 2*int( v % 100 );
+            v /= 100;
+            p -= 2;
+            p[0] = impl::decimal_digit_pairs[i];
+            p[1] = impl::decimal_digit_pairs[i + 1];
+        }
+        if( p != p_first ) {
+            *--p = char( '0' + v % 10 );
+        }
+    }
+
+    // Writes the shortest decimal representation of `value` starting at `p_first`, and
+    // returns a pointer to beyond the last digit. The buffer must have room for
+    // `max_decimal_digits_64` chars.
+    constexpr inline auto write_decimal_digits( const uint64_t value, char* const p_first )
+        -> char*
+    {
+        const int n_digits = n_decimal_digits_in( value );
+        write_decimal_digits( value, n_digits, p_first );
+        return p_first + n_digits;
+    }
+
+    constexpr uint64_t pow10_table[20] =
+    {
+        1u, 10u, 100u, 1'000u, 10'000u, 100'000u, 1'000'000u, 10'000'000u, 100'000'000u,
+        1'000'000'000u, 10'000'000'000u, 100'000'000'000u, 1'000'000'000'000u,
+        10'000'000'000'000u, 100'000'000'000'000u, 1'000'000'000'000'000u,
+        10'000'000'000'000'000u, 100'000'000'000'000'000u, 1'000'000'000'000'000'000u,
+        10'000'000'000'000'000'000u
+    };
+
+    // SIMD-within-a-register (SWAR) handling of 8 chars, as described by Daniel Lemire.
+    // The first char is in the least significant byte, which is a plain load on a
+    // little endian machine; g++ and clang recognize the expression as such.
+    namespace swar {
+        constexpr inline auto load_8_chars( const char* const p_first )
+            -> uint64_t
+        {
+            const auto byte = [&]( const int i ) constexpr
+                -> uint64_t
+            { return uint64_t( static_cast<unsigned char>( p_first[i] ) ) << 8*i; };
+
+            return byte( 0 ) | byte( 1 ) | byte( 2 ) | byte( 3 ) | byte( 4 ) | byte( 5 ) | byte( 6 ) | byte( 7 );
+        }
+
+        constexpr inline auto are_8_decimal_digits( const uint64_t chars )
+            -> bool
+        {
+            const uint64_t high_nibbles         = chars & 0xF0F0'F0F0'F0F0'F0F0u;
+            const uint64_t high_nibbles_if_7up  = (chars + 0x0606'0606'0606'0606u) & 0xF0F0'F0F0'F0F0'F0F0u;
+            return (high_nibbles | high_nibbles_if_7up >> 4) == 0x3333'3333'3333'3333u;
+        }
+
+        // Requires are_8_decimal_digits( chars ). Combines digits pairwise in 3 steps.
+        constexpr inline auto value_of_8_decimal_digits( const uint64_t chars )
+            -> uint32_t
+        {
+            constexpr uint64_t  mask    = 0x0000'00FF'0000'00FFu;
+            constexpr uint64_t  mul_1   = 100 + (1'000'000ull << 32);
+            constexpr uint64_t  mul_2   = 1 + (10'000ull << 32);
+
+            uint64_t v = chars - 0x3030'3030'3030'3030u;
+            v = 10*v + (v >> 8);
+            v = ((v & mask)*mul_1 + ((v >> 16) & mask)*mul_2) >> 32;
+            return uint32_t( v );
+        }
+    }  // namespace swar
+}  // namespace kickstart::large_integers::_definitions
@@ -0,0 +1,237 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/collection-util/Array_span_.hpp>      // Array_span_
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+#include <kickstart/core/large-integers/batch-operations.hpp>   // batch::impl::check_same_size
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>        // wide_product_of
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/large-integers/Uint_double_of_.hpp>
+
+#include <stdint.h>         // uint64_t
+
+// Modular arithmetic with a fixed 64-bit modulus, without division after the set up of a
+// context. `Montgomery_context` requires an odd modulus and is the faster; `Barrett_context`
+// works with any modulus. The contexts have the same interface, and the batch operations
+// `batch::mulmod` and `batch::powmod` accept either.
+
+namespace kickstart::large_integers::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    using   kickstart::collection_util::Array_span_;
+    using   kickstart::language::Size;
+
+    namespace impl {
+        inline constexpr auto full_product_of( const uint64_t a, const uint64_t b )
+            -> Uint_double_of_<uint64_t>
+        { return Uint_double_of_<uint64_t>::product_of( a, b ); }
+    }  // namespace impl
+
+    // Montgomery representation: a value a is represented as a·R mod n, where R = 2^64. The
+    // product of two representations is reduced with a multiplication by n⁻¹ mod R, and a
+    // subtraction, in place of a division by n.
+    class Montgomery_context
+    {
+    public:
+        using Unit = uint64_t;
+
+    private:
+        Unit    m_modulus;
+        Unit    m_inverse;          // modulus·m_inverse ≡ 1 (mod 2^64).
+        Unit    m_r_squared;        // R² mod modulus, for conversions.
+
+        // For T < modulus·R, yields T·R⁻¹ mod modulus.
+        constexpr auto reduced_product( const Uint_double_of_<Unit>& t ) const
+            -> Unit
+        {
+            // With m = T·n⁻¹ mod R the low words of T and m·n are equal, so (T - m·n)/R is the
+            // difference of the high words, in the range (-n, n).
+            const Unit m = t.parts[0]*m_inverse;
+            const Unit mn_high = impl::full_product_of( m, m_modulus ).parts[1];
+            const Unit difference = t.parts[1] - mn_high;
+            return (t.parts[1] < mn_high? difference + m_modulus : difference);
+        }
+
+        static constexpr auto inverse_of( const Unit odd_value )
+            -> Unit
+        {
+            // Newton's iteration doubles the number of correct low bits, from 5 bits for the
+            // start value 3·a xor 2, to 10, 20, 40 and 80.
+            Unit x = (3*odd_value) ^ 2;
+            for( int i = 0; i < 4; ++i ) { x *= 2 - odd_value*x; }
+            return x;
+        }
+
+    public:
+        constexpr explicit Montgomery_context( const Unit modulus ):
+            m_modulus( modulus ),
+            m_inverse( inverse_of( modulus ) ),
+            m_r_squared( 0 )
+        {
+            hopefully( modulus % 2 == 1 )
+                or KS_FAIL_( std_exception::invalid_argument, "A Montgomery modulus must be odd." );
+            const Unit r_mod_n = Unit( 0 - modulus ) % modulus;        // 2^64 mod n.
+            m_r_squared = (r_mod_n*Uint_128( r_mod_n )).divmod_by_64_bit( modulus ).remainder.modulo_64_bits();
+        }
+
+        constexpr auto modulus() const -> Unit { return m_modulus; }
+
+        // Conversions to and from the Montgomery representation, and the product in that
+        // representation. Representations are less than the modulus.
+        constexpr auto to_montgomery( const Unit a ) const -> Unit { return montgomery_product( reduced( a ), m_r_squared ); }
+        constexpr auto from_montgomery( const Unit a ) const -> Unit { return reduced_product( {a, 0} ); }
+
+        constexpr auto montgomery_product( const Unit a, const Unit b ) const
+            -> Unit
+        { return reduced_product( impl::full_product_of( a, b ) ); }
+
+        // a mod n for any 64-bit a, as (a·R⁻¹)·R² reduced, since a < R ≤ n·R.
+        constexpr auto reduced( const Unit a ) const
+            -> Unit
+        { return montgomery_product( reduced_product( {a, 0} ), m_r_squared ); }
+
+        // a·b mod n, where at least one of a and b is less than the modulus.
+        constexpr auto mulmod( const Unit a, const Unit b ) const
+            -> Unit
+        { return montgomery_product( montgomery_product( a, b ), m_r_squared ); }
+
+        // base^exponent mod n, by squaring and multiplying in the Montgomery representation.
+        constexpr auto powmod( const Unit base, const Unit exponent ) const
+            -> Unit
+        {
+            const Unit m_base = to_montgomery( base );
+            Unit m_result = to_montgomery( 1 );
+            for( Unit bit = (exponent == 0? 0 : Unit( 1 ) << (63 - n_leading_zeros_in( exponent ))); bit != 0; bit >>= 1 ) {
+                m_result = montgomery_product( m_result, m_result );
+                if( exponent & bit ) { m_result = montgomery_product( m_result, m_base ); }
+            }
+            return from_montgomery( m_result );
+        }
+    };
+
+    // Barrett reduction: x mod n = x - q·n where q is estimated as the high 128 bits of x·m,
+    // for the precomputed m = ⌊(2^128 - 1)/n⌋. The estimate is at most 2 too small.
+    class Barrett_context
+    {
+    public:
+        using Unit = uint64_t;
+
+    private:
+        Unit        m_modulus;
+        Uint_128    m_reciprocal;
+
+        // x mod n for x < n·2^64.
+        constexpr auto reduced_128( const Uint_128& x ) const
+            -> Unit
+        {
+            const Uint_128 q = wide_product_of( x, m_reciprocal ).representation().parts[1];
+            Uint_128 r = x - q.modulo_64_bits()*Uint_128( m_modulus );     // Less than 3n.
+            if( r >= m_modulus ) { r -= m_modulus; }
+            if( r >= m_modulus ) { r -= m_modulus; }
+            return r.modulo_64_bits();
+        }
+
+    public:
+        constexpr explicit Barrett_context( const Unit modulus ):
+            m_modulus( modulus ),
+            m_reciprocal()
+        {
+            hopefully( modulus != 0 )
+                or KS_FAIL_( std_exception::invalid_argument, "A Barrett modulus must be non-zero." );
+            m_reciprocal = (~Uint_128()).divmod_by_64_bit( modulus ).quotient;
+        }
+
+        constexpr auto modulus() const -> Unit { return m_modulus; }
+
+        constexpr auto reduced( const Unit a ) const -> Unit { return reduced_128( a ); }
+
+        // a·b mod n, where at least one of a and b is less than the modulus.
+        constexpr auto mulmod( const Unit a, const Unit b ) const
+            -> Unit
+        { return reduced_128( a*Uint_128( b ) ); }
+
+        // base^exponent mod n, by squaring and multiplying.
+        constexpr auto powmod( const Unit base, const Unit exponent ) const
+            -> Unit
+        {
+            const Unit reduced_base = reduced( base );
+            Unit result = reduced( 1 );
+            for( Unit bit = (exponent == 0? 0 : Unit( 1 ) << (63 - n_leading_zeros_in( exponent ))); bit != 0; bit >>= 1 ) {
+                result = mulmod( result, result );
+                if( exponent & bit ) { result = mulmod( result, reduced_base ); }
+            }
+            return result;
+        }
+    };
+
+    namespace batch {
+        // result[i] = a[i]·b[i] mod n, where for each i at least one of a[i] and b[i] is less
+        // than the modulus. The result may be `a` or `b`. The context is a `Montgomery_context`
+        // or a `Barrett_context`.
+        template< class Modular_context >
+        inline void mulmod(
+            const Modular_context&          context,
+            const Array_span_<const Unit>&  a,
+            const Array_span_<const Unit>&  b,
+            Array_span_<Unit>               result
+            )
+        {
+            impl::check_same_size( a, b );  impl::check_same_size( a, result );
+            const Unit* const pa = a.data();    const Unit* const pb = b.data();
+            Unit* const pr = result.data();
+            for( Size i = 0, n = a.size(); i < n; ++i ) {
+                pr[i] = context.mulmod( pa[i], pb[i] );
+            }
+        }
+
+        // result[i] = bases[i]^exponent mod n. The result may be `bases`.
+        template< class Modular_context >
+        inline void powmod(
+            const Modular_context&          context,
+            const Array_span_<const Unit>&  bases,
+            const Unit                      exponent,
+            Array_span_<Unit>               result
+            )
+        {
+            impl::check_same_size( bases, result );
+            const Unit* const p_bases = bases.data();
+            Unit* const pr = result.data();
+            for( Size i = 0, n = bases.size(); i < n; ++i ) {
+                pr[i] = context.powmod( p_bases[i], exponent );
+            }
+        }
+    }  // namespace batch
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Montgomery_context,
+        d::Barrett_context;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
@@ -0,0 +1,521 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+#include <kickstart/core/large-integers/Fixed_uint_.hpp>        // wide_product_of
+#include <kickstart/core/large-integers/modular-arithmetic.hpp> // Montgomery_context
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/large-integers/~for-each-chunk.hpp>    // impl::for_each_chunk
+
+#include <math.h>           // log, sqrt
+#include <stdint.h>         // uint8_t, uint32_t, uint64_t
+
+#include <algorithm>        // std::(fill, min)
+#include <utility>          // std::move
+#include <vector>           // std::vector
+
+// Primality testing and prime generation.
+//
+// `is_prime` is deterministic. For 64-bit values it's a Miller-Rabin test with 7 bases that
+// are known to identify all 64-bit composites, and for values below 3.3·10^24 it's a
+// Miller-Rabin test with the first 13 primes as bases, which likewise is proven correct. For
+// larger values it's the Baillie-PSW test, a Miller-Rabin test with base 2 plus a strong
+// Lucas test, which has no known counterexamples. All modular arithmetic is Montgomery
+// multiplication, without divisions.
+//
+// `for_each_prime_in` and `primes_in` produce the primes in a range [first, beyond) with a
+// segmented sieve of Eratosthenes, where each segment fits in a typical L1 data cache.
+// `primes_in` can split the range between threads. The sieving is exact below 2^40. Above
+// that the sieving primes are limited to 2^20, to bound the memory and the set up time, and
+// the numbers that survive the sieving are tested with `is_prime`.
+
+namespace kickstart::large_integers::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    namespace kl = kickstart::language;
+    using   kl::Size, kl::Truth;
+    using   std::fill, std::min, std::move, std::vector;
+
+    namespace impl::primes {
+        // Montgomery multiplication with a 128-bit odd modulus, R = 2^128, with the same
+        // interface as the 64-bit `Montgomery_context` as used by the tests below.
+        class Montgomery_context_128
+        {
+        public:
+            using Unit = Uint_128;
+
+        private:
+            Uint_128    m_modulus;
+            Uint_128    m_inverse;          // modulus·m_inverse ≡ 1 (mod 2^128).
+            Uint_128    m_r_squared;        // R² mod modulus.
+
+            constexpr auto sum_of( const Uint_128& a, const Uint_128& b ) const
+                -> Uint_128
+            {
+                Uint_128 sum = a;
+                const Truth carry = (sum.add( b ) == Uint_128::Result_kind::wrapped);
+                return (carry or sum >= m_modulus? sum - m_modulus : sum);
+            }
+
+        public:
+            constexpr explicit Montgomery_context_128( const Uint_128& modulus ):
+                m_modulus( modulus ),
+                m_inverse( 0 ),
+                m_r_squared( 0 )
+            {
+                hopefully( lsb_is_set_in( modulus.modulo_64_bits() ) )
+                    or KS_FAIL_( std_exception::invalid_argument, "A Montgomery modulus must be odd." );
+
+                // Newton's iteration, from 5 correct bits to 160.
+                Uint_128 x = (3*modulus) ^ Uint_128( 2 );
+                for( int i = 0; i < 5; ++i ) { x *= 2 - modulus*x; }
+                m_inverse = x;
+
+                // R mod n, doubled 128 times.
+                Uint_128 r = (0 - modulus) % modulus;
+                for( int i = 0; i < 128; ++i ) { r = sum_of( r, r ); }
+                m_r_squared = r;
+            }
+
+            constexpr auto modulus() const -> const Uint_128& { return m_modulus; }
+
+            constexpr auto montgomery_product( const Uint_128& a, const Uint_128& b ) const
+                -> Uint_128
+            {
+                const Uint_256 t = wide_product_of( a, b );
+                const Uint_128& t_low = t.representation().parts[0];
+                const Uint_128& t_high = t.representation().parts[1];
+                const Uint_128 m = t_low*m_inverse;
+                const Uint_128 mn_high = wide_product_of( m, m_modulus ).representation().parts[1];
+                const Uint_128 difference = t_high - mn_high;
+                return (t_high < mn_high? difference + m_modulus : difference);
+            }
+
+            constexpr auto to_montgomery( const Uint_128& a ) const
+                -> Uint_128
+            { return montgomery_product( a % m_modulus, m_r_squared ); }
+
+            constexpr auto from_montgomery( const Uint_128& a ) const
+                -> Uint_128
+            { return montgomery_product( a, 1 ); }
+
+            // Arithmetic on Montgomery representations, which are less than the modulus.
+            constexpr auto sum( const Uint_128& a, const Uint_128& b ) const -> Uint_128 { return sum_of( a, b ); }
+
+            constexpr auto difference( const Uint_128& a, const Uint_128& b ) const
+                -> Uint_128
+            { return (a >= b? a - b : a + (m_modulus - b)); }
+
+            constexpr auto half( const Uint_128& a ) const
+                -> Uint_128
+            {
+                if( not lsb_is_set_in( a.modulo_64_bits() ) ) { return a >> 1; }
+                Uint_128 sum = a;
+                const Truth carry = (sum.add( m_modulus ) == Uint_128::Result_kind::wrapped);
+                return (sum >> 1) | (Uint_128( +carry ) << 127);
+            }
+        };
+
+        // For the 64-bit case of the templates below; the `Uint_128` functions are found via ADL.
+        inline constexpr auto bit_width( const uint64_t v ) -> int { return (v == 0? 0 : 64 - n_leading_zeros_in( v )); }
+        inline constexpr auto countr_zero( const uint64_t v ) -> int { return n_trailing_zeros_in( v ); }
+
+        // base^exponent in Montgomery representation, for a base in Montgomery representation.
+        template< class Context >
+        constexpr auto montgomery_power(
+            const Context&                  context,
+            const typename Context::Unit&   base,
+            const typename Context::Unit&   exponent,
+            const typename Context::Unit&   one         // In Montgomery representation.
+            ) -> typename Context::Unit
+        {
+            using Unit = typename Context::Unit;
+            Unit result = one;
+            for( int i_bit = bit_width( exponent ) - 1; i_bit >= 0; --i_bit ) {
+                result = context.montgomery_product( result, result );
+                if( ((exponent >> i_bit) & Unit( 1 )) != 0 ) { result = context.montgomery_product( result, base ); }
+            }
+            return result;
+        }
+
+        // Whether the odd n > 2 is a strong probable prime to the specified base, i.e. with
+        // n - 1 = d·2^s, d odd, whether base^d ≡ 1 or base^(d·2^r) ≡ -1 for some r < s.
+        template< class Context >
+        constexpr auto is_strong_probable_prime( const Context& context, const uint64_t base )
+            -> Truth
+        {
+            using Unit = typename Context::Unit;
+            const Unit& n = context.modulus();
+            const Unit n_minus_1 = n - 1;
+            const int s = countr_zero( n_minus_1 );
+            const Unit d = n_minus_1 >> s;
+
+            const Unit one = context.to_montgomery( 1 );
+            const Unit minus_one = n - one;
+            const Unit a = context.to_montgomery( base );
+            if( a == 0 ) { return true; }       // The base is a multiple of n.
+
+            Unit x = montgomery_power( context, a, d, one );
+            if( x == one or x == minus_one ) { return true; }
+            for( int r = 1; r < s; ++r ) {
+                x = context.montgomery_product( x, x );
+                if( x == minus_one ) { return true; }
+                if( x == one ) { return false; }
+            }
+            return false;
+        }
+
+        // The Jacobi symbol (a/m) for odd m, as -1, 0 or +1.
+        inline constexpr auto jacobi_symbol( uint64_t a, uint64_t m )
+            -> int
+        {
+            int result = 1;
+            a %= m;
+            while( a != 0 ) {
+                const int n_twos = countr_zero( a );
+                a >>= n_twos;
+                if( n_twos % 2 == 1 and (m % 8 == 3 or m % 8 == 5) ) { result = -result; }
+                if( a % 4 == 3 and m % 4 == 3 ) { result = -result; }
+                const uint64_t t = a;  a = m % a;  m = t;
+            }
+            return (m == 1? result : 0);
+        }
+
+        // (a/n) for an odd a, |a| < 2^63, and an odd n.
+        inline constexpr auto jacobi_symbol( const int64_t a, const Uint_128& n )
+            -> int
+        {
+            const uint64_t n_mod_8 = n.modulo_64_bits() % 8;
+            int sign = 1;
+            if( a < 0 and n_mod_8 % 4 == 3 ) { sign = -1; }           // (-1/n).
+            const uint64_t magnitude = uint64_t( a < 0? -a : a );
+            if( magnitude % 4 == 3 and n_mod_8 % 4 == 3 ) { sign = -sign; }      // Reciprocity.
+            return sign*jacobi_symbol( n.divmod_by_64_bit( magnitude ).remainder.modulo_64_bits(), magnitude );
+        }
+
+        inline constexpr auto is_perfect_square( const Uint_128& n )
+            -> Truth
+        {
+            // Newton's iteration from above, where n/x < 2^64 for the start value.
+            Uint_128 x = Uint_128( 1 ) << ((bit_width( n ) + 1)/2);
+            for( ;; ) {
+                const Uint_128 y = (x + n/x) >> 1;
+                if( y >= x ) { break; }
+                x = y;
+            }
+            return (x*x == n);
+        }
+
+        // The strong Lucas probable prime test with Selfridge's parameters: D is the first of
+        // 5, -7, 9, -11, ... with (D/n) = -1, P = 1 and Q = (1 - D)/4. For odd n that isn't
+        // divisible by a small prime. With n + 1 = d·2^s, d odd, the test is whether
+        // U_d ≡ 0 or V_(d·2^r) ≡ 0 for some r < s.
+        inline auto is_strong_lucas_probable_prime( const Uint_128& n )
+            -> Truth
+        {
+            int64_t dd = 5;
+            for( int i = 0; ; ++i ) {
+                const int j = jacobi_symbol( dd, n );
+                if( j == -1 ) { break; }
+                if( j == 0 ) { return false; }          // |D| < n is a factor of n.
+                if( i == 8 and is_perfect_square( n ) ) { return false; }
+                dd = (dd > 0? -(dd + 2) : -dd + 2);
+            }
+            const int64_t qq = (1 - dd)/4;
+
+            const Montgomery_context_128 context( n );
+            const auto montgomery_value_of = [&]( const int64_t v ) -> Uint_128
+            {
+                const Uint_128 magnitude = context.to_montgomery( uint64_t( v < 0? -v : v ) );
+                return (v < 0? context.difference( 0, magnitude ) : magnitude);
+            };
+            const Uint_128 d_m = montgomery_value_of( dd );
+            const Uint_128 q_m = montgomery_value_of( qq );
+            const Uint_128 one = context.to_montgomery( 1 );
+
+            const Uint_128 n_plus_1 = n + 1;
+            const int s = countr_zero( n_plus_1 );
+            const Uint_128 d = n_plus_1 >> s;
+
+            // The sequences U_k, V_k and Q^k, from k = 1, with k doubled and possibly
+            // incremented for each following bit of d.
+            Uint_128 u = one;
+            Uint_128 v = one;
+            Uint_128 q_k = q_m;
+            for( int i_bit = bit_width( d ) - 2; i_bit >= 0; --i_bit ) {
+                u = context.montgomery_product( u, v );
+                v = context.difference( context.montgomery_product( v, v ), context.sum( q_k, q_k ) );
+                q_k = context.montgomery_product( q_k, q_k );
+                if( ((d >> i_bit) & Uint_128( 1 )) != 0 ) {
+                    const Uint_128 new_u = context.half( context.sum( u, v ) );
+                    v = context.half( context.sum( context.montgomery_product( d_m, u ), v ) );
+                    u = new_u;
+                    q_k = context.montgomery_product( q_k, q_m );
+                }
+            }
+            if( u == 0 or v == 0 ) { return true; }
+            for( int r = 1; r < s; ++r ) {
+                v = context.difference( context.montgomery_product( v, v ), context.sum( q_k, q_k ) );
+                if( v == 0 ) { return true; }
+                q_k = context.montgomery_product( q_k, q_k );
+            }
+            return false;
+        }
+
+        // The odd primes below 64, and their product, which is less than 2^64.
+        constexpr uint64_t small_primes[] = { 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61 };
+        constexpr uint64_t small_primes_product_1 = 3ull*5*7*11*13*17*19*23*29*31*37*41*43*47;
+        constexpr uint64_t small_primes_product_2 = 53ull*59*61;
+
+        // Whether n has a prime factor less than 64, via remainders of products of those primes.
+        inline constexpr auto has_small_factor( const uint64_t n_mod_1, const uint64_t n_mod_2 )
+            -> Truth
+        {
+            for( const uint64_t p: small_primes ) {
+                const uint64_t r = (p < 53? n_mod_1 : n_mod_2) % p;
+                if( r == 0 ) { return true; }
+            }
+            return false;
+        }
+    }  // namespace impl::primes
+
+    inline constexpr auto is_prime( const uint64_t n )
+        -> Truth
+    {
+        using namespace impl::primes;
+        if( n < 64 ) {
+            if( n == 2 ) { return true; }
+            for( const uint64_t p: small_primes ) { if( n == p ) { return true; } }
+            return false;
+        }
+        if( n % 2 == 0 or has_small_factor( n % small_primes_product_1, n % small_primes_product_2 ) ) {
+            return false;
+        }
+        if( n < 64*64 ) { return true; }
+
+        // These bases identify all composites below 2^64 (Jim Sinclair, 2011).
+        const Montgomery_context context( n );
+        for( const uint64_t base: {2, 325, 9375, 28178, 450775, 9780504, 1795265022} ) {
+            if( not is_strong_probable_prime( context, base ) ) { return false; }
+        }
+        return true;
+    }
+
+    inline auto is_prime( const Uint_128& n )
+        -> Truth
+    {
+        using namespace impl::primes;
+        if( n.is_in_64_bit_range() ) { return is_prime( n.modulo_64_bits() ); }
+        if( not lsb_is_set_in( n.modulo_64_bits() ) ) { return false; }
+        const uint64_t n_mod_1 = n.divmod_by_64_bit( small_primes_product_1 ).remainder.modulo_64_bits();
+        const uint64_t n_mod_2 = n.divmod_by_64_bit( small_primes_product_2 ).remainder.modulo_64_bits();
+        if( has_small_factor( n_mod_1, n_mod_2 ) ) { return false; }
+
+        const Montgomery_context_128 context( n );
+        if( not is_strong_probable_prime( context, 2 ) ) { return false; }
+
+        // Below ψ13 ≈ 3.3·10^24 the first 13 primes as bases identify all composites
+        // (Sorenson and Webster, 2015). Above that the strong Lucas test completes Baillie-PSW.
+        constexpr auto psi_13 = Uint_128( tag::From_parts(), 0x51AD'C5B2'2410'A5FDull, 0x2'BE69ull );
+        if( n < psi_13 ) {
+            for( const uint64_t base: {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41} ) {
+                if( not is_strong_probable_prime( context, base ) ) { return false; }
+            }
+            return true;
+        }
+        return is_strong_lucas_probable_prime( n );
+    }
+
+    namespace impl::primes {
+        constexpr Size      sieve_segment_size  = 32*1024;      // Odd numbers per segment, 1 byte each.
+        constexpr uint64_t  max_sieving_prime   = 1 << 20;      // Sieves exactly up to 2^40.
+
+        inline auto isqrt( const uint64_t n )
+            -> uint64_t
+        {
+            uint64_t x = uint64_t( sqrt( double( n ) ) );
+            while( x > 0 and (x > 0xFFFF'FFFF or x*x > n) ) { --x; }
+            while( x < 0xFFFF'FFFF and (x + 1)*(x + 1) <= n ) { ++x; }
+            return x;
+        }
+
+        // Calls `f( p )` for each prime p in [first, beyond), where first is odd and at least
+        // 3, and `sieving_primes` are the odd primes up to √(beyond - 1) or `max_sieving_prime`,
+        // whichever is less, ascending. In the latter case the numbers that survive the sieving
+        // are tested with `is_prime`. The sieving state is the offset in the segment of the next
+        // odd multiple of each prime, so that no divisions are needed after the start.
+        template< class Func >
+        inline void for_each_odd_prime_in(
+            const uint64_t              first,
+            const uint64_t              beyond,
+            const vector<uint32_t>&     sieving_primes,
+            const Func&                 f
+            )
+        {
+            if( first >= beyond ) { return; }
+            const uint64_t n_odds = (beyond - first + 1)/2;    // Numbers first, first + 2, ...
+
+            // Offsets, in odd numbers, from `first` to the first odd multiple m ≥ p² of each p.
+            const uint64_t last = first + 2*(n_odds - 1);
+            const Truth sieving_is_exact = (isqrt( last ) <= max_sieving_prime);
+            vector<uint64_t> offsets;
+            for( const uint32_t prime: sieving_primes ) {
+                const uint64_t p = prime;
+                if( p*p > last ) { break; }
+                uint64_t delta = 0;
+                if( p*p >= first ) {
+                    delta = p*p - first;
+                } else {
+                    const uint64_t r = first % p;
+                    delta = (r == 0? 0 : p - r);
+                    if( delta % 2 == 1 ) { delta += p; }     // Then first + delta is odd.
+                }
+                offsets.push_back( delta/2 );
+            }
+
+            vector<uint8_t> is_composite( sieve_segment_size );
+            for( uint64_t i_segment = 0; i_segment < n_odds; i_segment += sieve_segment_size ) {
+                const Size n = Size( min<uint64_t>( sieve_segment_size, n_odds - i_segment ) );
+                fill( is_composite.begin(), is_composite.begin() + n, uint8_t( 0 ) );
+                for( Size i_prime = 0, n_primes = Size( offsets.size() ); i_prime < n_primes; ++i_prime ) {
+                    const uint64_t p = sieving_primes[i_prime];
+                    uint64_t j = offsets[i_prime];
+                    for( ; j < uint64_t( n ); j += p ) { is_composite[j] = 1; }
+                    offsets[i_prime] = j - n;
+                }
+                const uint64_t segment_first = first + 2*i_segment;
+                for( Size i = 0; i < n; ++i ) {
+                    if( is_composite[i] ) { continue; }
+                    const uint64_t number = segment_first + 2*i;
+                    if( sieving_is_exact or is_prime( number ) ) { f( number ); }
+                }
+            }
+        }
+
+        // The odd primes up to and including `limit`, which must be less than 2^32.
+        inline auto odd_primes_up_to( const uint64_t limit )
+            -> vector<uint32_t>
+        {
+            vector<uint32_t> result;
+            if( limit < 3 ) { return result; }
+
+            // The primes up to √limit, by a plain sieve, are used to sieve the rest.
+            const uint64_t root = isqrt( limit );
+            vector<uint8_t> is_composite( root + 1 );
+            for( uint64_t i = 3; i <= root; i += 2 ) {
+                if( is_composite[i] ) { continue; }
+                result.push_back( uint32_t( i ) );
+                for( uint64_t j = i*i; j <= root; j += 2*i ) { is_composite[j] = 1; }
+            }
+            const uint64_t first = (root + 1) | 1;
+            vector<uint32_t> more;
+            for_each_odd_prime_in( first, limit + 1, result, [&]( const uint64_t p ) { more.push_back( uint32_t( p ) ); } );
+            result.insert( result.end(), more.begin(), more.end() );
+            return result;
+        }
+
+        // Density 1/ln x at the middle of the range, plus a margin, for reserving capacity.
+        inline auto estimated_n_primes_in( const uint64_t first, const uint64_t beyond )
+            -> Size
+        {
+            const uint64_t n = beyond - first;
+            const double middle = double( first ) + double( n )/2;
+            return Size( 1.15*double( n )/log( middle < 3? 3 : middle ) ) + 64;
+        }
+
+        inline auto sieving_primes_for( const uint64_t beyond )
+            -> vector<uint32_t>
+        { return odd_primes_up_to( beyond < 2? 0 : min( isqrt( beyond - 1 ), max_sieving_prime ) ); }
+    }  // namespace impl::primes
+
+    // Calls `f( p )` for each prime p in [first, beyond), in ascending order.
+    template< class Func >
+    inline void for_each_prime_in( const uint64_t first, const uint64_t beyond, const Func& f )
+    {
+        if( first <= 2 and 2 < beyond ) { f( uint64_t( 2 ) ); }
+        const uint64_t odd_first = (first < 3? 3 : first | 1);
+        impl::primes::for_each_odd_prime_in(
+            odd_first, beyond, impl::primes::sieving_primes_for( beyond ), f
+            );
+    }
+
+    // The primes in [first, beyond), in ascending order, where the sieving is split between
+    // `n_threads` threads.
+    inline auto primes_in( const uint64_t first, const uint64_t beyond, const int n_threads = 1 )
+        -> vector<uint64_t>
+    {
+        hopefully( n_threads >= 1 )
+            or KS_FAIL_( std_exception::invalid_argument, "The number of threads must be at least 1." );
+
+        vector<uint64_t> result;
+        if( first <= 2 and 2 < beyond ) { result.push_back( 2 ); }
+        const uint64_t odd_first = (first < 3? 3 : first | 1);
+        if( odd_first >= beyond ) { return result; }
+
+        const vector<uint32_t> sieving_primes = impl::primes::sieving_primes_for( beyond );
+        const uint64_t n_odds = (beyond - odd_first + 1)/2;
+        const Size n_segments = Size( (n_odds + impl::primes::sieve_segment_size - 1)/impl::primes::sieve_segment_size );
+        const int n_used_threads = int( min<Size>( n_threads, n_segments ) );
+
+        // Each thread sieves a range of whole segments. The first thread appends to `result`.
+        vector<vector<uint64_t>> chunk_primes( n_used_threads );
+        chunk_primes[0] = move( result );
+        impl::for_each_chunk( n_used_threads, n_segments,
+            [&]( const int i_thread, const Size i_first_segment, const Size i_beyond_segment )
+            {
+                const uint64_t i_first = uint64_t( i_first_segment )*impl::primes::sieve_segment_size;
+                const uint64_t i_beyond = min<uint64_t>( n_odds, uint64_t( i_beyond_segment )*impl::primes::sieve_segment_size );
+                const uint64_t chunk_first = odd_first + 2*i_first;
+                const uint64_t chunk_beyond = (i_beyond == n_odds? beyond : odd_first + 2*i_beyond);
+                vector<uint64_t>& primes = chunk_primes[i_thread];
+                primes.reserve( primes.size() + impl::primes::estimated_n_primes_in( chunk_first, chunk_beyond ) );
+                impl::primes::for_each_odd_prime_in( chunk_first, chunk_beyond, sieving_primes,
+                    [&primes]( const uint64_t p ) { primes.push_back( p ); }
+                    );
+            } );
+
+        result = move( chunk_primes[0] );
+        Size n_primes = Size( result.size() );
+        for( int i = 1; i < n_used_threads; ++i ) { n_primes += Size( chunk_primes[i].size() ); }
+        result.reserve( n_primes );
+        for( int i = 1; i < n_used_threads; ++i ) {
+            result.insert( result.end(), chunk_primes[i].begin(), chunk_primes[i].end() );
+        }
+        return result;
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::is_prime,
+        d::for_each_prime_in,
+        d::primes_in;
+    }  // namespace exported_names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
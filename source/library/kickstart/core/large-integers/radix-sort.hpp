@@ -0,0 +1,236 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include <kickstart/core/collection-util/Array_span_.hpp>      // Array_span_
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+#include <kickstart/core/large-integers/batch-operations.hpp>   // batch
+#include <kickstart/core/large-integers/Uint_128.hpp>
+#include <kickstart/core/large-integers/~for-each-chunk.hpp>    // impl::for_each_chunk
+
+#include <algorithm>        // std::(copy, max, min, sort)
+#include <array>            // std::array
+#include <atomic>           // std::atomic
+#include <vector>           // std::vector
+
+// Sorting of `Uint_128` values in ascending order with a most significant digit first radix
+// sort, with 8-bit digits. A pass scatters the values, without comparisons, into 256 buckets
+// by the 8 bits from the most significant bit where they differ, and the buckets are then
+// sorted the same way, except that buckets of at most `max_comparison_sort_size` values are
+// sorted with `std::sort`. So bits where all the values in a bucket are equal, e.g. the zero
+// high bits of sequential IDs, are skipped, and random keys need only about log₂₅₆(n) passes.
+// The 8-bit digits keep the staging buffers of a pass at 32 KiB, which fits in the L1 cache.
+//
+// With `n_threads` > 1 the first pass is done by that many threads, each counting and
+// scattering its own chunk of the values, and the threads then sort the buckets.
+
+namespace kickstart::large_integers::_definitions::batch {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+
+    using   kickstart::collection_util::Array_span_;
+    using   kickstart::language::Size;
+    using   std::copy, std::max, std::min, std::sort,
+            std::array,
+            std::atomic,
+            std::vector;
+
+    namespace impl::radix {
+        constexpr int   n_bits_per_digit    = 8;
+        constexpr int   radix               = 1 << n_bits_per_digit;
+
+        // Buckets of up to this many values are sorted by comparisons.
+        constexpr Size  max_comparison_sort_size = 128;
+
+        using Digit_counts = array<Size, radix>;
+
+        // The digit with lowest bit at position `i_bit`. Only a digit that straddles the two
+        // words needs bits from both.
+        inline auto digit_of( const Uint_128& v, const int i_bit )
+            -> int
+        {
+            const Unit* const words = v.representation().parts;
+            const Unit bits = (0?0
+                : i_bit + n_bits_per_digit <= 64?   words[0] >> i_bit
+                : i_bit >= 64?                      words[1] >> (i_bit - 64)
+                :                                   words[0] >> i_bit | words[1] << (64 - i_bit)
+                );
+            return int( bits & (radix - 1) );
+        }
+
+        // Values are staged in small per digit buffers that are copied to the target as whole
+        // cache lines, which reduces cache and TLB misses compared to scattering each value
+        // directly. That pays off only for a chunk of values that's large compared to the
+        // buffers.
+        constexpr int   staging_capacity    = 8;        // 2 cache lines of 64 bytes.
+        constexpr Size  min_staged_size     = 16*radix*staging_capacity;
+
+        // The bits that differ between any of the values.
+        inline auto varying_bits_of( const Uint_128* const values, const Size n )
+            -> Uint_128
+        {
+            const Unit* const first_words = values[0].representation().parts;
+            Unit varying[2] = {};
+            for( Size i = 1; i < n; ++i ) {
+                const Unit* const words = values[i].representation().parts;
+                varying[0] |= words[0] ^ first_words[0];
+                varying[1] |= words[1] ^ first_words[1];
+            }
+            return Uint_128( tag::From_parts(), varying[0], varying[1] );
+        }
+
+        // The lowest bit position of the digit that has the most significant 1 in `bits` as
+        // its top bit, or at position 0, or -1 if `bits` is zero.
+        inline auto most_significant_digit_of( const Uint_128& bits )
+            -> int
+        {
+            if( bits == 0 ) { return -1; }
+            return max( 0, bit_width( bits ) - n_bits_per_digit );
+        }
+
+        // One stable scatter pass of a chunk from `source` to `target`, by the digit at `i_bit`,
+        // where `offsets` are the target indices for each digit value and are updated.
+        inline void scatter_chunk(
+            const Uint_128* const   source,
+            Uint_128* const         target,
+            const Size              i_first,
+            const Size              i_beyond,
+            const int               i_bit,
+            Digit_counts&           offsets
+            )
+        {
+            if( i_beyond - i_first < min_staged_size ) {
+                for( Size i = i_first; i < i_beyond; ++i ) {
+                    target[offsets[digit_of( source[i], i_bit )]++] = source[i];
+                }
+                return;
+            }
+
+            vector<Uint_128> staged( radix*staging_capacity );
+            array<int, radix> n_staged = {};
+            for( Size i = i_first; i < i_beyond; ++i ) {
+                const int digit = digit_of( source[i], i_bit );
+                Uint_128* const buffer = staged.data() + digit*staging_capacity;
+                buffer[n_staged[digit]++] = source[i];
+                if( n_staged[digit] == staging_capacity ) {
+                    copy( buffer, buffer + staging_capacity, target + offsets[digit] );
+                    offsets[digit] += staging_capacity;
+                    n_staged[digit] = 0;
+                }
+            }
+            for( int digit = 0; digit < radix; ++digit ) {
+                const Uint_128* const buffer = staged.data() + digit*staging_capacity;
+                copy( buffer, buffer + n_staged[digit], target + offsets[digit] );
+            }
+        }
+
+        // One stable scatter pass from `source` to `target` by the digit at `i_bit`, where each
+        // thread counts and scatters its own chunk with per chunk offsets. Returns the counts
+        // of the digit values over all the values.
+        inline auto scatter(
+            const Uint_128* const   source,
+            Uint_128* const         target,
+            const Size              n,
+            const int               i_bit,
+            const int               n_threads
+            ) -> Digit_counts
+        {
+            vector<Digit_counts> chunk_counts( n_threads, Digit_counts() );
+            _definitions::impl::for_each_chunk( n_threads, n, [&]( const int i_thread, const Size i_first, const Size i_beyond )
+            {
+                Digit_counts& chunk = chunk_counts[i_thread];
+                for( Size i = i_first; i < i_beyond; ++i ) { ++chunk[digit_of( source[i], i_bit )]; }
+            } );
+
+            // Turns the counts into start offsets, ordered by digit and then by chunk.
+            Digit_counts result = {};
+            Size offset = 0;
+            for( int digit = 0; digit < radix; ++digit ) {
+                for( Digit_counts& chunk: chunk_counts ) {
+                    const Size count = chunk[digit];
+                    chunk[digit] = offset;
+                    offset += count;
+                    result[digit] += count;
+                }
+            }
+
+            _definitions::impl::for_each_chunk( n_threads, n, [&]( const int i_thread, const Size i_first, const Size i_beyond )
+            {
+                scatter_chunk( source, target, i_first, i_beyond, i_bit, chunk_counts[i_thread] );
+            } );
+            return result;
+        }
+
+        // Sorts `n` values into `target`, where they're now in `source`, which is either
+        // `target` or a buffer of the same size. A pass scatters them by their most significant
+        // varying digit to the other of the two, and the buckets are then sorted the same way.
+        inline void sort_bucket(
+            Uint_128* const         source,
+            Uint_128* const         target,
+            Uint_128* const         buffer,
+            const Size              n,
+            const int               n_threads = 1
+            )
+        {
+            const int i_bit = (n <= max_comparison_sort_size
+                ? -1 : most_significant_digit_of( varying_bits_of( source, n ) )
+                );
+            if( i_bit < 0 ) {
+                if( source != target ) { copy( source, source + n, target ); }
+                sort( target, target + n );
+                return;
+            }
+
+            Uint_128* const next_source = (source == target? buffer : target);
+            const Digit_counts counts = scatter( source, next_source, n, i_bit, n_threads );
+            vector<Size> starts( radix + 1, 0 );
+            for( int digit = 0; digit < radix; ++digit ) { starts[digit + 1] = starts[digit] + counts[digit]; }
+
+            // With more than one thread, the threads take buckets in order until all are sorted.
+            atomic<int> i_next_digit = 0;
+            _definitions::impl::for_each_chunk( n_threads, n_threads, [&]( int, Size, Size )
+            {
+                for( int digit; (digit = i_next_digit++) < radix; ) {
+                    const Size start = starts[digit];
+                    sort_bucket( next_source + start, target + start, buffer + start, counts[digit] );
+                }
+            } );
+        }
+    }  // namespace impl::radix
+
+    // Sorts the values in ascending order, using a buffer of the same size as `values`.
+    inline void radix_sort( Array_span_<Uint_128> values, const int n_threads = 1 )
+    {
+        using namespace impl::radix;
+        hopefully( n_threads >= 1 )
+            or KS_FAIL_( std_exception::invalid_argument, "The number of threads must be at least 1." );
+
+        const Size n = values.size();
+        if( n < 2 ) { return; }
+        const int n_used_threads = int( min<Size>( n_threads, n ) );
+
+        vector<Uint_128> buffer( n );
+        sort_bucket( values.data(), values.data(), buffer.data(), n, n_used_threads );
+    }
+}  // namespace kickstart::large_integers::_definitions::batch
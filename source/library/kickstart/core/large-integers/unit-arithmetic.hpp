@@ -0,0 +1,282 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/language/lx/bits_per_.hpp>             // lx::bits_per_
+#include <kickstart/core/language/Truth.hpp>                    // Truth
+
+#include <stdint.h>         // uint64_t
+
+#include <type_traits>      // is_unsigned_v
+
+// The native backend is used when the compiler offers a 128-bit unsigned integer type,
+// which in practice means g++ or clang for a 64-bit target such as x86-64 or AArch64.
+// Then 64×64→128 products compile to single `mul`/`mulx` or `mul`+`umulh` instructions,
+// and carries to `adc`/`sbb` or `adds`/`adcs`. Define KS_NO_NATIVE_UINT_128_PLEASE to
+// use the portable `constexpr` code also where the native type is available.
+#if defined( __SIZEOF_INT128__ ) && !defined( KS_NO_NATIVE_UINT_128_PLEASE )
+#   define KS_HAS_NATIVE_UINT_128       1
+#endif
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#   define KS_HAS_GNU_BUILTINS          1
+#endif
+
+#if defined( KS_HAS_NATIVE_UINT_128 ) && defined( __x86_64__ )
+#   define KS_HAS_X86_64_DIVQ           1
+#endif
+
+namespace kickstart::large_integers::_definitions {
+    namespace kl = kickstart::language;
+
+    using   kl::lx::bits_per_,
+            kl::Truth;
+    using   std::is_unsigned_v;
+
+    #ifdef KS_HAS_NATIVE_UINT_128
+        __extension__ typedef unsigned __int128 Native_uint_128;
+        __extension__ typedef __int128 Native_int_128;
+        constexpr Truth has_native_uint_128 = true;
+    #else
+        constexpr Truth has_native_uint_128 = false;
+    #endif
+
+    // Returns the number of consecutive 0-bits from the most significant end of `x`.
+    template< class Unit >
+    constexpr inline auto n_leading_zeros_in( const Unit x )
+        -> int
+    {
+        static_assert( is_unsigned_v<Unit> );
+        if( x == 0 ) { return bits_per_<Unit>; }
+        #ifdef KS_HAS_GNU_BUILTINS
+            if constexpr( bits_per_<Unit> <= bits_per_<unsigned> ) {
+                return __builtin_clz( x ) - (bits_per_<unsigned> - bits_per_<Unit>);
+            } else if constexpr( bits_per_<Unit> <= bits_per_<unsigned long> ) {
+                return __builtin_clzl( x ) - (bits_per_<unsigned long> - bits_per_<Unit>);
+            } else {
+                return __builtin_clzll( x ) - (bits_per_<unsigned long long> - bits_per_<Unit>);
+            }
+        #else
+            int n = 0;
+            Unit bits = x;
+            for( int shift = bits_per_<Unit>/2; shift > 0; shift /= 2 ) {
+                if( Unit( bits >> (bits_per_<Unit> - shift) ) == 0 ) {
+                    n += shift;
+                    bits = Unit( bits << shift );
+                }
+            }
+            return n;
+        #endif
+    }
+
+    // Returns the number of consecutive 0-bits from the least significant end of `x`.
+    template< class Unit >
+    constexpr inline auto n_trailing_zeros_in( const Unit x )
+        -> int
+    {
+        static_assert( is_unsigned_v<Unit> );
+        if( x == 0 ) { return bits_per_<Unit>; }
+        #ifdef KS_HAS_GNU_BUILTINS
+            if constexpr( bits_per_<Unit> <= bits_per_<unsigned> ) {
+                return __builtin_ctz( x );
+            } else if constexpr( bits_per_<Unit> <= bits_per_<unsigned long> ) {
+                return __builtin_ctzl( x );
+            } else {
+                return __builtin_ctzll( x );
+            }
+        #else
+            int n = 0;
+            Unit bits = x;
+            for( int shift = bits_per_<Unit>/2; shift > 0; shift /= 2 ) {
+                if( Unit( bits << (bits_per_<Unit> - shift) ) == 0 ) {
+                    n += shift;
+                    bits = Unit( bits >> shift );
+                }
+            }
+            return n;
+        #endif
+    }
+
+    // Returns the number of 1-bits in `x`.
+    template< class Unit >
+    constexpr inline auto n_ones_in( const Unit x )
+        -> int
+    {
+        static_assert( is_unsigned_v<Unit> );
+        #ifdef KS_HAS_GNU_BUILTINS
+            if constexpr( bits_per_<Unit> <= bits_per_<unsigned> ) {
+                return __builtin_popcount( x );
+            } else if constexpr( bits_per_<Unit> <= bits_per_<unsigned long> ) {
+                return __builtin_popcountl( x );
+            } else {
+                return __builtin_popcountll( x );
+            }
+        #else
+            int n = 0;
+            for( Unit bits = x; bits != 0; bits = Unit( bits & (bits - 1) ) ) { ++n; }
+            return n;
+        #endif
+    }
+
+    // Returns a + b + carry modulo the Unit range, and updates `carry` to the carry out.
+    template< class Unit >
+    constexpr inline auto add_with_carry( const Unit a, const Unit b, Truth& carry )
+        -> Unit
+    {
+        static_assert( is_unsigned_v<Unit> );
+        #ifdef KS_HAS_GNU_BUILTINS
+            Unit partial = 0;       Unit sum = 0;
+            const bool carry_1 = __builtin_add_overflow( a, b, &partial );
+            const bool carry_2 = __builtin_add_overflow( partial, Unit( +carry ), &sum );
+            carry = (carry_1 or carry_2);
+            return sum;
+        #else
+            const Unit partial  = Unit( a + b );
+            const Unit sum      = Unit( partial + +carry );
+            carry = (partial < a or sum < partial);
+            return sum;
+        #endif
+    }
+
+    // Returns a - b - borrow modulo the Unit range, and updates `borrow` to the borrow out.
+    template< class Unit >
+    constexpr inline auto subtract_with_borrow( const Unit a, const Unit b, Truth& borrow )
+        -> Unit
+    {
+        static_assert( is_unsigned_v<Unit> );
+        #ifdef KS_HAS_GNU_BUILTINS
+            Unit partial = 0;       Unit difference = 0;
+            const bool borrow_1 = __builtin_sub_overflow( a, b, &partial );
+            const bool borrow_2 = __builtin_sub_overflow( partial, Unit( +borrow ), &difference );
+            borrow = (borrow_1 or borrow_2);
+            return difference;
+        #else
+            const Unit partial      = Unit( a - b );
+            const Unit difference   = Unit( partial - +borrow );
+            borrow = (a < b or partial < Unit( +borrow ));
+            return difference;
+        #endif
+    }
+
+
+    namespace impl {
+        #ifdef KS_HAS_X86_64_DIVQ
+            // Not `constexpr`, hence only used when not evaluating a constant expression.
+            inline auto divq( const uint64_t high, const uint64_t low, const uint64_t divisor, uint64_t& remainder )
+                -> uint64_t
+            {
+                uint64_t quotient;
+                __asm__( "divq %[v]" : "=a"( quotient ), "=d"( remainder ) : [v] "r"( divisor ), "a"( low ), "d"( high ) );
+                return quotient;
+            }
+        #endif
+
+        // Knuth's algorithm D specialized to a two-digit divisor and a four-digit dividend,
+        // where a digit is half a Unit; “divlu” in Henry S. Warren's “Hacker's Delight”.
+        template< class Unit >
+        constexpr inline auto portable_divide_double_unit(
+            const Unit          high,
+            const Unit          low,
+            const Unit          divisor,
+            Unit&               remainder
+            ) -> Unit
+        {
+            constexpr int   half_shift  = bits_per_<Unit>/2;
+            constexpr Unit  half_radix  = Unit( 1 ) << half_shift;
+            constexpr Unit  half_mask   = half_radix - 1;
+
+            const int   n_shifts        = n_leading_zeros_in( divisor );
+            const Unit  v               = Unit( divisor << n_shifts );
+            const Unit  v_digits[2]     = { Unit( v & half_mask ), Unit( v >> half_shift ) };
+
+            const Unit  u_32 = Unit( high << n_shifts
+                | (n_shifts == 0? 0 : low >> (bits_per_<Unit> - n_shifts)) );
+            const Unit  u_10 = Unit( low << n_shifts );
+            const Unit  u_digits[2]     = { Unit( u_10 & half_mask ), Unit( u_10 >> half_shift ) };
+
+            // Each quotient digit estimate from the top digits is at most 2 too large.
+            const auto quotient_digit = [&]( const Unit u_top, const Unit u_next ) constexpr
+                -> Unit
+            {
+                Unit q      = u_top / v_digits[1];
+                Unit r_hat  = u_top - q*v_digits[1];
+                while( q >= half_radix or q*v_digits[0] > (r_hat << half_shift) + u_next ) {
+                    --q;
+                    r_hat += v_digits[1];
+                    if( r_hat >= half_radix ) { break; }
+                }
+                return q;
+            };
+
+            const Unit  q_1     = quotient_digit( u_32, u_digits[1] );
+            const Unit  u_21    = Unit( (u_32 << half_shift) + u_digits[1] - q_1*v );
+            const Unit  q_0     = quotient_digit( u_21, u_digits[0] );
+            remainder = Unit( ((u_21 << half_shift) + u_digits[0] - q_0*v) >> n_shifts );
+            return Unit( (q_1 << half_shift) + q_0 );
+        }
+    }  // namespace impl
+
+    // Returns (high·radix + low)/divisor and sets `remainder`, where radix = 2^bits_per_<Unit>.
+    // Requires high < divisor, which means that the quotient fits in a Unit.
+    template< class Unit >
+    constexpr inline auto divide_double_unit(
+        const Unit          high,
+        const Unit          low,
+        const Unit          divisor,
+        Unit&               remainder
+        ) -> Unit
+    {
+        static_assert( is_unsigned_v<Unit> );
+        #ifdef KS_HAS_NATIVE_UINT_128
+            if constexpr( bits_per_<Unit> == 64 ) {
+                #ifdef KS_HAS_X86_64_DIVQ
+                    if( not __builtin_is_constant_evaluated() ) {
+                        return impl::divq( high, low, divisor, remainder );
+                    }
+                #endif
+                const Native_uint_128 dividend = Native_uint_128( high ) << 64 | low;
+                remainder = Unit( dividend % divisor );
+                return Unit( dividend / divisor );
+            }
+        #endif
+        if constexpr( bits_per_<Unit> <= 32 ) {
+            const auto dividend = 1ULL*high << bits_per_<Unit> | low;
+            remainder = Unit( dividend % divisor );
+            return Unit( dividend / divisor );
+        } else {
+            return impl::portable_divide_double_unit( high, low, divisor, remainder );
+        }
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::has_native_uint_128;
+        #ifdef KS_HAS_NATIVE_UINT_128
+            using d::Native_uint_128, d::Native_int_128;
+        #endif
+    }  // namespace exported names
+}  // namespace kickstart::large_integers::_definitions
+
+namespace kickstart::large_integers   { using namespace _definitions::exported_names; }
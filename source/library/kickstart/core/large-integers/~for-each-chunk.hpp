@@ -0,0 +1,52 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+
+#include <algorithm>        // std::min
+#include <thread>           // std::thread
+#include <vector>           // std::vector
+
+// Support for the multithreaded large integer operations, such as `batch::radix_sort` and
+// `primes_in`, which take the number of threads as an argument.
+
+namespace kickstart::large_integers::_definitions::impl {
+    using   kickstart::language::Size;
+    using   std::min, std::thread, std::vector;
+
+    // Calls `f( i_thread, i_first, i_beyond )` for each of `n_threads` chunks of [0, n), with
+    // the first chunk handled by the calling thread.
+    template< class Func >
+    inline void for_each_chunk( const int n_threads, const Size n, const Func& f )
+    {
+        const auto chunk_start = [&]( const int i ) -> Size { return Size( (n/n_threads)*i + min<Size>( i, n%n_threads ) ); };
+        vector<thread> threads;
+        threads.reserve( n_threads - 1 );
+        for( int i = 1; i < n_threads; ++i ) {
+            threads.emplace_back( [&f, i, &chunk_start]{ f( i, chunk_start( i ), chunk_start( i + 1 ) ); } );
+        }
+        f( 0, chunk_start( 0 ), chunk_start( 1 ) );
+        for( thread& t: threads ) { t.join(); }
+    }
+}  // namespace kickstart::large_integers::_definitions::impl
@@ -24,4 +24,10 @@
 
 #include <kickstart/core/matrices/Abstract_matrix_.hpp>
 #include <kickstart/core/matrices/Matrix_.hpp>
+#include <kickstart/core/matrices/Matrix_view_.hpp>
+#include <kickstart/core/matrices/Sparse_matrix_.hpp>
+#include <kickstart/core/matrices/expressions.hpp>
+#include <kickstart/core/matrices/multiplication.hpp>
+#include <kickstart/core/matrices/parallel-operations.hpp>
+#include <kickstart/core/matrices/thread-pool.hpp>
 #include <kickstart/core/matrices/vector-pool.hpp>
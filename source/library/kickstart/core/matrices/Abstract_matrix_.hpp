@@ -42,12 +42,13 @@ namespace kickstart::matrices::_definitions {
         virtual auto items()        -> Item*                = 0;
         virtual auto items() const  -> const Item*          = 0;
 
-        virtual auto width() const  -> int  { return size().w; }
-        virtual auto height() const -> int  { return size().h; }
+        virtual auto width() const      -> int  { return size().w; }
+        virtual auto height() const     -> int  { return size().h; }
+        virtual auto row_stride() const -> int  { return width(); }
 
         auto items_index_for( const two_d_grid::Position& pos ) const
             -> int
-        { return pos.y*width() + pos.x; }
+        { return pos.y*row_stride() + pos.x; }
 
         auto operator()( const two_d_grid::Position& pos )
             -> Item&
@@ -44,7 +44,8 @@ namespace kickstart::matrices::_definitions {
             return reinterpret_cast<Abstract_matrix_ref_<const Item>&>( *this );
         }
 
-        virtual auto size() const   -> two_d_grid::Size   { return m_p_matrix->size(); }
+        virtual auto size() const       -> two_d_grid::Size   { return m_p_matrix->size(); }
+        virtual auto row_stride() const -> int                { return m_p_matrix->row_stride(); }
         virtual auto items()        -> Item*        { return m_p_matrix->items(); }
         virtual auto items() const  -> const Item*  { return m_p_matrix->items(); }
     };
@@ -0,0 +1,90 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stddef.h>         // size_t
+
+#include <algorithm>        // std::max
+#include <new>              // std::align_val_t, operator new
+#include <vector>           // std::vector
+
+// A standard library allocator for memory aligned to `alignment` bytes, by default a cache
+// line. With `Aligned_vector_<Item>` the first item is at the start of a cache line, and when
+// each row of a matrix occupies a whole number of cache lines every row starts at one.
+
+namespace kickstart::matrices::_definitions {
+    using   std::align_val_t,
+            std::max,
+            std::vector;
+
+    constexpr int cache_line_size = 64;
+
+    template< class Item_type_param, int alignment_param = cache_line_size >
+    class Aligned_allocator_
+    {
+    public:
+        using value_type = Item_type_param;
+        static constexpr int alignment = max<int>( alignment_param, alignof( value_type ) );
+
+        template< class Other >
+        struct rebind { using other = Aligned_allocator_<Other, alignment_param>; };
+
+        Aligned_allocator_() noexcept {}
+
+        template< class Other >
+        Aligned_allocator_( const Aligned_allocator_<Other, alignment_param>& ) noexcept {}
+
+        auto allocate( const size_t n )
+            -> value_type*
+        { return static_cast<value_type*>( ::operator new( n*sizeof( value_type ), align_val_t( alignment ) ) ); }
+
+        void deallocate( value_type* const p, size_t ) noexcept
+        {
+            ::operator delete( p, align_val_t( alignment ) );
+        }
+
+        template< class Other >
+        friend auto operator==( const Aligned_allocator_&, const Aligned_allocator_<Other, alignment_param>& )
+            -> bool
+        { return true; }
+
+        template< class Other >
+        friend auto operator!=( const Aligned_allocator_&, const Aligned_allocator_<Other, alignment_param>& )
+            -> bool
+        { return false; }
+    };
+
+    template< class Item >
+    using Aligned_vector_ = vector<Item, Aligned_allocator_<Item>>;
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::cache_line_size,
+        d::Aligned_allocator_,
+        d::Aligned_vector_;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -25,12 +25,14 @@
 #include <kickstart/core/collection-util.hpp>
 #include <kickstart/core/language/Truth.hpp>
 #include <kickstart/core/matrices/Abstract_matrix_.hpp>
+#include <kickstart/core/matrices/Aligned_allocator_.hpp>
 #include <kickstart/core/matrices/vector-pool.hpp>
 
 #include <assert.h>
 
 #include <algorithm>
 #include <initializer_list>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -39,11 +41,37 @@ namespace kickstart::matrices::_definitions {
     using   std::copy, std::swap,
             std::initializer_list,
             std::move,
+            std::remove_const_t,
             std::vector;
 
     template< class Item_type_param >
     class Abstract_matrix_ref_;
 
+    // How the rows of a `Matrix_` are placed in its item buffer, which starts at a cache line.
+    //
+    // * `packed`:  each row directly follows the previous one.
+    // * `aligned`: each row starts at a cache line, i.e. rows are padded to whole cache lines.
+    // * `padded`:  as `aligned`, but with an odd number of cache lines per row, so that the
+    //              items of a column are in different cache sets also for widths such as 4096.
+    //
+    // Rows can only be aligned when the item size divides the cache line size; otherwise the
+    // rows are packed.
+    struct Row_layout{ enum Enum{ packed, aligned, padded }; };
+
+    template< class Item >
+    constexpr auto row_stride_for( const int width, const Row_layout::Enum layout )
+        -> int
+    {
+        constexpr int line_size = cache_line_size;
+        constexpr int n_items_per_line = int( line_size/sizeof( Item ) );
+        if( layout == Row_layout::packed or width == 0 or line_size % sizeof( Item ) != 0 ) {
+            return width;
+        }
+        int n_lines = (width + n_items_per_line - 1)/n_items_per_line;
+        if( layout == Row_layout::padded and n_lines % 2 == 0 ) { ++n_lines; }
+        return n_lines*n_items_per_line;
+    }
+
     template< class Item_type_param >
     class Matrix_
     {
@@ -51,28 +79,36 @@ namespace kickstart::matrices::_definitions {
         using Item = Item_type_param;
 
     private:
-        vector<Item>    m_items;
-        two_d_grid::Size      m_size;
+        // With a `const` item type the items are only accessible as `const`, but the vector
+        // item type must be non-`const`.
+        Aligned_vector_<remove_const_t<Item>>   m_items;
+        two_d_grid::Size                        m_size;
+        Row_layout::Enum                        m_layout;
+        int                                     m_row_stride;
 
     public:
         ~Matrix_() { deallocate_vector( m_items ); }
 
-        Matrix_( const two_d_grid::Size size = {} ):
-            m_items( allocate_vector_<Item>( size.w*size.h ) ),
-            m_size( size )
+        Matrix_( const two_d_grid::Size size = {}, const Row_layout::Enum layout = Row_layout::packed ):
+            m_items( allocate_vector_<Item>( row_stride_for<Item>( size.w, layout )*size.h ) ),
+            m_size( size ),
+            m_layout( layout ),
+            m_row_stride( row_stride_for<Item>( size.w, layout ) )
         {}
 
-        Matrix_( const int width, const int height ):
-            Matrix_( two_d_grid::Size{ width, height } )
+        Matrix_( const int width, const int height, const Row_layout::Enum layout = Row_layout::packed ):
+            Matrix_( two_d_grid::Size{ width, height }, layout )
         {}
 
-        Matrix_( const int size ):
-            Matrix_( two_d_grid::Size{ size, size} )
+        Matrix_( const int size, const Row_layout::Enum layout = Row_layout::packed ):
+            Matrix_( two_d_grid::Size{ size, size}, layout )
         {}
 
         Matrix_( const two_d_grid::Size size, const initializer_list<initializer_list<Item>>& values ):
             m_items( allocate_vector_<Item>( size.h * size.w ) ),
-            m_size( size )
+            m_size( size ),
+            m_layout( Row_layout::packed ),
+            m_row_stride( size.w )
         {
             const int first_row_size = int_size( *values.begin() );
 
@@ -83,7 +119,7 @@ namespace kickstart::matrices::_definitions {
             for( const initializer_list<Item>& row: values ) {
                 assert( int_size( row ) == first_row_size );
                 copy( row.begin(), row.end(), p_row );
-                p_row += m_size.w;
+                p_row += m_row_stride;
             }
         }
 
@@ -92,16 +128,62 @@ namespace kickstart::matrices::_definitions {
         {}
 
         Matrix_( const Matrix_& other ):
-            m_items( allocate_vector_<Item>( other.m_items.size() ), false ),
-            m_size( other.m_size )
+            m_items( allocate_vector_<Item>( int_size( other.m_items ), false ) ),
+            m_size( other.m_size ),
+            m_layout( other.m_layout ),
+            m_row_stride( other.m_row_stride )
         {
-            m_items = other.m_items;
+            copy( other.m_items.begin(), other.m_items.end(), m_items.begin() );
         }
 
-        Matrix_( Matrix_&& other ):
-            m_items( move( other ) ),
-            m_size( other.m_size )
-        {}
+        // Takes over the item buffer. The moved-from matrix is left empty, with size 0×0.
+        Matrix_( Matrix_&& other ) noexcept:
+            m_items( move( other.m_items ) ),
+            m_size( other.m_size ),
+            m_layout( other.m_layout ),
+            m_row_stride( other.m_row_stride )
+        {
+            other.m_items.clear();
+            other.m_size = {};
+            other.m_layout = Row_layout::packed;
+            other.m_row_stride = 0;
+        }
+
+        // Copies into the existing item buffer when it has the right size, and otherwise
+        // copies and swaps so that the old buffer is returned to the pool.
+        auto operator=( const Matrix_& other )
+            -> Matrix_&
+        {
+            if( &other == this ) {
+                return *this;
+            } else if( m_items.size() == other.m_items.size() ) {
+                copy( other.m_items.begin(), other.m_items.end(), m_items.begin() );
+                m_size = other.m_size;
+                m_layout = other.m_layout;
+                m_row_stride = other.m_row_stride;
+            } else {
+                Matrix_ copy_of_other( other );
+                swap_with( copy_of_other );
+            }
+            return *this;
+        }
+
+        // The old item buffer is returned to the pool, and `other` is left empty.
+        auto operator=( Matrix_&& other ) noexcept
+            -> Matrix_&
+        {
+            Matrix_ old_value( move( other ) );
+            swap_with( old_value );
+            return *this;
+        }
+
+        void swap_with( Matrix_& other ) noexcept
+        {
+            m_items.swap( other.m_items );
+            swap( m_size, other.m_size );
+            swap( m_layout, other.m_layout );
+            swap( m_row_stride, other.m_row_stride );
+        }
 
         operator Matrix_<const Item>& () const
         {
@@ -111,10 +193,12 @@ namespace kickstart::matrices::_definitions {
         auto size() const       -> two_d_grid::Size { return m_size; }
         auto width() const      -> int              { return m_size.w; }
         auto height() const     -> int              { return m_size.h; }
+        auto layout() const     -> Row_layout::Enum { return m_layout; }
+        auto row_stride() const -> int              { return m_row_stride; }
 
         auto items_index_for( const two_d_grid::Position& pos ) const
             -> int
-        { return pos.y*m_size.w + pos.x; }
+        { return pos.y*m_row_stride + pos.x; }
 
         auto items()        -> Item*        { return m_items.data(); }
         auto items() const  -> const Item*  { return m_items.data(); }
@@ -136,6 +220,9 @@ namespace kickstart::matrices::_definitions {
         { return (*this)( {x, y} ); }
     };
 
+    template< class Item >
+    void swap( Matrix_<Item>& a, Matrix_<Item>& b ) noexcept { a.swap_with( b ); }
+
     template< class Item >
     void swap_rows( const int i1, const int i2, Matrix_<Item>& m )
     {
@@ -155,15 +242,16 @@ namespace kickstart::matrices::_definitions {
         if( i1 == i2 ) { return; }
 
         const two_d_grid::Size size = m.size();
-        if( size.w == 0 ) { return; }
+        if( size.w == 0 or size.h == 0 ) { return; }
 
         auto p1 = m.items() + m.items_index_for({ i1, 0 });
         auto p2 = m.items() + m.items_index_for({ i2, 0 });
+        const int stride = m.row_stride();
 
         for( int count = 1; ; ++count ) {
             swap( *p1, *p2 );
             if( count == size.h ) { break; }
-            p1 += size.w;  p2 += size.w;
+            p1 += stride;  p2 += stride;
         }
     }
 
@@ -171,7 +259,10 @@ namespace kickstart::matrices::_definitions {
     namespace d = _definitions;
     namespace exported_names { using
         d::Abstract_matrix_ref_,
+        d::Row_layout,
+        d::row_stride_for,
         d::Matrix_,
+        d::swap,
         d::swap_rows,
         d::swap_columns;
     }  // namespace exported names
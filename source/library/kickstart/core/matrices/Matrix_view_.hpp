@@ -0,0 +1,182 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/failure-handling.hpp>          // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>            // Truth
+#include <kickstart/core/matrices/Abstract_matrix_.hpp> // two_d_grid
+#include <kickstart/core/matrices/Matrix_.hpp>
+
+#include <type_traits>      // std::(is_const_v, remove_const_t)
+#include <utility>          // std::swap
+
+// A `Matrix_view_<Item>` refers to items in a `Matrix_` or other storage, without owning them.
+// Item (x, y) is at `items()[y*row_stride() + x*item_stride()]`, so a view can be a block of
+// a matrix, a row or a column of it, or the transposition of any of these. Use
+// `Matrix_view_<const Item>` for read only access.
+//
+// Views are small and are passed by value or `const&`. Copying a view doesn't copy items.
+
+namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using   kickstart::language::Truth;
+    using   std::is_const_v, std::remove_const_t;
+
+    template< class Item_type_param >
+    class Matrix_view_
+    {
+    public:
+        using Item = Item_type_param;
+
+    private:
+        Item*               m_p_first;
+        two_d_grid::Size    m_size;
+        int                 m_row_stride;       // Distance between the starts of rows.
+        int                 m_item_stride;      // Distance between items in a row.
+
+    public:
+        Matrix_view_(
+            Item* const                 p_first,
+            const two_d_grid::Size      size,
+            const int                   row_stride,
+            const int                   item_stride = 1
+            ):
+            m_p_first( p_first ),
+            m_size( size ),
+            m_row_stride( row_stride ),
+            m_item_stride( item_stride )
+        {}
+
+        Matrix_view_( Matrix_<Item>& m ):
+            Matrix_view_( m.items(), m.size(), m.row_stride() )
+        {}
+
+        // For a `Matrix_view_<const T>`.
+        Matrix_view_( const Matrix_<remove_const_t<Item>>& m ):
+            Matrix_view_( m.items(), m.size(), m.row_stride() )
+        {}
+
+        // A `Matrix_view_<T>` converts implicitly to a `Matrix_view_<const T>`.
+        template< class Other_item, class = std::enable_if_t<is_const_v<Item> and not is_const_v<Other_item>> >
+        Matrix_view_( const Matrix_view_<Other_item>& other ):
+            Matrix_view_( other.items(), other.size(), other.row_stride(), other.item_stride() )
+        {}
+
+        auto size() const           -> two_d_grid::Size { return m_size; }
+        auto width() const          -> int              { return m_size.w; }
+        auto height() const         -> int              { return m_size.h; }
+        auto row_stride() const     -> int              { return m_row_stride; }
+        auto item_stride() const    -> int              { return m_item_stride; }
+
+        auto has_contiguous_rows() const -> Truth { return m_item_stride == 1; }
+
+        auto items_index_for( const two_d_grid::Position& pos ) const
+            -> int
+        { return pos.y*m_row_stride + pos.x*m_item_stride; }
+
+        // Pointer to item (0, 0).
+        auto items() const -> Item* { return m_p_first; }
+
+        auto operator()( const two_d_grid::Position& pos ) const
+            -> Item&
+        { return m_p_first[items_index_for( pos )]; }
+
+        auto operator()( const int x, const int y ) const
+            -> Item&
+        { return (*this)( {x, y} ); }
+
+        // The block with top left corner at `pos` in this view.
+        auto sub_view( const two_d_grid::Position& pos, const two_d_grid::Size& size ) const
+            -> Matrix_view_
+        {
+            hopefully( 0 <= pos.x and 0 <= size.w and pos.x + size.w <= m_size.w )
+                or KS_FAIL_( std_exception::out_of_range, "The sub-view's columns are outside the view." );
+            hopefully( 0 <= pos.y and 0 <= size.h and pos.y + size.h <= m_size.h )
+                or KS_FAIL_( std_exception::out_of_range, "The sub-view's rows are outside the view." );
+            const Truth is_empty = (size.w == 0 or size.h == 0);
+            return Matrix_view_(
+                m_p_first + (is_empty? 0 : items_index_for( pos )), size, m_row_stride, m_item_stride
+                );
+        }
+
+        auto row( const int y ) const       -> Matrix_view_ { return sub_view( {0, y}, {m_size.w, 1} ); }
+        auto column( const int x ) const    -> Matrix_view_ { return sub_view( {x, 0}, {1, m_size.h} ); }
+
+        // The view with rows and columns exchanged, i.e. item (x, y) here is (y, x) there.
+        auto transposed() const
+            -> Matrix_view_
+        { return Matrix_view_( m_p_first, {m_size.h, m_size.w}, m_item_stride, m_row_stride ); }
+    };
+
+    template< class Item >
+    inline auto view_of( Matrix_<Item>& m ) -> Matrix_view_<Item> { return Matrix_view_<Item>( m ); }
+
+    template< class Item >
+    inline auto view_of( const Matrix_<Item>& m ) -> Matrix_view_<const Item> { return Matrix_view_<const Item>( m ); }
+
+    // Returns a new matrix with a copy of the items of `view`.
+    template< class Item >
+    inline auto copy_of( const Matrix_view_<Item>& view )
+        -> Matrix_<remove_const_t<Item>>
+    {
+        Matrix_<remove_const_t<Item>> result( view.size() );
+        for( int y = 0; y < view.height(); ++y ) {
+            for( int x = 0; x < view.width(); ++x ) { result( x, y ) = view( x, y ); }
+        }
+        return result;
+    }
+
+    template< class Item >
+    void swap_rows( const int i1, const int i2, const Matrix_view_<Item>& m )
+    {
+        if( i1 == i2 ) { return; }
+
+        Item* p1 = m.items() + m.items_index_for({ 0, i1 });
+        Item* p2 = m.items() + m.items_index_for({ 0, i2 });
+        const int stride = m.item_stride();
+
+        for( int x = 0, w = m.width(); x < w; ++x ) {
+            std::swap( *p1, *p2 );
+            p1 += stride;  p2 += stride;
+        }
+    }
+
+    template< class Item >
+    void swap_columns( const int i1, const int i2, const Matrix_view_<Item>& m )
+    {
+        swap_rows( i1, i2, m.transposed() );
+    }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Matrix_view_,
+        d::view_of,
+        d::copy_of,
+        d::swap_rows,
+        d::swap_columns;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -0,0 +1,331 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/collection-util.hpp>                // int_size
+#include <kickstart/core/failure-handling.hpp>              // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>                // Truth
+#include <kickstart/core/language/type-aliases.hpp>         // Size
+#include <kickstart/core/matrices/Abstract_matrix_.hpp>     // two_d_grid
+#include <kickstart/core/matrices/Matrix_.hpp>
+#include <kickstart/core/matrices/Matrix_view_.hpp>
+
+#include <algorithm>        // std::lower_bound
+#include <type_traits>      // std::(is_same_v, remove_const_t)
+#include <vector>           // std::vector
+
+// A `Sparse_matrix_<Item>` stores only the non-zero items of a matrix, in one of the two
+// compressed forms:
+//
+// * `csr`, compressed sparse rows:     the items of each row, in order of increasing x.
+// * `csc`, compressed sparse columns:  the items of each column, in order of increasing y.
+//
+// A row or column is a "line". The items of line i are at indices `starts()[i]` up to
+// `starts()[i + 1]` of `indices()` and `values()`, where `indices()` holds the item's x for
+// `csr` and its y for `csc`.
+//
+// Build a sparse matrix from (x, y, value) triplets, where triplets at the same position are
+// added, or from a `Matrix_` or `Matrix_view_`. `multiply( a, x )` computes a·x for a vector x,
+// and `multiply( a, b )` computes a·b for a dense matrix or view b. There's a multithreaded a·x in
+// `parallel`. For a·x the `csr` form is fastest, since each result item is a sum over one row.
+//
+// The `Item` type needs `+`, `*` and `!=`, where `Item()` is zero.
+
+namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    namespace k = kickstart;
+    using   k::language::Size, k::language::Truth,
+            k::collection_util::int_size;
+    using   std::lower_bound,
+            std::is_same_v, std::remove_const_t,
+            std::vector;
+
+    struct Sparse_layout{ enum Enum{ csr, csc }; };
+
+    template< class Item >
+    struct Triplet_ { int x; int y; Item value; };
+
+    namespace impl::sparse {
+        // Stable counting sort of triplets by a key in the range [0, n_keys).
+        template< class Item, class Key_func >
+        auto counting_sorted( const vector<Triplet_<Item>>& triplets, const int n_keys, const Key_func& key_of )
+            -> vector<Triplet_<Item>>
+        {
+            vector<Size> starts( n_keys + 1, 0 );
+            for( const Triplet_<Item>& t: triplets ) { ++starts[key_of( t ) + 1]; }
+            for( int key = 0; key < n_keys; ++key ) { starts[key + 1] += starts[key]; }
+
+            vector<Triplet_<Item>> result( triplets.size() );
+            for( const Triplet_<Item>& t: triplets ) { result[starts[key_of( t )]++] = t; }
+            return result;
+        }
+    }  // namespace impl::sparse
+
+    template< class Item_type_param >
+    class Sparse_matrix_
+    {
+    public:
+        using Item = Item_type_param;
+
+    private:
+        Sparse_layout::Enum     m_layout;
+        two_d_grid::Size        m_size;
+        vector<Size>            m_starts;           // n_lines() + 1 indices of line starts.
+        vector<int>             m_indices;          // x for `csr`, y for `csc`.
+        vector<Item>            m_values;
+
+        auto is_csr() const -> Truth { return m_layout == Sparse_layout::csr; }
+
+        // The items of `m` that differ from `Item()`, collected row by row in `csr` form.
+        static auto from_items_of( const Matrix_view_<const Item>& m, const Sparse_layout::Enum layout )
+            -> Sparse_matrix_
+        {
+            Sparse_matrix_ result( m.size(), Sparse_layout::csr );
+            const int stride = m.item_stride();
+            for( int y = 0; y < m.height(); ++y ) {
+                result.m_starts[y] = result.n_stored();
+                const Item* const p_row = m.items() + m.items_index_for({ 0, y });
+                for( int x = 0; x < m.width(); ++x ) {
+                    const Item& item = p_row[x*stride];
+                    if( item != Item() ) {
+                        result.m_indices.push_back( x );
+                        result.m_values.push_back( item );
+                    }
+                }
+            }
+            result.m_starts[m.height()] = result.n_stored();
+            if( layout == Sparse_layout::csr ) { return result; }
+            return result.converted_to( layout );
+        }
+
+    public:
+        // An all zero matrix.
+        Sparse_matrix_( const two_d_grid::Size size = {}, const Sparse_layout::Enum layout = Sparse_layout::csr ):
+            m_layout( layout ),
+            m_size( size ),
+            m_starts( (layout == Sparse_layout::csr? size.h : size.w) + 1, 0 )
+        {}
+
+        // Triplets at the same position are added. The triplets can be in any order.
+        Sparse_matrix_(
+            const two_d_grid::Size              size,
+            const vector<Triplet_<Item>>&       triplets,
+            const Sparse_layout::Enum           layout = Sparse_layout::csr
+            ):
+            Sparse_matrix_( size, layout )
+        {
+            for( const Triplet_<Item>& t: triplets ) {
+                hopefully( 0 <= t.x and t.x < size.w and 0 <= t.y and t.y < size.h )
+                    or KS_FAIL_( std_exception::out_of_range, "A triplet's position is outside the matrix." );
+            }
+
+            // Sorting by index and then stably by line gives the lines with increasing indices.
+            const Truth csr = is_csr();
+            const auto line_of  = [csr]( const Triplet_<Item>& t ) -> int { return (csr? t.y : t.x); };
+            const auto index_of = [csr]( const Triplet_<Item>& t ) -> int { return (csr? t.x : t.y); };
+            const vector<Triplet_<Item>> sorted = impl::sparse::counting_sorted(
+                impl::sparse::counting_sorted( triplets, n_indices(), index_of ), n_lines(), line_of
+                );
+
+            m_indices.reserve( sorted.size() );
+            m_values.reserve( sorted.size() );
+            const Size n = Size( sorted.size() );
+            Size i = 0;
+            for( int line = 0; line < n_lines(); ++line ) {
+                m_starts[line] = n_stored();
+                for( ; i < n and line_of( sorted[i] ) == line; ++i ) {
+                    const int index = index_of( sorted[i] );
+                    if( n_stored() > m_starts[line] and m_indices.back() == index ) {
+                        m_values.back() = m_values.back() + sorted[i].value;
+                    } else {
+                        m_indices.push_back( index );
+                        m_values.push_back( sorted[i].value );
+                    }
+                }
+            }
+            m_starts[n_lines()] = n_stored();
+        }
+
+        // Stores the items of `m` that differ from `Item()`. The items are read row by row,
+        // and a `csc` matrix is converted from the `csr` form.
+        explicit Sparse_matrix_( const Matrix_view_<const Item>& m, const Sparse_layout::Enum layout = Sparse_layout::csr ):
+            Sparse_matrix_( from_items_of( m, layout ) )
+        {}
+
+        explicit Sparse_matrix_( const Matrix_<Item>& m, const Sparse_layout::Enum layout = Sparse_layout::csr ):
+            Sparse_matrix_( view_of( m ), layout )
+        {}
+
+        auto layout() const     -> Sparse_layout::Enum  { return m_layout; }
+        auto size() const       -> two_d_grid::Size     { return m_size; }
+        auto width() const      -> int                  { return m_size.w; }
+        auto height() const     -> int                  { return m_size.h; }
+
+        auto n_lines() const    -> int  { return (is_csr()? m_size.h : m_size.w); }
+        auto n_indices() const  -> int  { return (is_csr()? m_size.w : m_size.h); }
+        auto n_stored() const   -> Size { return Size( m_values.size() ); }
+
+        auto starts() const     -> const vector<Size>&  { return m_starts; }
+        auto indices() const    -> const vector<int>&   { return m_indices; }
+        auto values() const     -> const vector<Item>&  { return m_values; }
+
+        // Item (x, y), found by binary search in its line.
+        auto operator()( const int x, const int y ) const
+            -> Item
+        {
+            hopefully( 0 <= x and x < m_size.w and 0 <= y and y < m_size.h )
+                or KS_FAIL_( std_exception::out_of_range, "The position is outside the matrix." );
+            const int line = (is_csr()? y : x);
+            const int index = (is_csr()? x : y);
+            const auto it_beyond = m_indices.begin() + m_starts[line + 1];
+            const auto it = lower_bound( m_indices.begin() + m_starts[line], it_beyond, index );
+            return (it != it_beyond and *it == index? m_values[it - m_indices.begin()] : Item());
+        }
+
+        // The same matrix in the other compressed form, computed by a counting sort.
+        auto converted_to( const Sparse_layout::Enum layout ) const
+            -> Sparse_matrix_
+        {
+            if( layout == m_layout ) { return *this; }
+
+            Sparse_matrix_ result( m_size, layout );
+            vector<Size>& starts = result.m_starts;
+            for( const int index: m_indices ) { ++starts[index + 1]; }
+            for( int i = 0; i < result.n_lines(); ++i ) { starts[i + 1] += starts[i]; }
+
+            result.m_indices.resize( m_indices.size() );
+            result.m_values.resize( m_values.size() );
+            vector<Size> positions( starts.begin(), starts.end() - 1 );
+            for( int line = 0; line < n_lines(); ++line ) {
+                for( Size i = m_starts[line]; i < m_starts[line + 1]; ++i ) {
+                    const Size i_result = positions[m_indices[i]]++;
+                    result.m_indices[i_result] = line;
+                    result.m_values[i_result] = m_values[i];
+                }
+            }
+            return result;
+        }
+
+        auto to_matrix() const
+            -> Matrix_<Item>
+        {
+            Matrix_<Item> result( m_size );
+            for( int line = 0; line < n_lines(); ++line ) {
+                for( Size i = m_starts[line]; i < m_starts[line + 1]; ++i ) {
+                    const int index = m_indices[i];
+                    (is_csr()? result( index, line ) : result( line, index )) = m_values[i];
+                }
+            }
+            return result;
+        }
+    };
+
+    namespace impl::sparse {
+        // Item y of a·x, for a `csr` matrix a.
+        template< class Item >
+        inline auto row_times_vector( const Sparse_matrix_<Item>& a, const int y, const Item* const x )
+            -> Item
+        {
+            const int* const indices = a.indices().data();
+            const Item* const values = a.values().data();
+            Item result = Item();
+            for( Size i = a.starts()[y], i_beyond = a.starts()[y + 1]; i < i_beyond; ++i ) {
+                result = result + values[i]*x[indices[i]];
+            }
+            return result;
+        }
+    }  // namespace impl::sparse
+
+    // Returns a·x, where x has `a.width()` items.
+    template< class Item >
+    auto multiply( const Sparse_matrix_<Item>& a, const vector<Item>& x )
+        -> vector<Item>
+    {
+        hopefully( int_size( x ) == a.width() )
+            or KS_FAIL_( std_exception::invalid_argument, "The size of x differs from the width of a." );
+
+        vector<Item> result( a.height() );
+        if( a.layout() == Sparse_layout::csr ) {
+            for( int y = 0; y < a.height(); ++y ) {
+                result[y] = impl::sparse::row_times_vector( a, y, x.data() );
+            }
+        } else {
+            for( int x_index = 0; x_index < a.width(); ++x_index ) {
+                const Item x_item = x[x_index];
+                for( Size i = a.starts()[x_index]; i < a.starts()[x_index + 1]; ++i ) {
+                    Item& item = result[a.indices()[i]];
+                    item = item + a.values()[i]*x_item;
+                }
+            }
+        }
+        return result;
+    }
+
+    // Returns a·b for a dense matrix b. Each stored item a(k, y) adds a multiple of row k of b
+    // to row y of the result, in a loop over the items of the row. The item type of `b` can
+    // differ from `Item` only in `const`.
+    template< class Item, class B_item >
+    auto multiply( const Sparse_matrix_<Item>& a, const Matrix_view_<B_item>& b )
+        -> Matrix_<Item>
+    {
+        static_assert( is_same_v<remove_const_t<B_item>, Item> );
+        hopefully( a.width() == b.height() )
+            or KS_FAIL_( std_exception::invalid_argument, "The width of a differs from the height of b." );
+
+        const Truth csr = (a.layout() == Sparse_layout::csr);
+        const int w = b.width();
+        const int b_stride = b.item_stride();
+        Matrix_<Item> result( w, a.height() );
+        for( int line = 0; line < a.n_lines(); ++line ) {
+            for( Size i = a.starts()[line]; i < a.starts()[line + 1]; ++i ) {
+                const int index = a.indices()[i];
+                const Item value = a.values()[i];
+                const Item* const p_b_row = b.items() + b.items_index_for({ 0, (csr? index : line) });
+                Item* const p_result_row = result.items() + result.items_index_for({ 0, (csr? line : index) });
+                if( b_stride == 1 ) {
+                    for( int x = 0; x < w; ++x ) { p_result_row[x] = p_result_row[x] + value*p_b_row[x]; }
+                } else {
+                    for( int x = 0; x < w; ++x ) { p_result_row[x] = p_result_row[x] + value*p_b_row[x*b_stride]; }
+                }
+            }
+        }
+        return result;
+    }
+
+    template< class Item >
+    auto multiply( const Sparse_matrix_<Item>& a, const Matrix_<Item>& b )
+        -> Matrix_<Item>
+    { return multiply( a, view_of( b ) ); }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Sparse_layout,
+        d::Triplet_,
+        d::Sparse_matrix_,
+        d::multiply;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -0,0 +1,397 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/failure-handling.hpp>          // hopefully, KS_FAIL_
+#include <kickstart/core/matrices/Abstract_matrix_.hpp> // two_d_grid
+#include <kickstart/core/matrices/Matrix_.hpp>
+#include <kickstart/core/matrices/Matrix_view_.hpp>
+#include <kickstart/core/matrices/multiplication.hpp>
+
+#include <functional>       // std::(plus, minus, multiplies, divides, negate)
+#include <memory>           // std::(make_shared, shared_ptr)
+#include <type_traits>      // std::(decay_t, enable_if_t, false_type, true_type, remove_const_t, ...)
+#include <utility>          // std::move
+
+// Lazy elementwise arithmetic on `Matrix_` and `Matrix_view_` operands. An expression such as
+// `(a - b)*s + c`, where `s` is a number, is just a tree of small objects that refer to the
+// matrices, and no items are computed until the expression is evaluated: by `eval()`, by
+// initializing or assigning a `Matrix_` from it, or by `eval_into( m )` that reuses the buffer
+// of the matrix `m` or writes to the items of the view `m`. The evaluation is one loop over the
+// result items, with all the operations fused in the loop body, so it reads each operand item
+// once and writes each result item once.
+//
+// The operators are `+`, binary and unary `-`, `*` and `/`, where a number operand means a
+// matrix with that value for all items, and where `/` needs a number as one operand. The
+// operations are done in the common type of the items and the number, as for built-in
+// arithmetic, so e.g. `m*0.5` for `int` items computes `m(x, y)*0.5` and converts that to `int`
+// when it's stored. For two matrix operands `*` is the matrix product, which is computed by the
+// cache-blocked `multiply` as soon as the `*` is applied, and the expression then holds the
+// product. Use `elementwise_product( a, b )` for the elementwise product.
+//
+// An expression refers to its matrix operands, so it must be evaluated while they exist.
+
+namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using   std::plus, std::minus, std::multiplies, std::divides, std::negate,
+            std::make_shared, std::shared_ptr,
+            std::decay_t, std::enable_if_t, std::false_type, std::true_type,
+            std::is_arithmetic_v, std::is_base_of_v, std::is_same_v, std::remove_const_t,
+            std::move;
+
+    namespace impl::expressions {
+        struct Expression_tag {};
+
+        template< class Type >
+        struct Is_matrix_: false_type {};
+
+        template< class Item >
+        struct Is_matrix_<Matrix_<Item>>: true_type {};
+
+        template< class Item >
+        struct Is_matrix_<Matrix_view_<Item>>: true_type {};
+
+        // A matrix or a matrix expression.
+        template< class Type >
+        constexpr bool is_operand_ = Is_matrix_<Type>::value or is_base_of_v<Expression_tag, Type>;
+
+        // At least one of the operands is a matrix or expression, and the other is a number.
+        template< class A, class B >
+        constexpr bool is_elementwise_pair_ =
+            (is_operand_<A> and is_operand_<B>)
+            or (is_operand_<A> and is_arithmetic_v<B>)
+            or (is_arithmetic_v<A> and is_operand_<B>);
+
+        template< class A, class B >
+        constexpr bool is_scaling_pair_ =
+            (is_operand_<A> and is_arithmetic_v<B>) or (is_arithmetic_v<A> and is_operand_<B>);
+
+        // The item type of an operand, without the `const` of a `Matrix_view_<const T>`.
+        template< class Operand >
+        using Item_of_ = remove_const_t<typename Operand::Item>;
+
+        template< class A, class B, bool a_is_operand = is_operand_<A> >
+        struct Item_of_pair_ { using T = Item_of_<A>; };
+
+        template< class A, class B >
+        struct Item_of_pair_<A, B, false> { using T = Item_of_<B>; };
+
+        // Number operand, as a row of identical items.
+        template< class Number >
+        struct Scalar_row_
+        {
+            Number value;
+            auto operator[]( int ) const -> Number { return value; }
+        };
+
+        // Row of a view, with `stride` between the items.
+        template< class Item >
+        struct Strided_row_
+        {
+            const Item*     p_first;
+            int             stride;
+            auto operator[]( const int x ) const -> const Item& { return p_first[x*stride]; }
+        };
+
+        template< class Op, class Row >
+        struct Unary_row_
+        {
+            Row row;
+            auto operator[]( const int x ) const { return Op()( row[x] ); }
+        };
+
+        template< class Op, class Left_row, class Right_row >
+        struct Binary_row_
+        {
+            Left_row    left;
+            Right_row   right;
+            auto operator[]( const int x ) const { return Op()( left[x], right[x] ); }
+        };
+    }  // namespace impl::expressions
+
+    // Base of the expression classes, where `Derived` provides `size()` and `row( y )`, with
+    // `row( y )[x]` the value of item (x, y).
+    template< class Derived, class Item_type_param >
+    class Matrix_expression_:
+        public impl::expressions::Expression_tag
+    {
+    public:
+        using Item = Item_type_param;
+
+        auto derived() const -> const Derived& { return static_cast<const Derived&>( *this ); }
+
+        auto width() const  -> int { return derived().size().w; }
+        auto height() const -> int { return derived().size().h; }
+
+        // Computes the items into the view `result`, which must have the size of the
+        // expression. `result` can refer to the items of an operand at the same positions.
+        void eval_into( const Matrix_view_<Item>& result ) const
+        {
+            const two_d_grid::Size size = derived().size();
+            hopefully( result.width() == size.w and result.height() == size.h )
+                or KS_FAIL_( std_exception::invalid_argument, "The result view has a different size." );
+            const int stride = result.item_stride();
+            for( int y = 0; y < size.h; ++y ) {
+                const auto row = derived().row( y );
+                Item* const p_result_row = result.items() + result.items_index_for({ 0, y });
+                if( stride == 1 ) {
+                    for( int x = 0; x < size.w; ++x ) { p_result_row[x] = row[x]; }
+                } else {
+                    for( int x = 0; x < size.w; ++x ) { p_result_row[x*stride] = row[x]; }
+                }
+            }
+        }
+
+        // Computes the items into `result`, which is resized, with its row layout, unless it
+        // has the right size. `result` can be an operand of the expression.
+        void eval_into( Matrix_<Item>& result ) const
+        {
+            const two_d_grid::Size size = derived().size();
+            if( result.width() != size.w or result.height() != size.h ) {
+                result = Matrix_<Item>( size, result.layout() );
+            }
+            eval_into( view_of( result ) );
+        }
+
+        auto eval() const
+            -> Matrix_<Item>
+        {
+            Matrix_<Item> result( derived().size() );
+            eval_into( result );
+            return result;
+        }
+
+        operator Matrix_<Item>() const { return eval(); }
+    };
+
+    namespace impl::expressions {
+        template< class Item >
+        class Matrix_operand_:
+            public Matrix_expression_<Matrix_operand_<Item>, Item>
+        {
+            const Matrix_<Item>*    m_p_matrix;
+
+        public:
+            explicit Matrix_operand_( const Matrix_<Item>& m ): m_p_matrix( &m ) {}
+
+            auto matrix() const -> const Matrix_<Item>& { return *m_p_matrix; }
+            auto size() const   -> two_d_grid::Size     { return m_p_matrix->size(); }
+
+            auto row( const int y ) const
+                -> const Item*
+            { return m_p_matrix->items() + m_p_matrix->items_index_for({ 0, y }); }
+        };
+
+        template< class Item >
+        class View_operand_:
+            public Matrix_expression_<View_operand_<Item>, Item>
+        {
+            Matrix_view_<const Item>    m_view;
+
+        public:
+            explicit View_operand_( const Matrix_view_<const Item>& view ): m_view( view ) {}
+
+            auto view() const   -> const Matrix_view_<const Item>&  { return m_view; }
+            auto size() const   -> two_d_grid::Size                 { return m_view.size(); }
+
+            auto row( const int y ) const
+                -> Strided_row_<Item>
+            { return { m_view.items() + m_view.items_index_for({ 0, y }), m_view.item_stride() }; }
+        };
+
+        // Number operand. The operations with its value are done in the common type.
+        template< class Number >
+        struct Scalar_operand_
+        {
+            Number value;
+            auto row( int ) const -> Scalar_row_<Number> { return Scalar_row_<Number>{ value }; }
+        };
+
+        template< class Item >
+        inline auto as_operand( const Matrix_<Item>& m ) -> Matrix_operand_<Item> { return Matrix_operand_<Item>( m ); }
+
+        template< class Item >
+        inline auto as_operand( const Matrix_view_<Item>& view )
+            -> View_operand_<remove_const_t<Item>>
+        { return View_operand_<remove_const_t<Item>>( view ); }
+
+        template< class Derived, class Item >
+        inline auto as_operand( const Matrix_expression_<Derived, Item>& e ) -> const Derived& { return e.derived(); }
+
+        template< class Number, class = enable_if_t<is_arithmetic_v<Number>> >
+        inline auto as_operand( const Number& value ) -> Scalar_operand_<Number> { return { value }; }
+
+        // A view of the items of an expression, which is evaluated into `storage` unless it
+        // refers to existing items.
+        template< class Item >
+        inline auto as_view( const Matrix_operand_<Item>& e, Matrix_<Item>& )
+            -> Matrix_view_<const Item>
+        { return view_of( e.matrix() ); }
+
+        template< class Item >
+        inline auto as_view( const View_operand_<Item>& e, Matrix_<Item>& )
+            -> Matrix_view_<const Item>
+        { return e.view(); }
+
+        template< class Derived, class Item >
+        inline auto as_view( const Matrix_expression_<Derived, Item>& e, Matrix_<Item>& storage )
+            -> Matrix_view_<const Item>
+        {
+            e.eval_into( storage );
+            return view_of( storage );
+        }
+
+        template< class Op, class Operand >
+        class Unary_:
+            public Matrix_expression_<Unary_<Op, Operand>, typename Operand::Item>
+        {
+            Operand     m_operand;
+
+        public:
+            explicit Unary_( Operand operand ): m_operand( move( operand ) ) {}
+
+            auto size() const -> two_d_grid::Size { return m_operand.size(); }
+
+            auto row( const int y ) const
+                -> Unary_row_<Op, decltype( m_operand.row( y ) )>
+            { return { m_operand.row( y ) }; }
+        };
+
+        template< class Op, class Left, class Right, class Item >
+        class Binary_:
+            public Matrix_expression_<Binary_<Op, Left, Right, Item>, Item>
+        {
+            Left        m_left;
+            Right       m_right;
+
+        public:
+            Binary_( Left left, Right right ):
+                m_left( move( left ) ),
+                m_right( move( right ) )
+            {
+                if constexpr( is_operand_<Left> and is_operand_<Right> ) {
+                    const two_d_grid::Size left_size = m_left.size();
+                    const two_d_grid::Size right_size = m_right.size();
+                    hopefully( left_size.w == right_size.w and left_size.h == right_size.h )
+                        or KS_FAIL_( std_exception::invalid_argument, "The operands have different sizes." );
+                }
+            }
+
+            auto size() const
+                -> two_d_grid::Size
+            {
+                if constexpr( is_operand_<Left> ) { return m_left.size(); } else { return m_right.size(); }
+            }
+
+            auto row( const int y ) const
+                -> Binary_row_<Op, decltype( m_left.row( y ) ), decltype( m_right.row( y ) )>
+            { return { m_left.row( y ), m_right.row( y ) }; }
+        };
+
+        // A matrix product, computed on construction. Copies of the expression share the result.
+        template< class Item >
+        class Product_:
+            public Matrix_expression_<Product_<Item>, Item>
+        {
+            shared_ptr<const Matrix_<Item>>    m_p_result;
+
+        public:
+            Product_( const Matrix_view_<const Item>& a, const Matrix_view_<const Item>& b ):
+                m_p_result( make_shared<const Matrix_<Item>>( multiply( a, b ) ) )
+            {}
+
+            auto matrix() const -> const Matrix_<Item>& { return *m_p_result; }
+            auto size() const   -> two_d_grid::Size     { return m_p_result->size(); }
+
+            auto row( const int y ) const
+                -> const Item*
+            { return m_p_result->items() + m_p_result->items_index_for({ 0, y }); }
+        };
+
+        template< class Item >
+        inline auto as_view( const Product_<Item>& e, Matrix_<Item>& )
+            -> Matrix_view_<const Item>
+        { return view_of( e.matrix() ); }
+
+        template< class Op, class A, class B >
+        inline auto elementwise_( const A& a, const B& b )
+        {
+            using Item = typename Item_of_pair_<A, B>::T;
+            if constexpr( is_operand_<A> and is_operand_<B> ) {
+                static_assert( is_same_v<Item, Item_of_<B>>, "The operands have different item types." );
+            }
+            using Left = decay_t<decltype( as_operand( a ) )>;
+            using Right = decay_t<decltype( as_operand( b ) )>;
+            return Binary_<Op, Left, Right, Item>( as_operand( a ), as_operand( b ) );
+        }
+    }  // namespace impl::expressions
+
+    template< class A, class B, class = enable_if_t<impl::expressions::is_elementwise_pair_<A, B>> >
+    inline auto operator+( const A& a, const B& b ) { return impl::expressions::elementwise_<plus<>>( a, b ); }
+
+    template< class A, class B, class = enable_if_t<impl::expressions::is_elementwise_pair_<A, B>> >
+    inline auto operator-( const A& a, const B& b ) { return impl::expressions::elementwise_<minus<>>( a, b ); }
+
+    template< class A, class = enable_if_t<impl::expressions::is_operand_<A>> >
+    inline auto operator-( const A& a )
+    {
+        using Operand = decay_t<decltype( impl::expressions::as_operand( a ) )>;
+        return impl::expressions::Unary_<negate<>, Operand>( impl::expressions::as_operand( a ) );
+    }
+
+    // The matrix product for two matrix operands, otherwise the items times the number.
+    template< class A, class B, class = enable_if_t<impl::expressions::is_elementwise_pair_<A, B>> >
+    inline auto operator*( const A& a, const B& b )
+    {
+        using namespace impl::expressions;
+        if constexpr( is_operand_<A> and is_operand_<B> ) {
+            using Item = Item_of_<A>;
+            static_assert( is_same_v<Item, Item_of_<B>>, "The operands have different item types." );
+            Matrix_<Item> a_storage;
+            Matrix_<Item> b_storage;
+            return Product_<Item>( as_view( as_operand( a ), a_storage ), as_view( as_operand( b ), b_storage ) );
+        } else {
+            return elementwise_<multiplies<>>( a, b );
+        }
+    }
+
+    template< class A, class B, class = enable_if_t<impl::expressions::is_scaling_pair_<A, B>> >
+    inline auto operator/( const A& a, const B& b ) { return impl::expressions::elementwise_<divides<>>( a, b ); }
+
+    template< class A, class B, class = enable_if_t<impl::expressions::is_operand_<A> and impl::expressions::is_operand_<B>> >
+    inline auto elementwise_product( const A& a, const B& b ) { return impl::expressions::elementwise_<multiplies<>>( a, b ); }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Matrix_expression_,
+        d::operator+,
+        d::operator-,
+        d::operator*,
+        d::operator/,
+        d::elementwise_product;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -0,0 +1,505 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/failure-handling.hpp>          // hopefully, KS_FAIL_
+#include <kickstart/core/matrices/Matrix_.hpp>
+#include <kickstart/core/matrices/Matrix_view_.hpp>
+
+#include <stdint.h>         // int32_t
+
+#include <algorithm>        // std::(max, min)
+#include <type_traits>      // std::(is_same_v, remove_const_t)
+#include <utility>          // std::(integer_sequence, make_integer_sequence)
+#include <vector>           // std::vector
+
+#if defined( __AVX2__ ) || defined( __AVX512F__ )
+#   include <immintrin.h>
+#elif defined( __ARM_NEON )
+#   include <arm_neon.h>
+#endif
+
+// Matrix multiplication: `multiply( a, b )` produces a·b, and `multiply_add( a, b, c )` adds
+// a·b to c. Blocks of a and b that fit in respectively the L2 and the L1 cache are copied to
+// contiguous "packed" buffers, and a micro-kernel computes one small tile of the result at a
+// time from those buffers, with all the tile's sums kept in registers.
+//
+// For `float`, `double` and `int32_t` items the micro-kernel uses AVX-512, AVX2 or NEON
+// instructions, as available at compile time, e.g. with g++ option `-march=native`. Otherwise
+// it's scalar code that works for any `Item` type with `+` and `*`, where `Item()` is zero.
+
+namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using   std::max, std::min,
+            std::is_same_v, std::remove_const_t,
+            std::integer_sequence, std::make_integer_sequence,
+            std::vector;
+
+    namespace impl::multiplication {
+        // Vector operations for the micro-kernel. This general version is the scalar fallback,
+        // with one item per "vector" and a tile of 4×4 items.
+        template< class Item >
+        struct Simd_
+        {
+            using Vector = Item;
+            static constexpr int width          = 1;
+            static constexpr int tile_height    = 4;
+            static constexpr int tile_vectors   = 4;
+
+            static auto zero() -> Vector                        { return Item(); }
+            static auto broadcast( const Item value ) -> Vector { return value; }
+            static auto load( const Item* p ) -> Vector         { return *p; }
+            static void store( Item* p, const Vector& v )       { *p = v; }
+
+            static auto sum( const Vector& a, const Vector& b ) -> Vector { return a + b; }
+
+            static auto multiply_add( const Vector& a, const Vector& b, const Vector& c )
+                -> Vector
+            { return a*b + c; }
+        };
+
+        // With 16 or more vector registers a tile of 6×2 vectors leaves room for the two
+        // vectors from b and the broadcast item from a.
+        struct Vector_tile_shape
+        {
+            static constexpr int tile_height    = 6;
+            static constexpr int tile_vectors   = 2;
+        };
+
+        #if defined( __AVX512F__ )
+            template<>
+            struct Simd_<float>: Vector_tile_shape
+            {
+                using Vector = __m512;
+                static constexpr int width = 16;
+
+                static auto zero() -> Vector                            { return _mm512_setzero_ps(); }
+                static auto broadcast( const float value ) -> Vector    { return _mm512_set1_ps( value ); }
+                static auto load( const float* p ) -> Vector            { return _mm512_loadu_ps( p ); }
+                static void store( float* p, const Vector v )           { _mm512_storeu_ps( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm512_add_ps( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return _mm512_fmadd_ps( a, b, c ); }
+            };
+
+            template<>
+            struct Simd_<double>: Vector_tile_shape
+            {
+                using Vector = __m512d;
+                static constexpr int width = 8;
+
+                static auto zero() -> Vector                            { return _mm512_setzero_pd(); }
+                static auto broadcast( const double value ) -> Vector   { return _mm512_set1_pd( value ); }
+                static auto load( const double* p ) -> Vector           { return _mm512_loadu_pd( p ); }
+                static void store( double* p, const Vector v )          { _mm512_storeu_pd( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm512_add_pd( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return _mm512_fmadd_pd( a, b, c ); }
+            };
+
+            template<>
+            struct Simd_<int32_t>: Vector_tile_shape
+            {
+                using Vector = __m512i;
+                static constexpr int width = 16;
+
+                static auto zero() -> Vector                            { return _mm512_setzero_si512(); }
+                static auto broadcast( const int32_t value ) -> Vector  { return _mm512_set1_epi32( value ); }
+                static auto load( const int32_t* p ) -> Vector          { return _mm512_loadu_si512( p ); }
+                static void store( int32_t* p, const Vector v )         { _mm512_storeu_si512( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm512_add_epi32( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return _mm512_add_epi32( _mm512_mullo_epi32( a, b ), c ); }
+            };
+        #elif defined( __AVX2__ )
+            template<>
+            struct Simd_<float>: Vector_tile_shape
+            {
+                using Vector = __m256;
+                static constexpr int width = 8;
+
+                static auto zero() -> Vector                            { return _mm256_setzero_ps(); }
+                static auto broadcast( const float value ) -> Vector    { return _mm256_set1_ps( value ); }
+                static auto load( const float* p ) -> Vector            { return _mm256_loadu_ps( p ); }
+                static void store( float* p, const Vector v )           { _mm256_storeu_ps( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm256_add_ps( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                {
+                    #ifdef __FMA__
+                        return _mm256_fmadd_ps( a, b, c );
+                    #else
+                        return _mm256_add_ps( _mm256_mul_ps( a, b ), c );
+                    #endif
+                }
+            };
+
+            template<>
+            struct Simd_<double>: Vector_tile_shape
+            {
+                using Vector = __m256d;
+                static constexpr int width = 4;
+
+                static auto zero() -> Vector                            { return _mm256_setzero_pd(); }
+                static auto broadcast( const double value ) -> Vector   { return _mm256_set1_pd( value ); }
+                static auto load( const double* p ) -> Vector           { return _mm256_loadu_pd( p ); }
+                static void store( double* p, const Vector v )          { _mm256_storeu_pd( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm256_add_pd( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                {
+                    #ifdef __FMA__
+                        return _mm256_fmadd_pd( a, b, c );
+                    #else
+                        return _mm256_add_pd( _mm256_mul_pd( a, b ), c );
+                    #endif
+                }
+            };
+
+            template<>
+            struct Simd_<int32_t>: Vector_tile_shape
+            {
+                using Vector = __m256i;
+                static constexpr int width = 8;
+
+                static auto zero() -> Vector                            { return _mm256_setzero_si256(); }
+                static auto broadcast( const int32_t value ) -> Vector  { return _mm256_set1_epi32( value ); }
+
+                static auto load( const int32_t* p )
+                    -> Vector
+                { return _mm256_loadu_si256( reinterpret_cast<const __m256i*>( p ) ); }
+
+                static void store( int32_t* p, const Vector v )
+                {
+                    _mm256_storeu_si256( reinterpret_cast<__m256i*>( p ), v );
+                }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return _mm256_add_epi32( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return _mm256_add_epi32( _mm256_mullo_epi32( a, b ), c ); }
+            };
+        #elif defined( __ARM_NEON )
+            template<>
+            struct Simd_<float>: Vector_tile_shape
+            {
+                using Vector = float32x4_t;
+                static constexpr int width = 4;
+
+                static auto zero() -> Vector                            { return vdupq_n_f32( 0 ); }
+                static auto broadcast( const float value ) -> Vector    { return vdupq_n_f32( value ); }
+                static auto load( const float* p ) -> Vector            { return vld1q_f32( p ); }
+                static void store( float* p, const Vector v )           { vst1q_f32( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return vaddq_f32( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return vmlaq_f32( c, a, b ); }
+            };
+
+            #ifdef __aarch64__      // 64-bit ARM, which has vectors of `double`.
+                template<>
+                struct Simd_<double>: Vector_tile_shape
+                {
+                    using Vector = float64x2_t;
+                    static constexpr int width = 2;
+
+                    static auto zero() -> Vector                            { return vdupq_n_f64( 0 ); }
+                    static auto broadcast( const double value ) -> Vector   { return vdupq_n_f64( value ); }
+                    static auto load( const double* p ) -> Vector           { return vld1q_f64( p ); }
+                    static void store( double* p, const Vector v )          { vst1q_f64( p, v ); }
+
+                    static auto sum( const Vector a, const Vector b ) -> Vector { return vaddq_f64( a, b ); }
+
+                    static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                        -> Vector
+                    { return vfmaq_f64( c, a, b ); }
+                };
+            #endif
+
+            template<>
+            struct Simd_<int32_t>: Vector_tile_shape
+            {
+                using Vector = int32x4_t;
+                static constexpr int width = 4;
+
+                static auto zero() -> Vector                            { return vdupq_n_s32( 0 ); }
+                static auto broadcast( const int32_t value ) -> Vector  { return vdupq_n_s32( value ); }
+                static auto load( const int32_t* p ) -> Vector          { return vld1q_s32( p ); }
+                static void store( int32_t* p, const Vector v )         { vst1q_s32( p, v ); }
+
+                static auto sum( const Vector a, const Vector b ) -> Vector { return vaddq_s32( a, b ); }
+
+                static auto multiply_add( const Vector a, const Vector b, const Vector c )
+                    -> Vector
+                { return vmlaq_s32( c, a, b ); }
+            };
+        #endif
+
+        // Sizes of the tiles that the micro-kernel computes, and of the blocks of a and b that
+        // are packed. A `block_depth` × `tile_width` sliver of b should stay in L1 while it's
+        // used with all the slivers of a `block_height` × `block_depth` block of a, in L2.
+        template< class Item >
+        struct Blocking_
+        {
+            using Simd = Simd_<Item>;
+
+            static constexpr int tile_height    = Simd::tile_height;
+            static constexpr int tile_width     = Simd::tile_vectors*Simd::width;
+
+            static constexpr int block_depth    = min( 384, max<int>( 64, 16*1024/(tile_width*sizeof( Item )) ) );
+            static constexpr int block_height   = tile_height*max<int>( 1, 128*1024/(block_depth*sizeof( Item )*tile_height) );
+            static constexpr int panel_width    = tile_width*max<int>( 1, 4096/tile_width );
+        };
+
+        // Copies the block `a` to `packed`, as slivers of `tile_height` rows stored column by
+        // column. The last sliver is padded with zeroes.
+        template< class Item >
+        void pack_a( const Matrix_view_<const Item>& a, Item* packed )
+        {
+            constexpr int tile_height = Blocking_<Item>::tile_height;
+            const int h = a.height();
+            const int depth = a.width();
+            for( int i_first = 0; i_first < h; i_first += tile_height ) {
+                const int n_rows = min( tile_height, h - i_first );
+                for( int k = 0; k < depth; ++k ) {
+                    for( int i = 0; i < tile_height; ++i ) {
+                        *packed++ = (i < n_rows? a( k, i_first + i ) : Item());
+                    }
+                }
+            }
+        }
+
+        // Copies the block `b` to `packed`, as slivers of `tile_width` columns stored row by
+        // row. The last sliver is padded with zeroes.
+        template< class Item >
+        void pack_b( const Matrix_view_<const Item>& b, Item* packed )
+        {
+            constexpr int tile_width = Blocking_<Item>::tile_width;
+            const int depth = b.height();
+            const int w = b.width();
+            for( int j_first = 0; j_first < w; j_first += tile_width ) {
+                const int n_columns = min( tile_width, w - j_first );
+                for( int k = 0; k < depth; ++k ) {
+                    for( int j = 0; j < tile_width; ++j ) {
+                        *packed++ = (j < n_columns? b( j_first + j, k ) : Item());
+                    }
+                }
+            }
+        }
+
+        template< class Func, int... indices >
+        inline void unrolled_for_( const Func& f, integer_sequence<int, indices...> )
+        {
+            (f( indices ), ...);
+        }
+
+        // Calls `f( i )` for i = 0, 1, ... `n` - 1, as `n` separate calls in the code.
+        template< int n, class Func >
+        inline void unrolled_for_( const Func& f )
+        {
+            unrolled_for_( f, make_integer_sequence<int, n>() );
+        }
+
+        // The micro-kernel. Adds the product of a packed sliver of a and a packed sliver of b,
+        // a tile of `tile_height` × `tile_width` items, to `c`, which can be a smaller part of
+        // the tile at the right or bottom edge of the result.
+        template< class Item >
+        void add_tile_product(
+            const int                   depth,
+            const Item*                 a,
+            const Item*                 b,
+            const Matrix_view_<Item>&   c
+            )
+        {
+            using Simd = Simd_<Item>;
+            using Vector = typename Simd::Vector;
+            constexpr int tile_height   = Blocking_<Item>::tile_height;
+            constexpr int tile_width    = Blocking_<Item>::tile_width;
+            constexpr int n_vectors     = Simd::tile_vectors;
+
+            // The loops over the tile are unrolled so that the sums can be held in registers.
+            Vector sums[tile_height][n_vectors];
+            unrolled_for_<tile_height>( [&]( const int i ) {
+                unrolled_for_<n_vectors>( [&]( const int j ) { sums[i][j] = Simd::zero(); } );
+            } );
+
+            for( int k = 0; k < depth; ++k ) {
+                Vector b_vectors[n_vectors];
+                unrolled_for_<n_vectors>( [&]( const int j ) { b_vectors[j] = Simd::load( b + j*Simd::width ); } );
+                unrolled_for_<tile_height>( [&]( const int i ) {
+                    const Vector a_items = Simd::broadcast( a[i] );
+                    unrolled_for_<n_vectors>( [&]( const int j ) {
+                        sums[i][j] = Simd::multiply_add( a_items, b_vectors[j], sums[i][j] );
+                    } );
+                } );
+                a += tile_height;  b += tile_width;
+            }
+
+            if( c.height() == tile_height and c.width() == tile_width and c.has_contiguous_rows() ) {
+                for( int i = 0; i < tile_height; ++i ) {
+                    Item* const p_row = c.items() + c.items_index_for({ 0, i });
+                    for( int j = 0; j < n_vectors; ++j ) {
+                        Item* const p = p_row + j*Simd::width;
+                        Simd::store( p, Simd::sum( Simd::load( p ), sums[i][j] ) );
+                    }
+                }
+            } else {
+                Item tile[tile_height][tile_width];
+                for( int i = 0; i < tile_height; ++i ) {
+                    for( int j = 0; j < n_vectors; ++j ) { Simd::store( tile[i] + j*Simd::width, sums[i][j] ); }
+                }
+                for( int i = 0; i < c.height(); ++i ) {
+                    for( int j = 0; j < c.width(); ++j ) { c( j, i ) = c( j, i ) + tile[i][j]; }
+                }
+            }
+        }
+
+        // Adds a·b to c, where the sizes are known to fit.
+        template< class Item >
+        void multiply_add_items(
+            const Matrix_view_<const Item>&     a,
+            const Matrix_view_<const Item>&     b,
+            const Matrix_view_<Item>&           c
+            )
+        {
+            using Blocking = Blocking_<Item>;
+            constexpr int tile_height   = Blocking::tile_height;
+            constexpr int tile_width    = Blocking::tile_width;
+            const int h = c.height();
+            const int w = c.width();
+            const int depth = a.width();
+            if( h == 0 or w == 0 or depth == 0 ) { return; }
+
+            const auto rounded_up = []( const int n, const int m ) -> int { return m*((n + m - 1)/m); };
+            const int max_block_height  = min( Blocking::block_height, rounded_up( h, tile_height ) );
+            const int max_block_depth   = min( Blocking::block_depth, depth );
+            const int max_panel_width   = min( Blocking::panel_width, rounded_up( w, tile_width ) );
+            vector<Item> packed_a( max_block_height*max_block_depth );
+            vector<Item> packed_b( max_block_depth*max_panel_width );
+
+            for( int j_panel = 0; j_panel < w; j_panel += Blocking::panel_width ) {
+                const int panel_width = min( Blocking::panel_width, w - j_panel );
+                for( int k_block = 0; k_block < depth; k_block += Blocking::block_depth ) {
+                    const int block_depth = min( Blocking::block_depth, depth - k_block );
+                    pack_b( b.sub_view( {j_panel, k_block}, {panel_width, block_depth} ), packed_b.data() );
+
+                    for( int i_block = 0; i_block < h; i_block += Blocking::block_height ) {
+                        const int block_height = min( Blocking::block_height, h - i_block );
+                        pack_a( a.sub_view( {k_block, i_block}, {block_depth, block_height} ), packed_a.data() );
+
+                        for( int j = 0; j < panel_width; j += tile_width ) {
+                            for( int i = 0; i < block_height; i += tile_height ) {
+                                const two_d_grid::Size tile_size =
+                                    {min( tile_width, panel_width - j ), min( tile_height, block_height - i )};
+                                add_tile_product(
+                                    block_depth,
+                                    packed_a.data() + i*block_depth,
+                                    packed_b.data() + j*block_depth,
+                                    c.sub_view( {j_panel + j, i_block + i}, tile_size )
+                                    );
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        template< class Item >
+        void check_product_sizes(
+            const Matrix_view_<const Item>&     a,
+            const Matrix_view_<const Item>&     b,
+            const Matrix_view_<Item>&           c
+            )
+        {
+            hopefully( a.width() == b.height() )
+                or KS_FAIL_( std_exception::invalid_argument, "The width of a differs from the height of b." );
+            hopefully( c.height() == a.height() and c.width() == b.width() )
+                or KS_FAIL_( std_exception::invalid_argument, "The size of c differs from the size of a·b." );
+        }
+    }  // namespace impl::multiplication
+
+    // Adds a·b to c. The items of c can't be items of a or b. The item types of the views can
+    // differ only in `const`.
+    template< class A_item, class B_item, class Item >
+    void multiply_add( const Matrix_view_<A_item>& a, const Matrix_view_<B_item>& b, const Matrix_view_<Item>& c )
+    {
+        static_assert( is_same_v<remove_const_t<A_item>, Item> and is_same_v<remove_const_t<B_item>, Item> );
+        const Matrix_view_<const Item> const_a = a;
+        const Matrix_view_<const Item> const_b = b;
+        impl::multiplication::check_product_sizes( const_a, const_b, c );
+        impl::multiplication::multiply_add_items( const_a, const_b, c );
+    }
+
+    template< class Item >
+    void multiply_add( const Matrix_<Item>& a, const Matrix_<Item>& b, Matrix_<Item>& c )
+    {
+        hopefully( &c != &a and &c != &b )
+            or KS_FAIL_( std_exception::invalid_argument, "The result matrix c is also an operand." );
+        multiply_add( view_of( a ), view_of( b ), view_of( c ) );
+    }
+
+    template< class A_item, class B_item >
+    auto multiply( const Matrix_view_<A_item>& a, const Matrix_view_<B_item>& b )
+        -> Matrix_<remove_const_t<A_item>>
+    {
+        using Item = remove_const_t<A_item>;
+        static_assert( is_same_v<remove_const_t<B_item>, Item> );
+        hopefully( a.width() == b.height() )
+            or KS_FAIL_( std_exception::invalid_argument, "The width of a differs from the height of b." );
+
+        Matrix_<Item> result( b.width(), a.height() );
+        impl::multiplication::multiply_add_items<Item>( a, b, view_of( result ) );
+        return result;
+    }
+
+    template< class Item >
+    auto multiply( const Matrix_<Item>& a, const Matrix_<Item>& b )
+        -> Matrix_<Item>
+    { return multiply( view_of( a ), view_of( b ) ); }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::multiply,
+        d::multiply_add;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -0,0 +1,270 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/failure-handling.hpp>          // hopefully, KS_FAIL_
+#include <kickstart/core/language/type-aliases.hpp>     // Size
+#include <kickstart/core/matrices/Matrix_.hpp>
+#include <kickstart/core/matrices/Matrix_view_.hpp>
+#include <kickstart/core/matrices/Sparse_matrix_.hpp>
+#include <kickstart/core/matrices/multiplication.hpp>
+#include <kickstart/core/matrices/thread-pool.hpp>
+
+#include <algorithm>        // std::(max, min, sort)
+#include <mutex>            // std::(mutex, lock_guard)
+#include <type_traits>      // std::(decay_t, invoke_result_t, is_same_v, remove_const_t)
+#include <utility>          // std::pair
+#include <vector>           // std::vector
+
+// Multithreaded versions of elementwise map, reduction, transposition and multiplication, and
+// of sparse matrix times vector, that run on `Thread_pool::singleton()`. The dense operations
+// accept both `Matrix_` and `Matrix_view_` arguments. Set the number of threads via the pool.
+// Each operation takes a `grain_size`, the maximum number of rows that a thread processes as
+// one task, where the default 0 means a suitable number. The rows are split in halves until
+// the parts are no larger, so a task has from about half to all of `grain_size` rows. An
+// operation that works on blocks of rows rounds `grain_size` down to whole blocks, but uses at
+// least one block per task.
+
+namespace kickstart::matrices::_definitions::parallel {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using   kickstart::language::Size;
+    using   std::max, std::min, std::sort,
+            std::mutex, std::lock_guard,
+            std::decay_t, std::invoke_result_t, std::is_same_v, std::remove_const_t,
+            std::pair,
+            std::vector;
+
+    // Returns the matrix of `f( item )` for each item of `m`.
+    template< class Item, class Func >
+    auto map( const Matrix_view_<Item>& m, const Func& f, const int grain_size = 0 )
+        -> Matrix_<decay_t<invoke_result_t<const Func&, Item&>>>
+    {
+        using Result_item = decay_t<invoke_result_t<const Func&, Item&>>;
+        Matrix_<Result_item> result( m.size() );
+        const int w = m.width();
+        const int stride = m.item_stride();
+        Thread_pool::singleton().for_each_range( m.height(), grain_size, [&]( const Size y_first, const Size y_beyond )
+        {
+            for( int y = int( y_first ); y < y_beyond; ++y ) {
+                Item* const p_row = m.items() + m.items_index_for({ 0, y });
+                Result_item* const p_result_row = result.items() + result.items_index_for({ 0, y });
+                for( int x = 0; x < w; ++x ) { p_result_row[x] = f( p_row[x*stride] ); }
+            }
+        } );
+        return result;
+    }
+
+    template< class Item, class Func >
+    auto map( const Matrix_<Item>& m, const Func& f, const int grain_size = 0 )
+        -> Matrix_<decay_t<invoke_result_t<const Func&, const Item&>>>
+    { return parallel::map( view_of( m ), f, grain_size ); }
+
+    // Returns `initial` combined with all the items of `m`. The items are combined in order
+    // within the range of rows of each task, and then the range results are combined in order,
+    // so `combine` must be associative but needs not be commutative.
+    template< class Item, class Combine >
+    auto reduce(
+        const Matrix_view_<Item>&       m,
+        const remove_const_t<Item>&     initial,
+        const Combine&                  combine,
+        const int                       grain_size = 0
+        ) -> remove_const_t<Item>
+    {
+        using Result = remove_const_t<Item>;
+        const int w = m.width();
+        const int h = m.height();
+        if( w == 0 or h == 0 ) { return initial; }
+
+        // The range results, with the first row of each range, are collected in any order.
+        const int stride = m.item_stride();
+        vector<pair<int, Result>> range_results;
+        mutex results_mutex;
+        Thread_pool::singleton().for_each_range( h, grain_size, [&]( const Size y_first, const Size y_beyond )
+        {
+            Result result = m( 0, int( y_first ) );
+            for( int y = int( y_first ); y < y_beyond; ++y ) {
+                Item* const p_row = m.items() + m.items_index_for({ 0, y });
+                for( int x = (y == y_first? 1 : 0); x < w; ++x ) { result = combine( result, p_row[x*stride] ); }
+            }
+            const lock_guard<mutex> lock( results_mutex );
+            range_results.emplace_back( int( y_first ), result );
+        } );
+
+        sort( range_results.begin(), range_results.end(),
+            []( const pair<int, Result>& a, const pair<int, Result>& b ) -> bool { return a.first < b.first; }
+            );
+        Result result = initial;
+        for( const pair<int, Result>& range_result: range_results ) { result = combine( result, range_result.second ); }
+        return result;
+    }
+
+    template< class Item, class Combine >
+    auto reduce(
+        const Matrix_<Item>&            m,
+        const remove_const_t<Item>&     initial,
+        const Combine&                  combine,
+        const int                       grain_size = 0
+        ) -> Item
+    { return parallel::reduce( view_of( m ), initial, combine, grain_size ); }
+
+    // Returns a transposed copy of `m`, copied in square tiles so that both the reading and the
+    // writing mostly stay within cache lines. For a transposition without copying, see
+    // `Matrix_view_::transposed`.
+    template< class Item >
+    auto transpose( const Matrix_view_<Item>& m, const int grain_size = 0 )
+        -> Matrix_<remove_const_t<Item>>
+    {
+        constexpr int tile_size = 32;
+        const int w = m.width();
+        const int h = m.height();
+        Matrix_<remove_const_t<Item>> result( h, w );
+
+        const int n_tile_rows = (h + tile_size - 1)/tile_size;
+        const int grain_in_tile_rows = (grain_size > 0? max( 1, grain_size/tile_size ) : 0);
+        Thread_pool::singleton().for_each_range( n_tile_rows, grain_in_tile_rows, [&]( const Size i_first, const Size i_beyond )
+        {
+            for( int i_tile_row = int( i_first ); i_tile_row < i_beyond; ++i_tile_row ) {
+                const int y_first = i_tile_row*tile_size;
+                const int y_beyond = min( h, y_first + tile_size );
+                for( int x_first = 0; x_first < w; x_first += tile_size ) {
+                    const int x_beyond = min( w, x_first + tile_size );
+                    for( int y = y_first; y < y_beyond; ++y ) {
+                        for( int x = x_first; x < x_beyond; ++x ) { result( y, x ) = m( x, y ); }
+                    }
+                }
+            }
+        } );
+        return result;
+    }
+
+    template< class Item >
+    auto transpose( const Matrix_<Item>& m, const int grain_size = 0 )
+        -> Matrix_<Item>
+    { return parallel::transpose( view_of( m ), grain_size ); }
+
+    // Adds a·b to c, with tasks that each compute a block of c. The items of c can't be items
+    // of a or b. The item types of the views can differ only in `const`.
+    template< class A_item, class B_item, class Item >
+    void multiply_add(
+        const Matrix_view_<A_item>&     a,
+        const Matrix_view_<B_item>&     b,
+        const Matrix_view_<Item>&       c,
+        const int                       grain_size = 0
+        )
+    {
+        using Blocking = _definitions::impl::multiplication::Blocking_<Item>;
+        static_assert( is_same_v<remove_const_t<A_item>, Item> and is_same_v<remove_const_t<B_item>, Item> );
+        const Matrix_view_<const Item> const_a = a;
+        const Matrix_view_<const Item> const_b = b;
+        _definitions::impl::multiplication::check_product_sizes( const_a, const_b, c );
+
+        // Blocks of 256 columns, a multiple of every tile width, give enough tasks also for
+        // a result with few rows.
+        const int block_width = 256;
+        const int block_height = (grain_size > 0?
+            Blocking::tile_height*max( 1, grain_size/Blocking::tile_height ) : Blocking::block_height
+            );
+        const int h = c.height();
+        const int w = c.width();
+        const int depth = a.width();
+        const int n_block_rows = (h + block_height - 1)/block_height;
+        const int n_block_columns = (w + block_width - 1)/block_width;
+        Thread_pool::singleton().for_each_range( Size( n_block_rows )*n_block_columns, 1, [&]( const Size i_first, const Size i_beyond )
+        {
+            for( Size i_block = i_first; i_block < i_beyond; ++i_block ) {
+                const int y = int( i_block/n_block_columns )*block_height;
+                const int x = int( i_block % n_block_columns )*block_width;
+                const int block_h = min( block_height, h - y );
+                const int block_w = min( block_width, w - x );
+                _definitions::impl::multiplication::multiply_add_items(
+                    const_a.sub_view( {0, y}, {depth, block_h} ),
+                    const_b.sub_view( {x, 0}, {block_w, depth} ),
+                    c.sub_view( {x, y}, {block_w, block_h} )
+                    );
+            }
+        } );
+    }
+
+    template< class Item >
+    void multiply_add(
+        const Matrix_<Item>&    a,
+        const Matrix_<Item>&    b,
+        Matrix_<Item>&          c,
+        const int               grain_size = 0
+        )
+    {
+        hopefully( &c != &a and &c != &b )
+            or KS_FAIL_( std_exception::invalid_argument, "The result matrix c is also an operand." );
+        parallel::multiply_add( view_of( a ), view_of( b ), view_of( c ), grain_size );
+    }
+
+    template< class A_item, class B_item >
+    auto multiply( const Matrix_view_<A_item>& a, const Matrix_view_<B_item>& b, const int grain_size = 0 )
+        -> Matrix_<remove_const_t<A_item>>
+    {
+        hopefully( a.width() == b.height() )
+            or KS_FAIL_( std_exception::invalid_argument, "The width of a differs from the height of b." );
+
+        Matrix_<remove_const_t<A_item>> result( b.width(), a.height() );
+        parallel::multiply_add( a, b, view_of( result ), grain_size );
+        return result;
+    }
+
+    template< class Item >
+    auto multiply( const Matrix_<Item>& a, const Matrix_<Item>& b, const int grain_size = 0 )
+        -> Matrix_<Item>
+    { return parallel::multiply( view_of( a ), view_of( b ), grain_size ); }
+
+    // Returns a·x for a sparse matrix a, with tasks that each compute a range of result items.
+    // A `csc` matrix is first converted to `csr`, since each column contributes to many result
+    // items; keep a matrix that's multiplied repeatedly in `csr` form.
+    template< class Item >
+    auto multiply( const Sparse_matrix_<Item>& a, const vector<Item>& x, const int grain_size = 0 )
+        -> vector<Item>
+    {
+        if( a.layout() != Sparse_layout::csr ) {
+            return parallel::multiply( a.converted_to( Sparse_layout::csr ), x, grain_size );
+        }
+        hopefully( Size( x.size() ) == a.width() )
+            or KS_FAIL_( std_exception::invalid_argument, "The size of x differs from the width of a." );
+
+        vector<Item> result( a.height() );
+        Thread_pool::singleton().for_each_range( a.height(), grain_size, [&]( const Size y_first, const Size y_beyond )
+        {
+            for( int y = int( y_first ); y < y_beyond; ++y ) {
+                result[y] = _definitions::impl::sparse::row_times_vector( a, y, x.data() );
+            }
+        } );
+        return result;
+    }
+}  // namespace kickstart::matrices::_definitions::parallel
+
+namespace kickstart::matrices::_definitions {
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names {
+        namespace parallel = d::parallel;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -0,0 +1,259 @@
+﻿// Source encoding: utf-8  --  π is (or should be) a lowercase greek pi.
+#pragma once
+#include <kickstart/core/language/assertion-headers/~assert-reasonable-compiler.hpp>
+
+// Copyright (c) 2020 Alf P. Steinbach. MIT license, with license text:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <kickstart/core/failure-handling.hpp>          // hopefully, KS_FAIL_
+#include <kickstart/core/language/Truth.hpp>            // Truth
+#include <kickstart/core/language/type-aliases.hpp>     // Size
+
+#include <algorithm>            // std::max
+#include <condition_variable>   // std::condition_variable
+#include <deque>                // std::deque
+#include <exception>            // std::(exception_ptr, current_exception, rethrow_exception)
+#include <memory>               // std::(make_unique, unique_ptr)
+#include <mutex>                // std::(mutex, lock_guard, unique_lock)
+#include <thread>               // std::thread
+#include <vector>               // std::vector
+
+// A work stealing pool of threads for data parallel loops, `for_each_range( n, grain_size, f )`.
+// A range of indices is split in halves until the parts are no larger than the grain size: the
+// thread keeps one half and pushes the other half on its own task queue. A thread that runs out
+// of tasks steals the oldest task, usually a large part, from another thread's queue.
+//
+// The thread that calls `for_each_range` works on the range too, so a pool of n threads has
+// n - 1 worker threads. A `for_each_range` call in a worker thread, a nested loop, is executed
+// directly by that thread.
+
+namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
+    using   kickstart::language::Size, kickstart::language::Truth;
+    using   std::max,
+            std::condition_variable, std::mutex, std::lock_guard, std::unique_lock,
+            std::deque,
+            std::exception_ptr, std::current_exception, std::rethrow_exception,
+            std::make_unique, std::unique_ptr,
+            std::thread,
+            std::vector;
+
+    class Thread_pool
+    {
+        // A loop over a range of indices, with the loop body type erased.
+        struct Job
+        {
+            const void*         p_func;
+            void                (*call)( const void* p_func, Size i_first, Size i_beyond );
+            Size                grain_size;
+
+            mutex               m;
+            condition_variable  finished;
+            Size                n_remaining;        // Number of indices not yet processed.
+            exception_ptr       exception;          // The first exception from the loop body.
+        };
+
+        struct Task{ Job* p_job; Size i_first; Size i_beyond; };
+
+        struct Task_queue
+        {
+            mutex           m;
+            deque<Task>     tasks;
+        };
+
+        vector<unique_ptr<Task_queue>>  m_queues;       // [0] for other threads, then one per worker.
+        vector<thread>                  m_workers;
+
+        mutex                           m_wakeup_mutex;
+        condition_variable              m_wakeup;
+        Size                            m_n_queued_tasks;
+        bool                            m_is_stopping;
+
+        // 0 for a thread that's not a worker thread.
+        static auto this_thread_queue_index()
+            -> int&
+        {
+            thread_local int the_index = 0;
+            return the_index;
+        }
+
+        void push( const int i_queue, const Task& task )
+        {
+            Task_queue& queue = *m_queues[i_queue];
+            {
+                const lock_guard<mutex> lock( queue.m );
+                queue.tasks.push_back( task );
+            }
+            {
+                const lock_guard<mutex> lock( m_wakeup_mutex );
+                ++m_n_queued_tasks;
+            }
+            m_wakeup.notify_one();
+        }
+
+        // Takes the newest task from the thread's own queue, or else steals the oldest task from
+        // another queue.
+        auto find_task( const int i_queue, Task& task )
+            -> Truth
+        {
+            const int n_queues = int( m_queues.size() );
+            for( int i = 0; i < n_queues; ++i ) {
+                Task_queue& queue = *m_queues[(i_queue + i) % n_queues];
+                const lock_guard<mutex> lock( queue.m );
+                if( not queue.tasks.empty() ) {
+                    if( i == 0 ) {
+                        task = queue.tasks.back();  queue.tasks.pop_back();
+                    } else {
+                        task = queue.tasks.front();  queue.tasks.pop_front();
+                    }
+                    const lock_guard<mutex> counter_lock( m_wakeup_mutex );
+                    --m_n_queued_tasks;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run( Task task, const int i_queue )
+        {
+            Job& job = *task.p_job;
+            while( task.i_beyond - task.i_first > job.grain_size ) {
+                const Size i_middle = task.i_first + (task.i_beyond - task.i_first)/2;
+                push( i_queue, Task{ &job, i_middle, task.i_beyond } );
+                task.i_beyond = i_middle;
+            }
+
+            exception_ptr exception;
+            try {
+                job.call( job.p_func, task.i_first, task.i_beyond );
+            } catch( ... ) {
+                exception = current_exception();
+            }
+
+            const lock_guard<mutex> lock( job.m );
+            if( exception and not job.exception ) { job.exception = exception; }
+            job.n_remaining -= task.i_beyond - task.i_first;
+            if( job.n_remaining == 0 ) { job.finished.notify_all(); }
+        }
+
+        void serve( const int i_queue )
+        {
+            this_thread_queue_index() = i_queue;
+            for( ;; ) {
+                Task task;
+                if( find_task( i_queue, task ) ) {
+                    run( task, i_queue );
+                    continue;
+                }
+                unique_lock<mutex> lock( m_wakeup_mutex );
+                m_wakeup.wait( lock, [&]{ return m_is_stopping or m_n_queued_tasks > 0; } );
+                if( m_is_stopping ) { return; }
+            }
+        }
+
+        void start_workers( const int n )
+        {
+            m_queues.clear();
+            for( int i = 0; i <= n; ++i ) { m_queues.push_back( make_unique<Task_queue>() ); }
+            for( int i = 1; i <= n; ++i ) { m_workers.emplace_back( [this, i]{ serve( i ); } ); }
+        }
+
+        void stop_workers()
+        {
+            {
+                const lock_guard<mutex> lock( m_wakeup_mutex );
+                m_is_stopping = true;
+            }
+            m_wakeup.notify_all();
+            for( thread& worker: m_workers ) { worker.join(); }
+            m_workers.clear();
+            m_is_stopping = false;
+        }
+
+        Thread_pool():
+            m_n_queued_tasks( 0 ),
+            m_is_stopping( false )
+        {
+            start_workers( max<int>( 1, thread::hardware_concurrency() ) - 1 );
+        }
+
+    public:
+        ~Thread_pool() { stop_workers(); }
+
+        auto n_threads() const -> int { return int( m_workers.size() ) + 1; }
+
+        // Must not be called while loops are executing in the pool.
+        void set_n_threads( const int n )
+        {
+            hopefully( n >= 1 )
+                or KS_FAIL_( std_exception::invalid_argument, "The number of threads must be at least 1." );
+            stop_workers();
+            start_workers( n - 1 );
+        }
+
+        // Calls `f( i_first, i_beyond )` for disjoint ranges of at most `grain_size` indices that
+        // together cover [0, `n`), in parallel. A `grain_size` of 0 means 1/8 of an even share
+        // per thread. An exception from
+        // `f` is rethrown, after all the ranges have been processed.
+        template< class Func >
+        void for_each_range( const Size n, const Size grain_size, const Func& f )
+        {
+            if( n <= 0 ) { return; }
+            const Size grain = (grain_size > 0? grain_size : max<Size>( 1, n/(8*n_threads()) ));
+            if( m_workers.empty() or this_thread_queue_index() != 0 or n <= grain ) {
+                f( Size( 0 ), n );
+                return;
+            }
+
+            Job job;
+            job.p_func = &f;
+            job.call = []( const void* p_func, const Size i_first, const Size i_beyond )
+            {
+                (*static_cast<const Func*>( p_func ))( i_first, i_beyond );
+            };
+            job.grain_size = grain;
+            job.n_remaining = n;
+
+            // Works on the job, and possibly on other jobs, until no tasks are left to take.
+            run( Task{ &job, 0, n }, 0 );
+            for( Task task; find_task( 0, task ); ) { run( task, 0 ); }
+
+            unique_lock<mutex> lock( job.m );
+            job.finished.wait( lock, [&]{ return job.n_remaining == 0; } );
+            if( job.exception ) { rethrow_exception( job.exception ); }
+        }
+
+        static auto singleton()
+            -> Thread_pool&
+        {
+            static Thread_pool the_pool;
+            return the_pool;
+        }
+    };
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Thread_pool;
+    }  // namespace exported names
+}  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
@@ -23,86 +23,349 @@
 // SOFTWARE.
 
 #include <kickstart/core/collection-util.hpp>
+#include <kickstart/core/failure-handling.hpp>                  // hopefully, KS_FAIL_
 #include <kickstart/core/language/Truth.hpp>
+#include <kickstart/core/language/type-aliases.hpp>             // Size
+#include <kickstart/core/matrices/Aligned_allocator_.hpp>
+#include <kickstart/core/text-conversion/to-text/string-output-operator.hpp>   // concatenated
 
-#include <unordered_map>
-#include <vector>
-#include <utility>
+#include <algorithm>        // std::find
+#include <array>            // std::array
+#include <atomic>           // std::atomic
+#include <mutex>            // std::(mutex, lock_guard)
+#include <string>           // std::string
+#include <utility>          // std::move
+#include <vector>           // std::vector
+
+// A `Vector_pool_<Item>` recycles the item buffers of matrices. A new vector gets capacity for
+// exactly the requested number of items. A vector that's handed back is pooled in a size class
+// determined by its capacity, with 4 classes per power of 2, and it's later reused for a size
+// in its own class or the class below, so a reused vector is at most about 1.4 times as large
+// as needed.
+//
+// Each thread has its own cache of vectors, which needs no synchronization. A vector that
+// doesn't fit in the thread's cache goes to a global depot that's shared by all threads, and
+// an allocation that finds no vector in the thread's cache looks in the depot. When a thread
+// ends its cached vectors move to the depot. Vectors that don't fit in the depot are freed.
+//
+// By default only vectors of up to 2^16 items are pooled, with at most 4 MiB per thread and
+// 16 MiB in the depot, for each `Item` type. Use `set_limits` to pool also larger vectors.
+//
+// The pool singleton is never destroyed, so that threads can use it also during program
+// termination. After a thread's cache has been destroyed, its vectors are just allocated and
+// freed.
 
 namespace kickstart::matrices::_definitions {
+    using namespace kickstart::failure_handling;    // hopefully, KS_FAIL_
     namespace k = kickstart;
     using   k::language::Truth,
-            k::collection_util::int_size;
-    using   std::unordered_map,
-            std::vector,
-            std::swap;
+            k::language::Size,
+            k::collection_util::int_size,
+            k::text_conversion::concatenated;
+    using   std::find,
+            std::array,
+            std::atomic, std::memory_order_relaxed,
+            std::mutex, std::lock_guard,
+            std::string,
+            std::move,
+            std::vector;
+
+    struct Vector_pool_limits
+    {
+        Size    max_pooled_size         = Size( 1 ) << 16;  // Number of items in a pooled vector.
+        Size    max_bytes_per_thread    = Size( 4 ) << 20;
+        Size    max_bytes_in_depot      = Size( 16 ) << 20;
+    };
+
+    struct Vector_pool_statistics
+    {
+        Size    n_hits              = 0;    // Allocations that reused a pooled vector.
+        Size    n_misses            = 0;    // Allocations that allocated memory.
+        Size    n_bytes_retained    = 0;    // Total capacity of the pooled vectors.
+    };
+
+    inline auto str( const Vector_pool_statistics& stats )
+        -> string
+    {
+        return concatenated(
+            stats.n_hits, " hits, ", stats.n_misses, " misses, ",
+            stats.n_bytes_retained, " bytes retained"
+            );
+    }
+
+    namespace impl::vector_pool {
+        constexpr int n_size_classes = 4*64;
+
+        // The size class of a capacity n >= 1: 4*log2(n) plus the two bits after n's most
+        // significant bit, for n >= 4. The class increases with n.
+        inline auto size_class_of( const Size n )
+            -> int
+        {
+            if( n < 4 ) { return int( n ); }
+            int log2_n = 0;
+            while( (Size( 2 ) << log2_n) <= n ) { ++log2_n; }
+            return 4*log2_n + int( (n >> (log2_n - 2)) & 3 );
+        }
+
+        // For a counter that only one thread changes, but that other threads can read.
+        inline void add( atomic<Size>& counter, const Size value )
+        {
+            counter.store( counter.load( memory_order_relaxed ) + value, memory_order_relaxed );
+        }
+    }  // namespace impl::vector_pool
 
     template< class Item_type_param >
     class Vector_pool_
     {
     public:
         using Item = Item_type_param;
+        using Item_vector = Aligned_vector_<Item>;
 
     private:
-        using Item_vector = vector<Item>;
+        using Vectors_by_class = array<vector<Item_vector>, impl::vector_pool::n_size_classes>;
+
+        static auto n_bytes_of( const Item_vector& v ) -> Size { return Size( v.capacity()*sizeof( Item ) ); }
+
+        // Removes and returns a vector with capacity for at least `size` items, or returns an
+        // empty vector if there is none in the size class of `size` or in the class above.
+        static auto take_fitting( Vectors_by_class& vectors, const Size size )
+            -> Item_vector
+        {
+            const int size_class = impl::vector_pool::size_class_of( size );
+            for( int c = size_class; c <= size_class + 1 and c < impl::vector_pool::n_size_classes; ++c ) {
+                vector<Item_vector>& candidates = vectors[c];
+                for( int i = int_size( candidates ) - 1; i >= 0; --i ) {
+                    if( Size( candidates[i].capacity() ) >= size ) {
+                        Item_vector result = move( candidates[i] );
+                        candidates.erase( candidates.begin() + i );
+                        return result;
+                    }
+                }
+            }
+            return Item_vector();
+        }
+
+        struct Thread_cache
+        {
+            Vectors_by_class    vectors;
+            atomic<Size>        n_hits              = 0;
+            atomic<Size>        n_misses            = 0;
+            atomic<Size>        n_bytes_retained    = 0;
 
-        unordered_map<int, vector<Item_vector>> m_vectors;
-        int                                     m_max_vector_size;
-        int                                     m_max_capacity;
+            Thread_cache() { singleton().add( this ); }
+
+            ~Thread_cache()
+            {
+                singleton().retire( *this );
+                this_thread_cache_is_destroyed() = true;
+            }
+        };
+
+        mutable mutex           m_mutex;            // For the depot and the list of caches.
+        Vectors_by_class        m_depot;
+        atomic<Size>            m_n_depot_bytes;    // Only changed with `m_mutex` locked.
+        vector<Thread_cache*>   m_caches;
+        Vector_pool_statistics  m_retired_totals;   // From caches of threads that have ended.
+
+        atomic<Size>            m_max_pooled_size;
+        atomic<Size>            m_max_bytes_per_thread;
+        atomic<Size>            m_max_bytes_in_depot;
 
         Vector_pool_():
-            m_max_vector_size( 4*4 ),
-            m_max_capacity( 32 )
-        {}
+            m_n_depot_bytes( 0 )
+        {
+            set_limits( Vector_pool_limits() );
+        }
+
+        static auto this_thread_cache_is_destroyed()
+            -> bool&
+        {
+            thread_local bool the_flag = false;
+            return the_flag;
+        }
+
+        // The calling thread's cache, or `nullptr` after the cache has been destroyed at the
+        // end of the thread, e.g. for a namespace scope `Matrix_` destroyed after `main` returns.
+        static auto this_thread_cache()
+            -> Thread_cache*
+        {
+            if( this_thread_cache_is_destroyed() ) { return nullptr; }
+            thread_local Thread_cache the_cache;
+            return &the_cache;
+        }
+
+        void add( Thread_cache* const p_cache )
+        {
+            const lock_guard<mutex> lock( m_mutex );
+            m_caches.push_back( p_cache );
+        }
+
+        auto take_from_depot( const Size size )
+            -> Item_vector
+        {
+            if( m_n_depot_bytes.load( memory_order_relaxed ) == 0 ) { return Item_vector(); }
+            const lock_guard<mutex> lock( m_mutex );
+            Item_vector result = take_fitting( m_depot, size );
+            m_n_depot_bytes -= n_bytes_of( result );
+            return result;
+        }
+
+        // Moves `v` to the depot if there's room for it there, and otherwise leaves it as is,
+        // also when locking or growing the depot fails.
+        void put_in_depot( Item_vector& v ) noexcept
+        {
+            try {
+                const lock_guard<mutex> lock( m_mutex );
+                const Size n_bytes = n_bytes_of( v );
+                if( m_n_depot_bytes + n_bytes <= m_max_bytes_in_depot ) {
+                    m_depot[impl::vector_pool::size_class_of( Size( v.capacity() ) )].push_back( move( v ) );
+                    m_n_depot_bytes += n_bytes;
+                }
+            } catch( ... ) {
+                // `push_back` has the strong exception guarantee, so `v` is unchanged.
+            }
+        }
+
+        void retire( Thread_cache& cache )
+        {
+            for( vector<Item_vector>& vectors: cache.vectors ) {
+                for( Item_vector& v: vectors ) { put_in_depot( v ); }
+                vector<Item_vector>().swap( vectors );
+            }
+            cache.n_bytes_retained = 0;
+
+            const lock_guard<mutex> lock( m_mutex );
+            m_retired_totals.n_hits += cache.n_hits;
+            m_retired_totals.n_misses += cache.n_misses;
+            m_caches.erase( find( m_caches.begin(), m_caches.end(), &cache ) );
+        }
 
     public:
-        void remove_all() { decltype( m_vectors )().swap( m_vectors ); }
+        auto limits() const
+            -> Vector_pool_limits
+        {
+            return Vector_pool_limits{
+                m_max_pooled_size, m_max_bytes_per_thread, m_max_bytes_in_depot
+                };
+        }
+
+        // Limits that are lowered don't free already pooled vectors.
+        void set_limits( const Vector_pool_limits& limits )
+        {
+            hopefully( limits.max_pooled_size >= 0 )
+                or KS_FAIL_( std_exception::invalid_argument, "The maximum pooled size is negative." );
+            hopefully( limits.max_bytes_per_thread >= 0 and limits.max_bytes_in_depot >= 0 )
+                or KS_FAIL_( std_exception::invalid_argument, "A maximum number of bytes is negative." );
+
+            m_max_pooled_size = limits.max_pooled_size;
+            m_max_bytes_per_thread = limits.max_bytes_per_thread;
+            m_max_bytes_in_depot = limits.max_bytes_in_depot;
+        }
+
+        auto statistics() const
+            -> Vector_pool_statistics
+        {
+            const lock_guard<mutex> lock( m_mutex );
+            Vector_pool_statistics result = m_retired_totals;
+            for( const Thread_cache* p_cache: m_caches ) {
+                result.n_hits += p_cache->n_hits;
+                result.n_misses += p_cache->n_misses;
+                result.n_bytes_retained += p_cache->n_bytes_retained;
+            }
+            result.n_bytes_retained += m_n_depot_bytes;
+            return result;
+        }
+
+        // Frees the vectors in the depot and in the calling thread's cache.
+        void remove_all()
+        {
+            if( Thread_cache* const p_cache = this_thread_cache() ) {
+                for( vector<Item_vector>& vectors: p_cache->vectors ) { vector<Item_vector>().swap( vectors ); }
+                p_cache->n_bytes_retained = 0;
+            }
+
+            const lock_guard<mutex> lock( m_mutex );
+            for( vector<Item_vector>& vectors: m_depot ) { vector<Item_vector>().swap( vectors ); }
+            m_n_depot_bytes = 0;
+        }
 
         auto allocate( const int size, const Truth zeroing = true )
-            -> vector<Item>
+            -> Item_vector
         {
-            if( size > m_max_vector_size ) {
-                return vector<Item>( size );
+            if( size == 0 ) { return Item_vector(); }
+
+            Thread_cache* const p_cache = this_thread_cache();
+            Item_vector result;
+            if( size <= m_max_pooled_size.load( memory_order_relaxed ) ) {
+                if( p_cache ) {
+                    result = take_fitting( p_cache->vectors, size );
+                    impl::vector_pool::add( p_cache->n_bytes_retained, -n_bytes_of( result ) );
+                }
+                if( result.capacity() == 0 ) { result = take_from_depot( size ); }
             }
-            vector<Item_vector>& vectors = m_vectors[size];
-            if( vectors.empty() ) {
-                vectors.reserve( m_max_capacity );
-                return vector<Item>( size );
-            } else {
-                vector<Item> result;
-                using std::swap;  swap( result, vectors.back() );
-                vectors.pop_back();
-                if( zeroing ) { for( Item& item: result ) { item = Item(); } }
-                return result;
+
+            const Truth is_hit = (result.capacity() > 0);
+            if( p_cache ) { impl::vector_pool::add( (is_hit? p_cache->n_hits : p_cache->n_misses), 1 ); }
+            if( not is_hit ) {
+                return Item_vector( size );
             }
+            if( zeroing ) { result.assign( size, Item() ); } else { result.resize( size ); }
+            return result;
         }
 
-        void deallocate( vector<Item>& v )
+        // Takes over the buffer of `v`, which is left empty. Doesn't throw, so that it can be
+        // used by `noexcept` move assignment: a vector that can't be pooled is just freed.
+        void deallocate( Item_vector& v ) noexcept
         {
-            using std::swap;
-            const int size = int_size( v );
-            if( size <= m_max_vector_size ) {
-                vector<Item_vector>& vectors = m_vectors[size];
-                vectors.push_back( move( v ) );
+            const Size n_bytes = n_bytes_of( v );
+            if( n_bytes > 0 and Size( v.capacity() ) <= m_max_pooled_size.load( memory_order_relaxed ) ) {
+                try {
+                    if( Thread_cache* const p_cache = this_thread_cache() ) {
+                        if( p_cache->n_bytes_retained + n_bytes <= m_max_bytes_per_thread ) {
+                            const int size_class = impl::vector_pool::size_class_of( Size( v.capacity() ) );
+                            p_cache->vectors[size_class].push_back( move( v ) );
+                            impl::vector_pool::add( p_cache->n_bytes_retained, n_bytes );
+                        } else {
+                            put_in_depot( v );
+                        }
+                    }
+                } catch( ... ) {
+                    // Creating the thread's cache or growing it failed, and `v` is unchanged.
+                }
             }
-            vector<Item>().swap( v );
+            Item_vector().swap( v );
         }
 
         static auto singleton()
             -> Vector_pool_&
         {
-            static Vector_pool_ the_pool;
+            static Vector_pool_& the_pool = *new Vector_pool_();
             return the_pool;
         }
     };
+
     template< class Item >
     inline auto allocate_vector_( const int size, const Truth zeroing = true )
-        -> vector<Item>
+        -> Aligned_vector_<Item>
     { return Vector_pool_<Item>::singleton().allocate( size, zeroing ); }
 
     template< class Item >
-    inline void deallocate_vector( vector<Item>& v )
+    inline void deallocate_vector( Aligned_vector_<Item>& v ) noexcept
     {
         Vector_pool_<Item>::singleton().deallocate( v );
     }
+
+
+    //----------------------------------------------------------- @exported:
+    namespace d = _definitions;
+    namespace exported_names { using
+        d::Vector_pool_limits,
+        d::Vector_pool_statistics,
+        d::str,
+        d::Vector_pool_,
+        d::allocate_vector_,
+        d::deallocate_vector;
+    }  // namespace exported names
 }  // namespace kickstart::matrices::_definitions
+
+namespace kickstart::matrices   { using namespace _definitions::exported_names;}
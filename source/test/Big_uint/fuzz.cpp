@@ -0,0 +1,255 @@
+// Differential fuzzing of `Big_uint` against `Reference_uint` below, a deliberately simple
+// schoolbook implementation with 32-bit digits: every result of every operation on random
+// operands is checked for equality. Quotients and remainders are checked via q·b + r = a with
+// r < b, which determines them. The operand sizes are mostly small, with some large enough
+// for Karatsuba and Toom-3 multiplication and for decimal conversion via reciprocals, and the
+// units are biased towards 0 and all 1-bits. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -I ../../library fuzz.cpp
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+#include <algorithm>
+
+using   std::max, std::reverse;
+
+class Reference_uint
+{
+    vector<uint32_t>    m_digits;       // Little endian, without leading zeros.
+
+    void trim() { while( not m_digits.empty() and m_digits.back() == 0 ) { m_digits.pop_back(); } }
+
+public:
+    Reference_uint() {}
+
+    explicit Reference_uint( const vector<uint64_t>& units )
+    {
+        for( const uint64_t unit: units ) {
+            m_digits.push_back( uint32_t( unit ) );
+            m_digits.push_back( uint32_t( unit >> 32 ) );
+        }
+        trim();
+    }
+
+    auto units() const
+        -> vector<uint64_t>
+    {
+        vector<uint64_t> result;
+        for( int i = 0; i < int( m_digits.size() ); i += 2 ) {
+            result.push_back( m_digits[i] | (i + 1 < int( m_digits.size() )? uint64_t( m_digits[i + 1] ) << 32 : 0) );
+        }
+        return result;
+    }
+
+    auto digit( const int i ) const -> uint32_t { return (i < int( m_digits.size() )? m_digits[i] : 0); }
+    auto n_digits() const -> int { return int( m_digits.size() ); }
+
+    friend auto compare( const Reference_uint& a, const Reference_uint& b )
+        -> int
+    {
+        if( a.n_digits() != b.n_digits() ) { return (a.n_digits() < b.n_digits()? -1 : +1); }
+        for( int i = a.n_digits() - 1; i >= 0; --i ) {
+            if( a.m_digits[i] != b.m_digits[i] ) { return (a.m_digits[i] < b.m_digits[i]? -1 : +1); }
+        }
+        return 0;
+    }
+
+    friend auto operator+( const Reference_uint& a, const Reference_uint& b )
+        -> Reference_uint
+    {
+        Reference_uint result;
+        uint64_t carry = 0;
+        for( int i = 0; i < max( a.n_digits(), b.n_digits() ); ++i ) {
+            const uint64_t sum = uint64_t( a.digit( i ) ) + b.digit( i ) + carry;
+            result.m_digits.push_back( uint32_t( sum ) );
+            carry = sum >> 32;
+        }
+        result.m_digits.push_back( uint32_t( carry ) );
+        result.trim();
+        return result;
+    }
+
+    // Requires a >= b.
+    friend auto operator-( const Reference_uint& a, const Reference_uint& b )
+        -> Reference_uint
+    {
+        Reference_uint result;
+        int64_t borrow = 0;
+        for( int i = 0; i < a.n_digits(); ++i ) {
+            int64_t difference = int64_t( a.digit( i ) ) - b.digit( i ) - borrow;
+            borrow = (difference < 0);
+            if( borrow ) { difference += int64_t( 1 ) << 32; }
+            result.m_digits.push_back( uint32_t( difference ) );
+        }
+        result.trim();
+        return result;
+    }
+
+    friend auto operator*( const Reference_uint& a, const Reference_uint& b )
+        -> Reference_uint
+    {
+        Reference_uint result;
+        result.m_digits.assign( a.n_digits() + b.n_digits(), 0 );
+        for( int i = 0; i < a.n_digits(); ++i ) {
+            uint64_t carry = 0;
+            for( int j = 0; j < b.n_digits(); ++j ) {
+                const uint64_t sum = uint64_t( a.m_digits[i] )*b.m_digits[j] + result.m_digits[i + j] + carry;
+                result.m_digits[i + j] = uint32_t( sum );
+                carry = sum >> 32;
+            }
+            result.m_digits[i + b.n_digits()] = uint32_t( carry );
+        }
+        result.trim();
+        return result;
+    }
+
+    auto decimal_text() const
+        -> string
+    {
+        string reversed;
+        vector<uint32_t> digits = m_digits;
+        while( not digits.empty() ) {
+            uint64_t remainder = 0;             // Division by 10^9.
+            for( int i = int( digits.size() ) - 1; i >= 0; --i ) {
+                const uint64_t dividend = remainder << 32 | digits[i];
+                digits[i] = uint32_t( dividend/1'000'000'000 );
+                remainder = dividend % 1'000'000'000;
+            }
+            while( not digits.empty() and digits.back() == 0 ) { digits.pop_back(); }
+            for( int i = 0; i < 9 and (remainder != 0 or not digits.empty()); ++i ) {
+                reversed += char( '0' + remainder % 10 );
+                remainder /= 10;
+            }
+        }
+        if( reversed.empty() ) { reversed = "0"; }
+        reverse( reversed.begin(), reversed.end() );
+        return reversed;
+    }
+};
+
+auto units_of( const Big_uint& v ) -> vector<uint64_t> { return vector<uint64_t>( v.units(), v.units() + v.n_units() ); }
+auto reference( const Big_uint& v ) -> Reference_uint { return Reference_uint( units_of( v ) ); }
+
+auto is_equal( const Big_uint& v, const Reference_uint& r ) -> Truth { return units_of( v ) == r.units(); }
+
+class Fuzzer:
+    public Fuzzer_base
+{
+
+    // A size class is chosen per iteration, so that both operands can be large.
+    auto random_size_class() -> int { return int( m_bits() % 64 ); }
+
+    auto random_n_units( const int size_class )
+        -> int
+    {
+        switch( size_class ) {
+            case 0:     return 400 + int( m_bits() % 900 );     // Reciprocal division in `str`.
+            case 1:
+            case 2:     return 160 + int( m_bits() % 240 );     // Toom-3.
+            case 3:
+            case 4:
+            case 5:     return 32 + int( m_bits() % 128 );      // Karatsuba.
+            default:    return int( m_bits() % 9 );
+        }
+    }
+
+    auto random_value( const int n_units )
+        -> Big_uint
+    {
+        const int pattern = int( m_bits() % 4 );
+        vector<uint64_t> units( n_units );
+        for( uint64_t& unit: units ) {
+            const int kind = (pattern == 0? int( m_bits() % 4 ) : 3);
+            unit = (kind == 0? 0 : kind == 1? ~uint64_t() : kind == 2? m_bits() % 3 : m_bits());
+        }
+        if( pattern == 1 and n_units > 0 ) { units.back() = 1; }       // Just above a power of 2^64.
+        return Big_uint::from_units( units.data(), n_units );
+    }
+
+    void check( const Truth is_match, const char* const operation, const Big_uint& a, const Big_uint& b )
+    {
+        check_( is_match, operation, [&]
+        {
+            return ""s << "a of " << a.n_units() << " units and b of " << b.n_units() << " units, "
+                << "a = " << str( a ).substr( 0, 40 ) << "... and b = " << str( b ).substr( 0, 40 ) << "...";
+        } );
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        const int size_class = random_size_class();
+        const Big_uint a = random_value( random_n_units( size_class ) );
+        const Big_uint b = random_value( random_n_units( m_bits() % 4 == 0? random_size_class() : size_class ) );
+        const Reference_uint ra = reference( a );
+        const Reference_uint rb = reference( b );
+        const uint64_t m = (m_bits() % 2 == 0? m_bits() : m_bits() % 3);
+
+        check( a.n_units() == int( ra.units().size() ), "n_units", a, b );
+        check( is_equal( a + b, ra + rb ), "+", a, b );
+        check( is_equal( a*b, ra*rb ), "*", a, b );
+        check( compare( a, b ) == compare( ra, rb ), "compare", a, b );
+        check( (a < b) == (compare( ra, rb ) < 0) and (a <= b) == (compare( ra, rb ) <= 0)
+            and (a == b) == (compare( ra, rb ) == 0) and (a >= b) == (compare( ra, rb ) >= 0)
+            and (a > b) == (compare( ra, rb ) > 0) and (a != b) == (compare( ra, rb ) != 0),
+            "relational", a, b );
+        check( a.bit_width() == (ra.n_digits() == 0? 0
+            : 32*(ra.n_digits() - 1) + 32 - __builtin_clz( ra.digit( ra.n_digits() - 1 ) )),
+            "bit_width", a, b );
+
+        if( a >= b ) {
+            check( is_equal( a - b, ra - rb ), "-", a, b );
+        } else {
+            Truth threw = false;
+            try { (void) (a - b); } catch( const std::out_of_range& ) { threw = true; }
+            check( threw, "- with negative result", a, b );
+        }
+
+        if( not b.is_zero() ) {
+            const Big_uint::Divmod_result r = divmod( a, b );
+            check( r.remainder < b and is_equal( r.quotient*b + r.remainder, ra )
+                and is_equal( r.quotient, reference( a/b ) ) and is_equal( r.remainder, reference( a % b ) ),
+                "divmod", a, b );
+        }
+        if( m != 0 ) {
+            const Big_uint::Divmod_result r = a.divmod_by_64_bit( m );
+            const Reference_uint rm = Reference_uint( {m} );
+            check( compare( reference( r.remainder ), rm ) < 0
+                and is_equal( r.quotient*Big_uint( m ) + r.remainder, ra ), "divmod_by_64_bit", a, b );
+        }
+
+        Big_uint incremented = a;
+        ++incremented;
+        check( is_equal( incremented, ra + Reference_uint( {1} ) ), "++", a, b );
+        if( not a.is_zero() ) {
+            Big_uint decremented = a;
+            --decremented;
+            check( is_equal( decremented, ra - Reference_uint( {1} ) ), "--", a, b );
+        }
+
+        Big_uint product = a;
+        product.multiply_by_64_bit( m );
+        check( is_equal( product, ra*Reference_uint( {m} ) ), "multiply_by_64_bit", a, b );
+        Big_uint sum = a;
+        sum.add_64_bit( m );
+        check( is_equal( sum, ra + Reference_uint( {m} ) ), "add_64_bit", a, b );
+
+        const string text = str( a );
+        check( text == ra.decimal_text(), "str", a, b );
+        const Parsing_result_<Big_uint> parsed = parse_big_uint( text );
+        check( parsed.is_ok() and parsed.value == a, "parse_big_uint", a, b );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 20'000, "Big_uint differs from the reference implementation." ); }
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
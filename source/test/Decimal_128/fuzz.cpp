@@ -0,0 +1,445 @@
+// Differential fuzzing of `Decimal_128` and `Decimal_128_` against a reference decimal with
+// an exact `Big_uint` magnitude, where `Big_uint` is itself fuzzed against a schoolbook
+// implementation. Every result of every operation on random operands is checked for equality,
+// including whether it throws `std::out_of_range`, with every rounding mode. The reference
+// rounds by comparing twice the remainder with the divisor. The operands are biased towards
+// edge cases such as 0, ±1, the most negative and most positive unit counts, and powers of 10,
+// and the scales towards small scales and the maximum scale. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -I ../../library fuzz.cpp
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#ifndef __SIZEOF_INT128__
+#   error "The fuzzer needs the compiler's `__int128` for the unit counts."
+#endif
+
+#include <stdint.h>
+
+#include <stdexcept>
+
+using   std::max,
+        std::out_of_range;
+
+__extension__ typedef __int128 Native;
+__extension__ typedef unsigned __int128 Native_unsigned;
+
+const Native native_min = Native( Native_unsigned( 1 ) << 127 );
+const Native native_max = Native( ~Native_unsigned() >> 1 );
+
+const Rounding::Enum all_roundings[] =
+{
+    Rounding::half_even, Rounding::half_away_from_zero, Rounding::toward_zero, Rounding::floor, Rounding::ceiling
+};
+
+auto native( const Int_128& v )
+    -> Native
+{
+    const Uint_128::Parts& parts = v.bits().representation();
+    return Native( Native_unsigned( parts.parts[1] ) << 64 | parts.parts[0] );
+}
+
+auto as_int_128( const Native v )
+    -> Int_128
+{ return Int_128( tag::From_parts(), uint64_t( v ), uint64_t( Native_unsigned( v ) >> 64 ) ); }
+
+auto magnitude_of( const Native v )
+    -> Native_unsigned
+{ return (v < 0? -Native_unsigned( v ) : Native_unsigned( v )); }
+
+// E.g. "-12.34" for `units` -1234 with `scale` 2.
+auto decimal_text_of( const Native units, const int scale )
+    -> string
+{
+    Native_unsigned magnitude = magnitude_of( units );
+    string reversed;
+    do { reversed += char( '0' + int( magnitude % 10 ) );  magnitude /= 10; } while( magnitude != 0 );
+    while( int( reversed.size() ) < scale + 1 ) { reversed += '0'; }
+    string digits( reversed.rbegin(), reversed.rend() );
+    if( scale > 0 ) { digits.insert( digits.size() - scale, "." ); }
+    return (units < 0? "-" : "") + digits;
+}
+
+auto pow10_big( const int n )
+    -> Big_uint
+{
+    Big_uint result = 1;
+    for( int i = 0; i < n; ++i ) { result.multiply_by_64_bit( 10 ); }
+    return result;
+}
+
+// An exact signed value, as a magnitude and a sign.
+struct Exact
+{
+    Truth       is_negative;
+    Big_uint    magnitude;
+};
+
+auto exact( const Native v )
+    -> Exact
+{
+    const Native_unsigned m = magnitude_of( v );
+    const uint64_t units[] = { uint64_t( m ), uint64_t( m >> 64 ) };
+    return {v < 0, Big_uint::from_units( units, 2 )};
+}
+
+auto compare( const Exact& a, const Exact& b )
+    -> int
+{
+    const Truth a_is_negative = (a.is_negative and not a.magnitude.is_zero());
+    const Truth b_is_negative = (b.is_negative and not b.magnitude.is_zero());
+    if( a_is_negative != b_is_negative ) { return (a_is_negative? -1 : +1); }
+    const int r = compare( a.magnitude, b.magnitude );
+    return (a_is_negative? -r : r);
+}
+
+auto sum_of( const Exact& a, const Exact& b )
+    -> Exact
+{
+    if( a.is_negative == b.is_negative ) { return {a.is_negative, a.magnitude + b.magnitude}; }
+    if( a.magnitude >= b.magnitude ) { return {a.is_negative, a.magnitude - b.magnitude}; }
+    return {b.is_negative, b.magnitude - a.magnitude};
+}
+
+// The reference result of an operation: either a unit count, or an `out_of_range` exception.
+struct Outcome
+{
+    Truth       is_out_of_range;
+    Native      units;
+
+    friend auto operator==( const Outcome& a, const Outcome& b )
+        -> Truth
+    { return (a.is_out_of_range == b.is_out_of_range and a.units == b.units); }
+};
+
+const Outcome out_of_range_outcome = {true, 0};
+
+auto outcome_from( const Exact& v )
+    -> Outcome
+{
+    const Big_uint& m = v.magnitude;
+    const Truth is_in_range = (m.bit_width() <= 127
+        or (v.is_negative and m.bit_width() == 128 and m.unit( 0 ) == 0 and m.unit( 1 ) == uint64_t( 1 ) << 63)
+        );
+    if( not is_in_range ) { return out_of_range_outcome; }
+    const Native_unsigned magnitude = Native_unsigned( m.unit( 1 ) ) << 64 | m.unit( 0 );
+    return {false, Native( v.is_negative? -magnitude : magnitude )};
+}
+
+// The value of an operation's result, or that it threw an `out_of_range`.
+template< class Func >
+auto outcome_of( const Func& f )
+    -> Outcome
+{
+    try {
+        return {false, native( f().units() )};
+    } catch( const out_of_range& ) {
+        return out_of_range_outcome;
+    }
+}
+
+// `n`/`d` for a non-zero `d`, rounded, as an independent implementation of the rounding modes.
+auto rounded_quotient( const Exact& n, const Big_uint& d, const Rounding::Enum rounding )
+    -> Exact
+{
+    const Big_uint::Divmod_result split = divmod( n.magnitude, d );
+    const Truth is_negative = n.is_negative;
+    const Truth is_exact = split.remainder.is_zero();
+    const int twice_remainder_vs_divisor = compare( split.remainder + split.remainder, d );
+    const Truth q_is_odd = (split.quotient.modulo_64_bits() % 2 == 1);
+
+    Truth is_incremented = false;
+    switch( rounding ) {
+        case Rounding::half_even: {
+            is_incremented = (twice_remainder_vs_divisor > 0 or (twice_remainder_vs_divisor == 0 and q_is_odd));
+            break;
+        }
+        case Rounding::half_away_from_zero: { is_incremented = (twice_remainder_vs_divisor >= 0); break; }
+        case Rounding::toward_zero:         { is_incremented = false; break; }
+        case Rounding::floor:               { is_incremented = (is_negative and not is_exact); break; }
+        case Rounding::ceiling:             { is_incremented = (not is_negative and not is_exact); break; }
+    }
+    Big_uint q = split.quotient;
+    if( is_incremented ) { ++q; }
+    return {is_negative, q};
+}
+
+// The exact value `v` with scale `from` expressed with scale `to`, rounded when `to` is less.
+auto rescaled( const Exact& v, const int from, const int to, const Rounding::Enum rounding )
+    -> Exact
+{
+    if( to >= from ) { return {v.is_negative, v.magnitude*pow10_big( to - from )}; }
+    return rounded_quotient( v, pow10_big( from - to ), rounding );
+}
+
+// A binary operation first expresses both operands with the larger of their scales, and is
+// out of range if either operand is then out of range.
+struct Operands
+{
+    Truth       is_out_of_range;
+    Exact       a;
+    Exact       b;
+    int         scale;
+};
+
+auto operands_for( const Native a, const int a_scale, const Native b, const int b_scale )
+    -> Operands
+{
+    const int scale = max( a_scale, b_scale );
+    const Exact ea = rescaled( exact( a ), a_scale, scale, Rounding::half_even );
+    const Exact eb = rescaled( exact( b ), b_scale, scale, Rounding::half_even );
+    const Truth is_out_of_range = (outcome_from( ea ).is_out_of_range or outcome_from( eb ).is_out_of_range);
+    return {is_out_of_range, ea, eb, scale};
+}
+
+auto sum_outcome( const Native a, const int a_scale, const Native b, const int b_scale, const Truth is_subtraction )
+    -> Outcome
+{
+    const Operands o = operands_for( a, a_scale, b, b_scale );
+    if( o.is_out_of_range ) { return out_of_range_outcome; }
+    return outcome_from( sum_of( o.a, {o.b.is_negative != is_subtraction, o.b.magnitude} ) );
+}
+
+auto product_outcome( const Native a, const int a_scale, const Native b, const int b_scale, const Rounding::Enum rounding )
+    -> Outcome
+{
+    const Operands o = operands_for( a, a_scale, b, b_scale );
+    if( o.is_out_of_range ) { return out_of_range_outcome; }
+    const Exact product = {o.a.is_negative != o.b.is_negative, o.a.magnitude*o.b.magnitude};
+    return outcome_from( rounded_quotient( product, pow10_big( o.scale ), rounding ) );
+}
+
+auto quotient_outcome( const Native a, const int a_scale, const Native b, const int b_scale, const Rounding::Enum rounding )
+    -> Outcome
+{
+    const Operands o = operands_for( a, a_scale, b, b_scale );
+    if( o.is_out_of_range or o.b.magnitude.is_zero() ) { return out_of_range_outcome; }
+    const Exact dividend = {o.a.is_negative != o.b.is_negative, o.a.magnitude*pow10_big( o.scale )};
+    return outcome_from( rounded_quotient( dividend, o.b.magnitude, rounding ) );
+}
+
+class Fuzzer:
+    public Fuzzer_base
+{
+
+    auto random_units()
+        -> Native
+    {
+        const Native_unsigned full = Native_unsigned( m_bits() ) << 64 | m_bits();
+        const int n = int( m_bits() % 128 );
+        const int delta = int( m_bits() % 3 );
+        Native power_of_10 = 1;
+        for( int i = int( m_bits() % 39 ); i > 0; --i ) { power_of_10 *= 10; }
+        switch( m_bits() % 10 ) {
+            case 0:     return Native( delta ) - 1;                                 // -1, 0 or 1.
+            case 1:     return native_min + delta;                                  // Most negative, and just above.
+            case 2:     return native_max - delta;                                  // Most positive, and just below.
+            case 3:     return power_of_10 + delta - 1;                             // Around a power of 10.
+            case 4:     return -power_of_10 - delta + 1;
+            case 5:     return (power_of_10 + delta - 1)/2;                         // Around a half.
+            case 6:     return Native( int64_t( m_bits() ) ) % 1'000'000;           // Small.
+            case 7:     return Native( full ) >> n;                                 // Random width, either sign.
+            default:    return Native( full );
+        }
+    }
+
+    auto random_scale()
+        -> int
+    {
+        switch( m_bits() % 4 ) {
+            case 0:     return Decimal_128::max_scale - int( m_bits() % 2 );
+            case 1:     return int( m_bits() % (Decimal_128::max_scale + 1) );
+            default:    return int( m_bits() % 5 );
+        }
+    }
+
+    auto random_rounding()
+        -> Rounding::Enum
+    { return all_roundings[m_bits() % 5]; }
+
+    // The text of `units` with `scale`, with random extra fractional digits and random
+    // apostrophes between integer part digits.
+    auto random_text( const Native units, const int scale, const int n_extra_digits, string& extra_digits )
+        -> string
+    {
+        string result = decimal_text_of( units, scale );
+        extra_digits.clear();
+        for( int i = 0; i < n_extra_digits; ++i ) {
+            extra_digits += char( '0' + (m_bits() % 3 == 0? 5 : int( m_bits() % 10 )) );
+        }
+        if( n_extra_digits > 0 and scale == 0 ) { result += '.'; }
+        result += extra_digits;
+        if( m_bits() % 4 == 0 ) {
+            const int i_first_digit = (units < 0? 1 : 0);
+            const int n_integer_digits = int( result.find( '.' ) == string::npos
+                ? result.size() : result.find( '.' )
+                ) - i_first_digit;
+            if( n_integer_digits >= 2 ) {
+                result.insert( i_first_digit + 1 + int( m_bits() % (n_integer_digits - 1) ), "'" );
+            }
+        }
+        return result;
+    }
+
+    void check(
+        const Truth         is_match,
+        const char* const   operation,
+        const Native        a,
+        const int           a_scale,
+        const Native        b,
+        const int           b_scale
+        )
+    {
+        check_( is_match, operation, [&]
+        {
+            return "a = " + decimal_text_of( a, a_scale ) + " and b = " + decimal_text_of( b, b_scale );
+        } );
+    }
+
+    void check_text_conversions( const Native a, const int a_scale )
+    {
+        const Decimal_128 da = Decimal_128::from_units( as_int_128( a ), a_scale );
+        const string text = str( da );
+        check( text == decimal_text_of( a, a_scale ), "str", a, a_scale, 0, 0 );
+
+        const Parsing_result_<Decimal_128> parsed = parse_decimal_128( text );
+        check( parsed.is_ok() and native( parsed.value.units() ) == a and parsed.value.scale() == a_scale,
+            "parse_decimal_128", a, a_scale, 0, 0 );
+        if( a >= 0 ) {
+            const Parsing_result_<Decimal_128> plus_parsed = parse_decimal_128( "+" + text );
+            check( plus_parsed.is_ok() and native( plus_parsed.value.units() ) == a,
+                "parse_decimal_128 with +", a, a_scale, 0, 0 );
+        }
+
+        // Parsing with a specified scale, where excess digits are rounded away.
+        string extra_digits;
+        const int n_extra_digits = int( m_bits() % 4 );
+        const string spec = random_text( a, a_scale, n_extra_digits, extra_digits );
+        const int text_scale = a_scale + n_extra_digits;
+        Exact text_value = exact( a );
+        text_value.magnitude = text_value.magnitude*pow10_big( n_extra_digits );
+        if( not extra_digits.empty() ) { text_value.magnitude += to_big_uint( extra_digits ); }
+
+        const int scale = random_scale();
+        const Rounding::Enum rounding = random_rounding();
+        const Outcome expected = outcome_from( rescaled( text_value, text_scale, scale, rounding ) );
+        const Parsing_result_<Decimal_128> r = parse_decimal_128( spec, scale, rounding );
+        const Outcome actual = (r.is_ok()? Outcome{false, native( r.value.units() )} : out_of_range_outcome);
+        check( actual == expected and (r.is_ok()? r.value.scale() == scale : r.error == Parsing_error::range_exceeded),
+            "parse_decimal_128 with scale", a, a_scale, Native( scale ), 0 );
+    }
+
+    template< int scale >
+    void check_fixed_scale( const Native a, const Native b )
+    {
+        using D = Decimal_128_<scale>;
+        const D da = D::from_units( as_int_128( a ) );
+        const D db = D::from_units( as_int_128( b ) );
+        const auto checked = [&]( const Truth is_match, const char* const operation )
+        {
+            check( is_match, operation, a, scale, b, scale );
+        };
+
+        checked( outcome_of( [&]{ return da + db; } ) == sum_outcome( a, scale, b, scale, false ), "+ with fixed scale" );
+        checked( outcome_of( [&]{ return da - db; } ) == sum_outcome( a, scale, b, scale, true ), "- with fixed scale" );
+        checked( outcome_of( [&]{ return -da; } ) == sum_outcome( 0, scale, a, scale, true ), "unary - with fixed scale" );
+        checked( outcome_of( [&]{ return da*db; } ) == product_outcome( a, scale, b, scale, Rounding::half_even ),
+            "* with fixed scale" );
+        checked( outcome_of( [&]{ return da/db; } ) == quotient_outcome( a, scale, b, scale, Rounding::half_even ),
+            "/ with fixed scale" );
+        for( const Rounding::Enum rounding: all_roundings ) {
+            checked( outcome_of( [&]{ return product_of( da, db, rounding ); } )
+                == product_outcome( a, scale, b, scale, rounding ), "product_of with fixed scale" );
+            checked( outcome_of( [&]{ return quotient_of( da, db, rounding ); } )
+                == quotient_outcome( a, scale, b, scale, rounding ), "quotient_of with fixed scale" );
+        }
+
+        const int expected_order = (a < b? -1 : a > b? +1 : 0);
+        checked( compare( da, db ) == expected_order, "compare with fixed scale" );
+        checked( (da < db) == (a < b) and (da <= db) == (a <= b) and (da == db) == (a == b)
+            and (da >= db) == (a >= b) and (da > db) == (a > b) and (da != db) == (a != b),
+            "relational with fixed scale" );
+        checked( str( da ) == decimal_text_of( a, scale ), "str with fixed scale" );
+
+        const Decimal_128 as_decimal = da;
+        checked( native( as_decimal.units() ) == a and as_decimal.scale() == scale, "conversion to Decimal_128" );
+
+        const int b_scale = random_scale();
+        const Rounding::Enum rounding = random_rounding();
+        const Decimal_128 other = Decimal_128::from_units( as_int_128( b ), b_scale );
+        check( outcome_of( [&]{ return D::from( other, rounding ); } )
+            == outcome_from( rescaled( exact( b ), b_scale, scale, rounding ) ),
+            "from with fixed scale", a, scale, b, b_scale );
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        const Native a = random_units();
+        const Native b = random_units();
+        const int a_scale = random_scale();
+        const int b_scale = (m_bits() % 2 == 0? a_scale : random_scale());
+        const Decimal_128 da = Decimal_128::from_units( as_int_128( a ), a_scale );
+        const Decimal_128 db = Decimal_128::from_units( as_int_128( b ), b_scale );
+        const auto checked = [&]( const Truth is_match, const char* const operation )
+        {
+            check( is_match, operation, a, a_scale, b, b_scale );
+        };
+
+        checked( native( da.units() ) == a and da.scale() == a_scale, "from_units" );
+        checked( outcome_of( [&]{ return da + db; } ) == sum_outcome( a, a_scale, b, b_scale, false ), "+" );
+        checked( outcome_of( [&]{ return da - db; } ) == sum_outcome( a, a_scale, b, b_scale, true ), "-" );
+        checked( outcome_of( [&]{ return -da; } ) == sum_outcome( 0, a_scale, a, a_scale, true ), "unary -" );
+        checked( outcome_of( [&]{ return da*db; } ) == product_outcome( a, a_scale, b, b_scale, Rounding::half_even ),
+            "*" );
+        checked( outcome_of( [&]{ return da/db; } ) == quotient_outcome( a, a_scale, b, b_scale, Rounding::half_even ),
+            "/" );
+        for( const Rounding::Enum rounding: all_roundings ) {
+            checked( outcome_of( [&]{ return product_of( da, db, rounding ); } )
+                == product_outcome( a, a_scale, b, b_scale, rounding ), "product_of" );
+            checked( outcome_of( [&]{ return quotient_of( da, db, rounding ); } )
+                == quotient_outcome( a, a_scale, b, b_scale, rounding ), "quotient_of" );
+        }
+
+        const int scale = max( a_scale, b_scale );
+        checked( sum_outcome( a, a_scale, b, b_scale, false ).is_out_of_range or (da + db).scale() == scale,
+            "result scale" );
+
+        const int expected_order = compare(
+            rescaled( exact( a ), a_scale, scale, Rounding::half_even ),
+            rescaled( exact( b ), b_scale, scale, Rounding::half_even )
+            );
+        checked( compare( da, db ) == expected_order, "compare" );
+        checked( (da < db) == (expected_order < 0) and (da <= db) == (expected_order <= 0)
+            and (da == db) == (expected_order == 0) and (da >= db) == (expected_order >= 0)
+            and (da > db) == (expected_order > 0) and (da != db) == (expected_order != 0),
+            "relational" );
+
+        const int new_scale = random_scale();
+        const Rounding::Enum rounding = random_rounding();
+        checked( outcome_of( [&]{ return da.rescaled( new_scale, rounding ); } )
+            == outcome_from( rescaled( exact( a ), a_scale, new_scale, rounding ) ), "rescaled" );
+
+        const Native whole = Native( int64_t( m_bits() ) ) >> (m_bits() % 64);
+        checked( outcome_of( [&]{ return Decimal_128( as_int_128( whole ), a_scale ); } )
+            == outcome_from( rescaled( exact( whole ), 0, a_scale, Rounding::half_even ) ), "from whole number" );
+
+        check_text_conversions( a, a_scale );
+
+        check_fixed_scale<0>( a, b );
+        check_fixed_scale<2>( a, b );
+        check_fixed_scale<19>( a, b );
+        check_fixed_scale<38>( a, b );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 20'000, "Decimal_128 differs from the reference decimal." ); }
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,175 @@
+// Differential fuzzing of `Fixed_uint_` for 256, 512, 1024 and 2048 bits against `Big_uint`
+// with results reduced modulo 2^n, where `Big_uint` is itself fuzzed against a schoolbook
+// implementation. Every result of every operation on random operands is checked for equality.
+// The operands are biased towards edge cases such as 0, 1, powers of 2 and all 1-bits, and
+// units of those values. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -I ../../library fuzz.cpp
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+template< int n_bits >
+auto fixed_uint_from( const uint64_t* const units )
+    -> Fixed_uint_<n_bits>
+{
+    if constexpr( n_bits == 256 ) {
+        return Fixed_uint_<n_bits>( tag::From_parts(),
+            Uint_128( tag::From_parts(), units[0], units[1] ),
+            Uint_128( tag::From_parts(), units[2], units[3] )
+            );
+    } else {
+        return Fixed_uint_<n_bits>( tag::From_parts(),
+            fixed_uint_from<n_bits/2>( units ), fixed_uint_from<n_bits/2>( units + n_bits/128 )
+            );
+    }
+}
+
+template< int n_bits >
+auto big_uint_from( const Fixed_uint_<n_bits>& v )
+    -> Big_uint
+{
+    vector<uint64_t> units;
+    for( int i = 0; i < v.n_units; ++i ) { units.push_back( v.unit( i ) ); }
+    return Big_uint::from_units( units.data(), int( units.size() ) );
+}
+
+auto power_of_2( const int n )
+    -> Big_uint
+{
+    vector<uint64_t> units( n/64 + 1 );
+    units.back() = uint64_t( 1 ) << (n % 64);
+    return Big_uint::from_units( units.data(), int( units.size() ) );
+}
+
+class Fuzzer:
+    public Fuzzer_base
+{
+
+    auto random_units( const int n_units )
+        -> vector<uint64_t>
+    {
+        vector<uint64_t> result( n_units );
+        const int n = int( m_bits() % (64*n_units) );
+        switch( m_bits() % 8 ) {
+            case 0: {                                                   // 0, 1 or 2.
+                result[0] = m_bits() % 3;
+                break;
+            }
+            case 1: {                                                   // All 1-bits, and just below.
+                for( uint64_t& unit: result ) { unit = ~uint64_t(); }
+                result[0] -= m_bits() % 3;
+                break;
+            }
+            case 2: {                                                   // A power of 2.
+                result[n/64] = uint64_t( 1 ) << (n % 64);
+                break;
+            }
+            case 3: {                                                   // Units that are 0 or all 1-bits.
+                for( uint64_t& unit: result ) { unit = (m_bits() % 2 == 0? 0 : ~uint64_t()); }
+                break;
+            }
+            case 4: {                                                   // Random width.
+                for( int i = 0; i <= n/64; ++i ) { result[i] = m_bits(); }
+                result[n/64] >>= 63 - n % 64;
+                break;
+            }
+            default: {
+                for( uint64_t& unit: result ) { unit = m_bits(); }
+            }
+        }
+        return result;
+    }
+
+    void check( const Truth is_match, const char* const operation, const int n_bits, const Big_uint& a, const Big_uint& b )
+    {
+        check_( is_match, operation, [&]
+        {
+            return ""s << n_bits << " bits, a = " << str( a ) << " and b = " << str( b );
+        } );
+    }
+
+    template< int n_bits >
+    void run_iteration_for_width()
+    {
+        using Fixed = Fixed_uint_<n_bits>;
+        using R = typename Fixed::Result_kind;
+
+        const vector<uint64_t> a_units = random_units( Fixed::n_units );
+        const vector<uint64_t> b_units = random_units( Fixed::n_units );
+        const Fixed fa = fixed_uint_from<n_bits>( a_units.data() );
+        const Fixed fb = fixed_uint_from<n_bits>( b_units.data() );
+        const Big_uint a = Big_uint::from_units( a_units.data(), Fixed::n_units );
+        const Big_uint b = Big_uint::from_units( b_units.data(), Fixed::n_units );
+        const Big_uint modulus = power_of_2( n_bits );
+        const Big_uint all_ones = modulus - 1;
+        const uint64_t m = (m_bits() % 2 == 0? m_bits() : m_bits() % 3);
+
+        const auto is_ = [&]( const Fixed& v, const Big_uint& expected ) -> Truth
+        {
+            return big_uint_from( v ) == expected % modulus;
+        };
+
+        check( big_uint_from( fa ) == a, "round trip", n_bits, a, b );
+        check( fa.modulo_64_bits() == a.modulo_64_bits(), "modulo_64_bits", n_bits, a, b );
+        check( is_( fa + fb, a + b ), "+", n_bits, a, b );
+        check( is_( fa - fb, a + modulus - b ), "-", n_bits, a, b );
+        check( is_( fa*fb, a*b ), "*", n_bits, a, b );
+        check( is_( -fa, modulus - a ), "unary -", n_bits, a, b );
+        check( is_( ~fa, all_ones - a ), "~", n_bits, a, b );
+        check( big_uint_from( wide_product_of( fa, fb ) ) == a*b, "wide_product_of", n_bits, a, b );
+        check( big_uint_from( Fixed( -1 ) ) == all_ones and is_( Fixed( m ), m ), "from integer", n_bits, a, b );
+
+        Fixed incremented = fa;
+        ++incremented;
+        check( is_( incremented, a + 1 ), "++", n_bits, a, b );
+        Fixed decremented = fa;
+        --decremented;
+        check( is_( decremented, a + all_ones ), "--", n_bits, a, b );
+
+        check( compare( fa, fb ) == compare( a, b ), "compare", n_bits, a, b );
+        check( (fa < fb) == (a < b) and (fa <= fb) == (a <= b) and (fa == fb) == (a == b)
+            and (fa >= fb) == (a >= b) and (fa > fb) == (a > b) and (fa != fb) == (a != b),
+            "relational", n_bits, a, b );
+
+        Fixed sum = fa;
+        check( (sum.add( fb ) == R::wrapped) == (a + b >= modulus) and is_( sum, a + b ), "add", n_bits, a, b );
+        Fixed difference = fa;
+        check( (difference.subtract( fb ) == R::wrapped) == (a < b) and is_( difference, a + modulus - b ),
+            "subtract", n_bits, a, b );
+
+        if( m == 0 ) {
+            const typename Fixed::Divmod_result r = fa.divmod_by_64_bit( m );
+            check( r.quotient == ~Fixed() and r.remainder == ~Fixed(), "divmod_by_64_bit by 0", n_bits, a, b );
+        } else {
+            const typename Fixed::Divmod_result r = fa.divmod_by_64_bit( m );
+            const Big_uint::Divmod_result expected = a.divmod_by_64_bit( m );
+            check( is_( r.quotient, expected.quotient ) and is_( r.remainder, expected.remainder ),
+                "divmod_by_64_bit", n_bits, a, b );
+            check( is_( fa/m, expected.quotient ) and is_( fa % m, expected.remainder ), "/ and %", n_bits, a, b );
+        }
+
+        check( str( fa ) == str( a ), "str", n_bits, a, b );
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        run_iteration_for_width<256>();
+        run_iteration_for_width<512>();
+        run_iteration_for_width<1024>();
+        run_iteration_for_width<2048>();
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 100'000, "Fixed_uint_ differs from Big_uint." ); }
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,143 @@
+// Differential fuzzing of `Int_128` against the compiler's `__int128`: every result of every
+// operation on random operands is checked for bit-exact equality. The operands are biased
+// towards edge cases such as 0, ±1, the most negative and most positive values, and powers
+// of 2. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -I ../../library fuzz.cpp
+//
+// and also with `-D KS_NO_NATIVE_UINT_128_PLEASE` for the portable implementation.
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#ifndef __SIZEOF_INT128__
+#   error "The fuzzer needs the compiler's `__int128` as reference."
+#endif
+
+#include <stdint.h>
+
+__extension__ typedef __int128 Native;
+__extension__ typedef unsigned __int128 Native_unsigned;
+
+const Native native_min = Native( Native_unsigned( 1 ) << 127 );
+const Native native_max = Native( ~Native_unsigned() >> 1 );
+
+auto native( const Int_128& v )
+    -> Native
+{
+    const Uint_128::Parts& parts = v.bits().representation();
+    return Native( Native_unsigned( parts.parts[1] ) << 64 | parts.parts[0] );
+}
+
+auto as_int_128( const Native v )
+    -> Int_128
+{ return Int_128( tag::From_parts(), uint64_t( v ), uint64_t( Native_unsigned( v ) >> 64 ) ); }
+
+auto decimal_text_of( const Native v )
+    -> string
+{
+    Native_unsigned magnitude = (v < 0? -Native_unsigned( v ) : Native_unsigned( v ));
+    string reversed;
+    do { reversed += char( '0' + int( magnitude % 10 ) );  magnitude /= 10; } while( magnitude != 0 );
+    if( v < 0 ) { reversed += '-'; }
+    return string( reversed.rbegin(), reversed.rend() );
+}
+
+class Fuzzer:
+    public Fuzzer_base
+{
+
+    auto random_value()
+        -> Native
+    {
+        const Native_unsigned full = Native_unsigned( m_bits() ) << 64 | m_bits();
+        const int n = int( m_bits() % 128 );
+        const int delta = int( m_bits() % 3 );
+        switch( m_bits() % 8 ) {
+            case 0:     return Native( delta ) - 1;                                 // -1, 0 or 1.
+            case 1:     return native_min + delta;                                  // Most negative, and just above.
+            case 2:     return native_max - delta;                                  // Most positive, and just below.
+            case 3:     return Native( (Native_unsigned( 1 ) << n) + delta - 1 );   // Around a power of 2.
+            case 4:     return Native( int64_t( m_bits() ) );                       // 64-bit range.
+            case 5:     return Native( full ) >> n;                                 // Random width, either sign.
+            default:    return Native( full );
+        }
+    }
+
+    void check( const Truth is_match, const char* const operation, const Native a, const Native b )
+    {
+        check_( is_match, operation, [&]{ return "a = " + decimal_text_of( a ) + " and b = " + decimal_text_of( b ); } );
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        const Native a = random_value();
+        const Native b = random_value();
+        const Int_128 ia = as_int_128( a );
+        const Int_128 ib = as_int_128( b );
+        using R = Int_128::Result_kind;
+
+        // The native arithmetic is done unsigned where signed overflow would be undefined.
+        const auto wrapped = []( const Native_unsigned v ) -> Native { return Native( v ); };
+        const Native_unsigned ua = Native_unsigned( a );
+        const Native_unsigned ub = Native_unsigned( b );
+
+        check( native( ia ) == a, "round trip", a, b );
+        check( native( ia + ib ) == wrapped( ua + ub ), "+", a, b );
+        check( native( ia - ib ) == wrapped( ua - ub ), "-", a, b );
+        check( native( ia*ib ) == wrapped( ua*ub ), "*", a, b );
+        check( native( -ia ) == wrapped( -ua ), "unary -", a, b );
+        check( compare( ia, ib ) == (a < b? -1 : a > b? +1 : 0), "compare", a, b );
+        check( (ia < ib) == (a < b) and (ia <= ib) == (a <= b) and (ia == ib) == (a == b)
+            and (ia >= ib) == (a >= b) and (ia > ib) == (a > b) and (ia != ib) == (a != b),
+            "relational", a, b );
+
+        check( ia.is_negative() == (a < 0), "is_negative", a, b );
+        check( ia.is_in_64_bit_range() == (a == Native( int64_t( a ) )), "is_in_64_bit_range", a, b );
+        check( Native_unsigned( native( Int_128::from_bits( ia.magnitude() ) ) ) == (a < 0? -ua : ua),
+            "magnitude", a, b );
+        check( native( Int_128( int64_t( a ) ) ) == Native( int64_t( a ) ), "from int64_t", a, b );
+
+        Native result = 0;
+        Int_128 sum = ia;
+        check( (sum.add( ib ) == R::wrapped) == __builtin_add_overflow( a, b, &result )
+            and native( sum ) == wrapped( ua + ub ), "add", a, b );
+        Int_128 difference = ia;
+        check( (difference.subtract( ib ) == R::wrapped) == __builtin_sub_overflow( a, b, &result )
+            and native( difference ) == wrapped( ua - ub ), "subtract", a, b );
+
+        if( b == 0 ) {
+            const Int_128::Divmod_result r = divmod( ia, ib );
+            check( r.quotient == -1 and r.remainder == -1, "divmod by 0", a, b );
+        } else if( a == native_min and b == -1 ) {
+            const Int_128::Divmod_result r = divmod( ia, ib );
+            check( native( r.quotient ) == native_min and r.remainder == 0, "divmod wrapping", a, b );
+        } else {
+            const Int_128::Divmod_result r = divmod( ia, ib );
+            check( native( r.quotient ) == a/b and native( r.remainder ) == a%b, "divmod", a, b );
+            check( native( ia/ib ) == a/b and native( ia%ib ) == a%b, "/ and %", a, b );
+        }
+
+        const string text = str( ia );
+        check( text == decimal_text_of( a ), "str", a, b );
+        const Parsing_result_<Int_128> parsed = parse_int_128( text );
+        check( parsed.is_ok() and native( parsed.value ) == a, "parse_int_128", a, b );
+        if( a >= 0 ) {
+            const Parsing_result_<Int_128> plus_parsed = parse_int_128( "+" + text );
+            check( plus_parsed.is_ok() and native( plus_parsed.value ) == a, "parse_int_128 with +", a, b );
+        } else if( a == native_min ) {
+            check( not parse_int_128( text.substr( 1 ) ).is_ok(), "parse_int_128 range", a, b );
+        }
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 1'000'000, "Int_128 differs from __int128." ); }
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
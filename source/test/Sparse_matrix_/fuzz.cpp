@@ -0,0 +1,130 @@
+// Differential fuzzing of `Sparse_matrix_` against dense matrices: construction from items and
+// from triplets, item access, layout conversion, and the products a·x with a vector, serial
+// and parallel, and a·b with a dense matrix or view, in both the `csr` and `csc` layouts. The
+// dense results are computed by naive loops. The item types are `float`, `double`, `int32_t`
+// and a custom type. The operands are whole matrices, sub-views and transposed views, with
+// from none to all items zero. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -pthread -I ../../library fuzz.cpp
+
+#include "../matrix-fuzzing.hpp"
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+#include <algorithm>        // std::shuffle
+#include <vector>           // std::vector
+
+using std::shuffle, std::vector;
+
+class Fuzzer: public Matrix_fuzzer_base
+{
+    // Mostly sizes up to 60, and now and then up to 300.
+    auto random_extent() -> int
+    {
+        const int max_extent = (m_bits() % 8 == 0? 300 : 60);
+        return 1 + int( m_bits() % max_extent );
+    }
+
+    // Triplets for the items of `m`, where some non-zero items are split in two triplets and
+    // some zero items are given as two triplets that cancel. The triplets are in random order.
+    template< class Item >
+    auto triplets_for( const Matrix_view_<const Item>& m )
+        -> vector<Triplet_<Item>>
+    {
+        vector<Triplet_<Item>> result;
+        for( int y = 0; y < m.height(); ++y ) {
+            for( int x = 0; x < m.width(); ++x ) {
+                const Item item = m( x, y );
+                if( m_bits() % 4 == 0 ) {
+                    const int part = random_item();
+                    result.push_back( Triplet_<Item>{ x, y, Item( part ) } );
+                    result.push_back( Triplet_<Item>{ x, y, item + Item( -part ) } );
+                } else if( item != Item() ) {
+                    result.push_back( Triplet_<Item>{ x, y, item } );
+                }
+            }
+        }
+        shuffle( result.begin(), result.end(), m_bits );
+        return result;
+    }
+
+    template< class Item >
+    void check_sparse( const char* const item_type_name )
+    {
+        const int h = random_extent();
+        const int w = random_extent();
+        const int b_width = 1 + int( m_bits() % 20 );
+        const int zero_percent = int( m_bits() % 5 )*25;
+        const auto layout = Sparse_layout::Enum( m_bits() % 2 );
+        const auto other_layout = (layout == Sparse_layout::csr? Sparse_layout::csc : Sparse_layout::csr);
+        const int source = int( m_bits() % 3 );
+
+        Matrix_<Item> m_storage, b_storage;
+        string m_kind, b_kind;
+        const Matrix_view_<const Item> m = random_view( grid::Size{ w, h }, m_storage, m_kind, zero_percent );
+        const Matrix_view_<const Item> b = random_view( grid::Size{ b_width, w }, b_storage, b_kind );
+        const int grain_size = int( m_bits() % 64 );
+
+        const auto operands = [&]
+        {
+            return ""s << item_type_name
+                << ", a " << h << "×" << w << " " << (layout == Sparse_layout::csr? "csr" : "csc")
+                << " from " << (source == 0? "items of a " : source == 1? "a Matrix_ copy of a " : "triplets for a ")
+                << m_kind << " with " << zero_percent << "% zeroes"
+                << ", b " << w << "×" << b_width << " " << b_kind << " and grain size " << grain_size;
+        };
+
+        const Sparse_matrix_<Item> a = (
+            source == 0?    Sparse_matrix_<Item>( m, layout ) :
+            source == 1?    Sparse_matrix_<Item>( copy_of( m ), layout ) :
+                            Sparse_matrix_<Item>( grid::Size{ w, h }, triplets_for( m ), layout )
+            );
+
+        bool items_match = (a.layout() == layout and a.width() == w and a.height() == h);
+        for( int y = 0; y < h; ++y ) {
+            for( int x = 0; x < w; ++x ) { items_match = items_match and a( x, y ) == m( x, y ); }
+        }
+        check_( items_match, "item access", operands );
+        check_( is_equal<Item>( view_of( a.to_matrix() ), m ), "to_matrix", operands );
+        check_( is_equal<Item>( view_of( a.converted_to( other_layout ).to_matrix() ), m ),
+            "converted_to", operands
+            );
+
+        vector<Item> x( w );
+        for( Item& item: x ) { item = Item( random_item() ); }
+        vector<Item> product( h );
+        for( int y = 0; y < h; ++y ) {
+            for( int i = 0; i < w; ++i ) { product[y] = product[y] + m( i, y )*x[i]; }
+        }
+        check_( multiply( a, x ) == product, "multiply with a vector", operands );
+        check_( parallel::multiply( a, x, grain_size ) == product, "parallel::multiply with a vector", operands );
+
+        const Matrix_<Item> matrix_product = reference_product( m, b );
+        check_( is_equal<Item>( view_of( multiply( a, b ) ), view_of( matrix_product ) ),
+            "multiply with a view", operands
+            );
+        check_( is_equal<Item>( view_of( multiply( a, copy_of( b ) ) ), view_of( matrix_product ) ),
+            "multiply with a Matrix_", operands
+            );
+    }
+
+public:
+    using Matrix_fuzzer_base::Matrix_fuzzer_base;
+
+    void run_iteration()
+    {
+        Thread_pool::singleton().set_n_threads( 1 + int( m_bits() % 4 ) );
+        check_sparse<float>( "float" );
+        check_sparse<double>( "double" );
+        check_sparse<int32_t>( "int32_t" );
+        check_sparse<Int_item>( "Int_item" );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 1000, "A sparse matrix result differs from the dense result." ); }
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,153 @@
+// Micro-benchmark of `Uint_128` operations, in nanoseconds per operation, for a few value
+// distributions. Where the compiler offers `unsigned __int128` the same operations are timed
+// for that type, as a baseline. Build with optimization, e.g.
+//
+//      g++ -std=c++17 -O2 -I ../../library benchmark.cpp
+//
+// and possibly with `-D KS_NO_NATIVE_UINT_128_PLEASE` to time the portable implementation.
+
+#include <kickstart/all.hpp>
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace chrono = std::chrono;
+using   std::mt19937_64, std::vector;
+
+using Clock = chrono::steady_clock;
+
+const int n_values = 1 << 12;
+
+struct Distribution{ enum Enum{ small, bits_64, mixed_widths, full, _ }; };
+
+auto name_of( const Distribution::Enum d )
+    -> string
+{
+    static const char* const names[] = { "< 2^32", "< 2^64", "mixed widths", "full 128 bits" };
+    return names[d];
+}
+
+auto random_values( const Distribution::Enum d, mt19937_64& bits )
+    -> vector<Uint_128>
+{
+    vector<Uint_128> result;
+    for( int i = 0; i < n_values; ++i ) {
+        const auto full = Uint_128( tag::From_parts(), bits(), bits() );
+        const auto value = (0?Uint_128()
+            : d == Distribution::small?         full >> 96
+            : d == Distribution::bits_64?       full >> 64
+            : d == Distribution::mixed_widths?  full >> int( bits() % 128 )
+            :                                   full
+            );
+        result.push_back( value == 0? Uint_128( 1 ) : value );     // Non-zero, for divisors.
+    }
+    return result;
+}
+
+volatile uint64_t sink;     // Receives the xor of the results, to keep the operations.
+
+auto folded( const Uint_128& v ) -> uint64_t { return v.representation().parts[0] ^ v.representation().parts[1]; }
+auto folded_divmod( const Uint_128& a, const Uint_128& b ) -> uint64_t { const auto r = divmod( a, b ); return folded( r.quotient ) ^ folded( r.remainder ); }
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 Native;
+
+    auto native( const Uint_128& v ) -> Native { return Native( v.representation().parts[1] ) << 64 | v.representation().parts[0]; }
+    auto folded( const Native v ) -> uint64_t { return uint64_t( v ) ^ uint64_t( v >> 64 ); }
+    auto folded_divmod( const Native a, const Native b ) -> uint64_t { return folded( a/b ) ^ folded( a%b ); }
+#endif
+
+// Calls `op( i )` for i in [0, n_values) repeatedly until at least 50 ms have passed. Each
+// call returns a 64-bit digest of its result.
+template< class Op >
+auto ns_per_op( const Op& op )
+    -> double
+{
+    long n_ops = 0;
+    uint64_t digest = 0;
+    const auto start = Clock::now();
+    for( ;; ) {
+        for( int i = 0; i < n_values; ++i ) { digest ^= op( i ); }
+        n_ops += n_values;
+        const auto elapsed = chrono::duration<double, std::nano>( Clock::now() - start ).count();
+        if( elapsed >= 50e6 ) {
+            sink = digest;
+            return elapsed/double( n_ops );
+        }
+    }
+}
+
+struct Arithmetic_timings{ double add; double mul; double divmod; };
+
+template< class Value >
+auto arithmetic_timings( const vector<Value>& a, const vector<Value>& b )
+    -> Arithmetic_timings
+{
+    return Arithmetic_timings{
+        ns_per_op( [&]( const int i ) { return folded( a[i] + b[i] ); } ),
+        ns_per_op( [&]( const int i ) { return folded( a[i]*b[i] ); } ),
+        ns_per_op( [&]( const int i ) { return folded_divmod( a[i], b[i] ); } )
+        };
+}
+
+void display( const string& operation, const Distribution::Enum d, const double ns, const double native_ns = 0 )
+{
+    string line = operation + spaces( 10 - int( operation.size() ) );
+    line += name_of( d ) + spaces( 16 - int( name_of( d ).size() ) );
+    const string ns_text = to_fixed( ns, 2 );
+    line += spaces( 10 - int( ns_text.size() ) ) + ns_text;
+    if( native_ns > 0 ) {
+        const string native_ns_text = to_fixed( native_ns, 2 );
+        line += spaces( 14 - int( native_ns_text.size() ) ) + native_ns_text;
+    }
+    out << line << endl;
+}
+
+void cpp_main()
+{
+    #ifdef KS_HAS_NATIVE_UINT_128
+        const string implementation = "native";
+    #else
+        const string implementation = "portable";
+    #endif
+    #ifdef __SIZEOF_INT128__
+        const string baseline_heading = "    __int128 ns";
+    #else
+        const string baseline_heading = "";
+    #endif
+
+    out << "Uint_128 (" << implementation << " implementation), nanoseconds per operation." << endl;
+    out << endl;
+    out << "operation values            ns/op" << baseline_heading << endl;
+
+    auto bits = mt19937_64( 42 );
+    for( int i = 0; i < Distribution::_; ++i ) {
+        const auto d = Distribution::Enum( i );
+        const vector<Uint_128> a = random_values( d, bits );
+        const vector<Uint_128> b = random_values( d, bits );
+
+        const Arithmetic_timings t = arithmetic_timings( a, b );
+        Arithmetic_timings native_t = {};
+        #ifdef __SIZEOF_INT128__
+            vector<Native> native_a, native_b;
+            for( int j = 0; j < n_values; ++j ) {
+                native_a.push_back( native( a[j] ) );  native_b.push_back( native( b[j] ) );
+            }
+            native_t = arithmetic_timings( native_a, native_b );
+        #endif
+        display( "add", d, t.add, native_t.add );
+        display( "mul", d, t.mul, native_t.mul );
+        display( "divmod", d, t.divmod, native_t.divmod );
+
+        vector<string> texts;
+        for( const Uint_128& v: a ) { texts.push_back( str( v ) ); }
+        display( "str", d, ns_per_op( [&]( const int j ) { return str( a[j] ).size(); } ) );
+        display( "parse", d, ns_per_op( [&]( const int j ) { return folded( parse_uint_128( texts[j] ).value ); } ) );
+    }
+}
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,126 @@
+// Differential fuzzing of `Uint_128` against the compiler's `unsigned __int128`: every result
+// of every operation on random operands is checked for bit-exact equality. The operands are
+// biased towards edge cases such as 0, 1, powers of 2 and all 1-bits. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -I ../../library fuzz.cpp
+//
+// and also with `-D KS_NO_NATIVE_UINT_128_PLEASE` for the portable implementation, and with
+// `-D KS_TEST_DIVISION_PLEASE` so that division doesn't take the shortcuts for small values.
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#ifndef __SIZEOF_INT128__
+#   error "The fuzzer needs the compiler's `unsigned __int128` as reference."
+#endif
+
+#include <stdint.h>
+
+__extension__ typedef unsigned __int128 Native;
+
+auto native( const Uint_128& v ) -> Native { return Native( v.representation().parts[1] ) << 64 | v.representation().parts[0]; }
+auto as_uint_128( const Native v ) -> Uint_128 { return Uint_128( tag::From_parts(), uint64_t( v ), uint64_t( v >> 64 ) ); }
+
+auto decimal_text_of( Native v )
+    -> string
+{
+    string reversed;
+    do { reversed += char( '0' + int( v % 10 ) );  v /= 10; } while( v != 0 );
+    return string( reversed.rbegin(), reversed.rend() );
+}
+
+auto native_bit_count_from_top( const Native v )
+    -> int
+{
+    const auto high = uint64_t( v >> 64 );
+    return (high != 0? __builtin_clzll( high ) : uint64_t( v ) != 0? 64 + __builtin_clzll( uint64_t( v ) ) : 128);
+}
+
+class Fuzzer:
+    public Fuzzer_base
+{
+
+    auto random_value()
+        -> Native
+    {
+        const Native full = Native( m_bits() ) << 64 | m_bits();
+        const int n = int( m_bits() % 128 );
+        switch( m_bits() % 8 ) {
+            case 0:     return Native( m_bits() % 3 );                          // 0, 1 or 2.
+            case 1:     return ~Native() - m_bits() % 3;                        // All 1-bits, and just below.
+            case 2:     return (Native( 1 ) << n) + Native( m_bits() % 3 ) - 1; // Around a power of 2.
+            case 3:     return full >> 64;                                      // 64 bits.
+            case 4:     return full << 64;                                      // Only the high word.
+            case 5:     return full >> n;                                       // Random width.
+            default:    return full;
+        }
+    }
+
+    void check( const Truth is_match, const char* const operation, const Native a, const Native b )
+    {
+        check_( is_match, operation, [&]{ return "a = " + decimal_text_of( a ) + " and b = " + decimal_text_of( b ); } );
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        const Native a = random_value();
+        const Native b = random_value();
+        const Uint_128 ua = as_uint_128( a );
+        const Uint_128 ub = as_uint_128( b );
+        const int n = int( m_bits() % 128 );
+        using R = Uint_128::Result_kind;
+
+        check( native( ua ) == a, "round trip", a, b );
+        check( native( ua + ub ) == a + b, "+", a, b );
+        check( native( ua - ub ) == a - b, "-", a, b );
+        check( native( ua*ub ) == a*b, "*", a, b );
+        check( native( ua & ub ) == (a & b), "&", a, b );
+        check( native( ua | ub ) == (a | b), "|", a, b );
+        check( native( ua ^ ub ) == (a ^ b), "^", a, b );
+        check( native( ~ua ) == ~a, "~", a, b );
+        check( native( ua << n ) == a << n, "<<", a, n );
+        check( native( ua >> n ) == a >> n, ">>", a, n );
+        check( compare( ua, ub ) == (a < b? -1 : a > b? +1 : 0), "compare", a, b );
+        check( (ua < ub) == (a < b) and (ua == ub) == (a == b), "relational", a, b );
+
+        check( countl_zero( ua ) == native_bit_count_from_top( a ), "countl_zero", a, b );
+        check( popcount( ua ) == __builtin_popcountll( uint64_t( a ) ) + __builtin_popcountll( uint64_t( a >> 64 ) ),
+            "popcount", a, b );
+
+        Native wrapped = 0;
+        Uint_128 sum = ua;
+        check( (sum.add( ub ) == R::wrapped) == __builtin_add_overflow( a, b, &wrapped ), "add overflow", a, b );
+        Uint_128 difference = ua;
+        check( (difference.subtract( ub ) == R::wrapped) == __builtin_sub_overflow( a, b, &wrapped ), "subtract overflow", a, b );
+        Uint_128 product = ua;
+        check( (product.multiply( ub ) == R::wrapped) == __builtin_mul_overflow( a, b, &wrapped ), "multiply overflow", a, b );
+
+        if( b != 0 ) {
+            const Uint_128::Divmod_result r = divmod( ua, ub );
+            check( native( r.quotient ) == a/b and native( r.remainder ) == a%b, "divmod", a, b );
+            check( native( ua/ub ) == a/b and native( ua%ub ) == a%b, "/ and %", a, b );
+
+            const auto b_64 = uint64_t( b );
+            if( b_64 != 0 ) {
+                const Uint_128::Divmod_result r64 = ua.divmod_by_64_bit( b_64 );
+                check( native( r64.quotient ) == a/b_64 and native( r64.remainder ) == a%b_64, "divmod_by_64_bit", a, b_64 );
+            }
+        }
+
+        const string text = str( ua );
+        check( text == decimal_text_of( a ), "str", a, b );
+        const Parsing_result_<Uint_128> parsed = parse_uint_128( text );
+        check( parsed.is_ok() and native( parsed.value ) == a, "parse_uint_128", a, b );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 1'000'000, "Uint_128 differs from unsigned __int128." ); }
+
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,60 @@
+#pragma once
+// Support for the differential fuzzers in the sub-directories, e.g. `Uint_128/fuzz.cpp`. A
+// fuzzer class derives from `Fuzzer_base`, provides `run_iteration()`, and reports each
+// comparison with its reference via `check_`. `run_fuzzer_<Fuzzer>` is the body of `cpp_main`,
+// with the command line
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// It fails, which gives a non-zero exit code, if any mismatch was found.
+
+#include <kickstart/all.hpp>
+
+#include <stdint.h>
+
+#include <random>
+
+class Fuzzer_base
+{
+protected:
+    std::mt19937_64     m_bits;
+    long                m_n_checks      = 0;
+    long                m_n_mismatches  = 0;
+
+    // The first 20 mismatches are reported as "Mismatch for `operation` with `operands()`.",
+    // where the text of the operands is only produced for a reported mismatch.
+    template< class Operands_text_func >
+    void check_( const bool is_match, const char* const operation, const Operands_text_func& operands )
+    {
+        using kickstart::all::out, kickstart::all::endl;
+        ++m_n_checks;
+        if( is_match ) { return; }
+        ++m_n_mismatches;
+        if( m_n_mismatches <= 20 ) {
+            out << "Mismatch for " << operation << " with " << operands() << "." << endl;
+        }
+    }
+
+public:
+    Fuzzer_base( const uint64_t seed ): m_bits( seed ) {}
+
+    auto n_checks() const -> long { return m_n_checks; }
+    auto n_mismatches() const -> long { return m_n_mismatches; }
+};
+
+template< class Fuzzer >
+void run_fuzzer_( const long default_n_iterations, const char* const failure_message )
+{
+    using namespace kickstart::all;
+    const auto& args = process::the_commandline().args();
+    const long n_iterations = (args.size() >= 1? to_<int>( args[0] ) : default_n_iterations);
+    const uint64_t seed = (args.size() >= 2? to_<int>( args[1] ) : 42);
+
+    auto fuzzer = Fuzzer( seed );
+    for( long i = 0; i < n_iterations; ++i ) { fuzzer.run_iteration(); }
+
+    out << fuzzer.n_checks() << " checks in " << n_iterations << " iterations with seed " << seed
+        << ", " << fuzzer.n_mismatches() << " mismatches." << endl;
+    hopefully( fuzzer.n_mismatches() == 0 )
+        or KS_FAIL( failure_message );
+}
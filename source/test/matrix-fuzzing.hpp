@@ -0,0 +1,103 @@
+#pragma once
+// Support for the differential fuzzers of matrix operations, e.g. `multiplication/fuzz.cpp`.
+// `Matrix_fuzzer_base` adds random items and random views to `Fuzzer_base`, and the reference
+// results are computed by naive loops. The items are small integers so that also `float` and
+// `double` results are exact.
+
+#include "fuzzing.hpp"
+
+#include <stdint.h>
+
+namespace grid = kickstart::matrices::two_d_grid;
+using kickstart::matrices::Matrix_, kickstart::matrices::Matrix_view_;
+
+// An item type without a SIMD micro-kernel, with only the operations that the library requires.
+struct Int_item
+{
+    int64_t value;
+
+    Int_item( const int64_t v = 0 ): value( v ) {}
+
+    friend auto operator+( const Int_item& a, const Int_item& b ) -> Int_item { return a.value + b.value; }
+    friend auto operator*( const Int_item& a, const Int_item& b ) -> Int_item { return a.value*b.value; }
+    friend auto operator==( const Int_item& a, const Int_item& b ) -> bool { return a.value == b.value; }
+    friend auto operator!=( const Int_item& a, const Int_item& b ) -> bool { return a.value != b.value; }
+};
+
+template< class Item >
+auto reference_product(
+    const Matrix_view_<const Item>&     a,
+    const Matrix_view_<const Item>&     b
+    ) -> Matrix_<Item>
+{
+    Matrix_<Item> result( b.width(), a.height() );
+    for( int y = 0; y < a.height(); ++y ) {
+        for( int x = 0; x < b.width(); ++x ) {
+            Item sum = Item();
+            for( int k = 0; k < a.width(); ++k ) { sum = sum + a( k, y )*b( x, k ); }
+            result( x, y ) = sum;
+        }
+    }
+    return result;
+}
+
+template< class Item >
+auto is_equal(
+    const Matrix_view_<const Item>&     a,
+    const Matrix_view_<const Item>&     b
+    ) -> bool
+{
+    if( a.width() != b.width() or a.height() != b.height() ) { return false; }
+    for( int y = 0; y < a.height(); ++y ) {
+        for( int x = 0; x < a.width(); ++x ) {
+            if( a( x, y ) != b( x, y ) ) { return false; }
+        }
+    }
+    return true;
+}
+
+class Matrix_fuzzer_base: public Fuzzer_base
+{
+protected:
+    // An integer in the range -8 through 8, and with `zero_percent` > 0 that percentage zeroes.
+    auto random_item( const int zero_percent = 0 ) -> int
+    {
+        if( zero_percent > 0 and int( m_bits() % 100 ) < zero_percent ) { return 0; }
+        return int( m_bits() % 17 ) - 8;
+    }
+
+    // A view of `size` random items, stored in `storage` as a whole matrix, a sub-view or a
+    // transposed view, with a random row layout. `kind` is set to a description.
+    template< class Item >
+    auto random_view(
+        const grid::Size    size,
+        Matrix_<Item>&      storage,
+        std::string&        kind,
+        const int           zero_percent = 0
+        ) -> Matrix_view_<Item>
+    {
+        using namespace kickstart::all;
+        const auto layout = Row_layout::Enum( m_bits() % 3 );
+        const bool is_transposed = (m_bits() % 3 == 0);
+        const bool is_sub_view = (m_bits() % 3 == 0);
+        const grid::Size storage_size = (is_transposed? grid::Size{ size.h, size.w } : size);
+        const grid::Position offset = (is_sub_view?
+            grid::Position{ int( m_bits() % 5 ), int( m_bits() % 5 ) } : grid::Position{ 0, 0 }
+            );
+        const int margin = (is_sub_view? int( m_bits() % 5 ) : 0);
+
+        storage = Matrix_<Item>(
+            grid::Size{ storage_size.w + offset.x + margin, storage_size.h + offset.y + margin }, layout
+            );
+        for( int y = 0; y < storage.height(); ++y ) {
+            for( int x = 0; x < storage.width(); ++x ) { storage( x, y ) = Item( random_item( zero_percent ) ); }
+        }
+
+        const auto view = view_of( storage ).sub_view( offset, storage_size );
+        kind = ""s << (is_transposed? "transposed " : "") << (is_sub_view? "sub-" : "") << "view";
+        return (is_transposed? view.transposed() : view);
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+};
@@ -0,0 +1,87 @@
+// Differential fuzzing of the matrix `multiply` and `multiply_add`, serial and parallel, against
+// a naive triple loop. The item types are `float`, `double` and `int32_t`, which have micro-kernels with
+// SIMD instructions when available, and a custom type that uses the scalar micro-kernel. The
+// sizes are mostly not multiples of the tile sizes, and now and then exceed the block sizes.
+// The operands and the result are whole matrices, sub-views and transposed views. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -pthread -I ../../library fuzz.cpp
+//
+// and also with `-march=native` for the SIMD micro-kernels.
+
+#include "../matrix-fuzzing.hpp"
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+class Fuzzer: public Matrix_fuzzer_base
+{
+    // Mostly sizes up to 40, which includes many edge tiles, and now and then up to 400.
+    auto random_extent() -> int
+    {
+        const int max_extent = (m_bits() % 8 == 0? 400 : 40);
+        return 1 + int( m_bits() % max_extent );
+    }
+
+    template< class Item >
+    void check_products_of( const char* const item_type_name )
+    {
+        const int h = random_extent();
+        const int w = random_extent();
+        const int depth = random_extent();
+        if( double( h )*w*depth > 4e6 ) { return; }
+
+        Matrix_<Item> a_storage, b_storage, c_storage;
+        string a_kind, b_kind, c_kind;
+        const Matrix_view_<const Item> a = random_view( grid::Size{ depth, h }, a_storage, a_kind );
+        const Matrix_view_<const Item> b = random_view( grid::Size{ w, depth }, b_storage, b_kind );
+        const Matrix_view_<Item> c = random_view( grid::Size{ w, h }, c_storage, c_kind );
+        const int grain_size = int( m_bits() % 64 );
+
+        const auto operands = [&]
+        {
+            return ""s << item_type_name
+                << ", a " << h << "×" << depth << " " << a_kind << ", b " << depth << "×" << w << " " << b_kind
+                << ", c " << c_kind << " and grain size " << grain_size;
+        };
+
+        const Matrix_<Item> product = reference_product( a, b );
+        Matrix_<Item> sum = copy_of( c );
+        for( int y = 0; y < h; ++y ) {
+            for( int x = 0; x < w; ++x ) { sum( x, y ) = sum( x, y ) + product( x, y ); }
+        }
+
+        check_( is_equal<Item>( view_of( multiply( a, b ) ), view_of( product ) ), "multiply", operands );
+        check_( is_equal<Item>( view_of( parallel::multiply( a, b, grain_size ) ), view_of( product ) ),
+            "parallel::multiply", operands
+            );
+
+        const Matrix_<Item> original_c = copy_of( c );
+        multiply_add( a, b, c );
+        check_( is_equal<Item>( c, view_of( sum ) ), "multiply_add", operands );
+
+        for( int y = 0; y < h; ++y ) {
+            for( int x = 0; x < w; ++x ) { c( x, y ) = original_c( x, y ); }
+        }
+        parallel::multiply_add( a, b, c, grain_size );
+        check_( is_equal<Item>( c, view_of( sum ) ), "parallel::multiply_add", operands );
+    }
+
+public:
+    using Matrix_fuzzer_base::Matrix_fuzzer_base;
+
+    void run_iteration()
+    {
+        Thread_pool::singleton().set_n_threads( 1 + int( m_bits() % 4 ) );
+        check_products_of<float>( "float" );
+        check_products_of<double>( "double" );
+        check_products_of<int32_t>( "int32_t" );
+        check_products_of<Int_item>( "Int_item" );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 1000, "A matrix product differs from the naive product." ); }
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,222 @@
+// Differential fuzzing of `is_prime` and `primes_in` against simple references: trial division
+// plus a Miller-Rabin test with 24 random bases, computed with the compiler's `unsigned __int128`,
+// and a plain sieve of Eratosthenes. The `Uint_128` values are random with from 65 to 128 bits,
+// random primes above ψ13 ≈ 3.3·10^24 where `is_prime` uses the Baillie-PSW test, products of
+// two 64-bit primes, squares of primes, and the Mersenne primes 2^89 - 1, 2^107 - 1 and
+// 2^127 - 1. The `primes_in` ranges are below 2^44, some straddle 2^40 where the sieving
+// changes, and the sieving uses from 1 to 4 threads. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -pthread -I ../../library fuzz.cpp
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#ifndef __SIZEOF_INT128__
+#   error "The fuzzer needs the compiler's `unsigned __int128` for the reference."
+#endif
+
+#include <stdint.h>
+
+#include <vector>           // std::vector
+
+using std::vector;
+
+__extension__ typedef unsigned __int128 Native;
+
+auto as_uint_128( const Native v ) -> Uint_128 { return Uint_128( tag::From_parts(), uint64_t( v ), uint64_t( v >> 64 ) ); }
+
+auto hex_text_of( const Native v )
+    -> string
+{
+    string result;
+    for( int i_bit = 124; i_bit >= 0; i_bit -= 4 ) {
+        const int digit = int( v >> i_bit ) & 0xF;
+        if( digit != 0 or not result.empty() or i_bit == 0 ) { result += "0123456789ABCDEF"[digit]; }
+    }
+    return "0x" + result;
+}
+
+// The odd primes below `limit`, by a plain sieve of Eratosthenes.
+auto odd_primes_below( const uint64_t limit )
+    -> vector<uint64_t>
+{
+    vector<bool> is_composite( limit, false );
+    vector<uint64_t> result;
+    for( uint64_t n = 3; n < limit; n += 2 ) {
+        if( is_composite[n] ) { continue; }
+        result.push_back( n );
+        for( uint64_t multiple = n*n; multiple < limit; multiple += 2*n ) { is_composite[multiple] = true; }
+    }
+    return result;
+}
+
+// Modular arithmetic by additions only, so that no intermediate result exceeds 128 bits.
+auto sum_mod( const Native a, const Native b, const Native m ) -> Native { return (a >= m - b? a - (m - b) : a + b); }
+
+auto product_mod( const Native a, Native b, const Native m )
+    -> Native
+{
+    Native result = 0;
+    for( int i_bit = 127; i_bit >= 0; --i_bit ) {
+        result = sum_mod( result, result, m );
+        if( (b >> i_bit) & 1 ) { result = sum_mod( result, a, m ); }
+    }
+    return result;
+}
+
+auto power_mod( const Native base, const Native exponent, const Native m )
+    -> Native
+{
+    Native result = 1;
+    for( int i_bit = 127; i_bit >= 0; --i_bit ) {
+        result = product_mod( result, result, m );
+        if( (exponent >> i_bit) & 1 ) { result = product_mod( result, base, m ); }
+    }
+    return result;
+}
+
+class Fuzzer: public Fuzzer_base
+{
+    static constexpr uint64_t   max_range_end   = uint64_t( 1 ) << 44;
+
+    vector<uint64_t>    m_odd_primes;       // All below 2^22, the square root of `max_range_end`.
+
+    auto random_native() -> Native { return Native( m_bits() ) << 64 | m_bits(); }
+
+    // A random value with `n_bits` significant bits.
+    auto random_native( const int n_bits ) -> Native
+    {
+        const Native top_bit = Native( 1 ) << (n_bits - 1);
+        return top_bit | (random_native() & (top_bit - 1));
+    }
+
+    auto is_strong_probable_prime( const Native n, const Native base ) -> bool
+    {
+        Native d = n - 1;
+        int s = 0;
+        while( (d & 1) == 0 ) { d >>= 1;  ++s; }
+        Native x = power_mod( base, d, n );
+        if( x == 1 or x == n - 1 ) { return true; }
+        for( int i = 1; i < s; ++i ) {
+            x = product_mod( x, x, n );
+            if( x == n - 1 ) { return true; }
+        }
+        return false;
+    }
+
+    auto reference_is_prime( const Native n ) -> bool
+    {
+        if( n < 2 ) { return false; }
+        if( n % 2 == 0 ) { return n == 2; }
+        for( int i = 0; i < 200; ++i ) {
+            const uint64_t p = m_odd_primes[i];
+            if( n % p == 0 ) { return n == p; }
+        }
+        if( n < Native( m_odd_primes[200] )*m_odd_primes[200] ) { return true; }
+        for( int i = 0; i < 24; ++i ) {
+            const Native base = 2 + random_native() % (n - 3);
+            if( not is_strong_probable_prime( n, base ) ) { return false; }
+        }
+        return true;
+    }
+
+    auto random_prime( const int n_bits ) -> Native
+    {
+        for( ;; ) {
+            const Native n = random_native( n_bits ) | 1;
+            if( reference_is_prime( n ) ) { return n; }
+        }
+    }
+
+    void check_is_prime( const Native n, const bool expected, const char* const kind )
+    {
+        check_( is_prime( as_uint_128( n ) ) == expected, "is_prime", [&]
+        {
+            return ""s << kind << " " << hex_text_of( n ) << ", expected " << (expected? "prime" : "composite");
+        } );
+    }
+
+    // The primes in [first, beyond) by sieving the range with all primes below √beyond.
+    auto reference_primes_in( const uint64_t first, const uint64_t beyond )
+        -> vector<uint64_t>
+    {
+        vector<bool> is_composite( beyond - first, false );
+        for( const uint64_t p: m_odd_primes ) {
+            if( p*p >= beyond ) { break; }
+            const uint64_t first_multiple = (first <= p*p? p*p : (first + p - 1)/p*p);
+            for( uint64_t multiple = first_multiple; multiple < beyond; multiple += p ) {
+                is_composite[multiple - first] = true;
+            }
+        }
+        vector<uint64_t> result;
+        for( uint64_t n = first; n < beyond; ++n ) {
+            if( n == 2 or (n > 2 and n % 2 == 1 and not is_composite[n - first]) ) { result.push_back( n ); }
+        }
+        return result;
+    }
+
+    void check_primes_in()
+    {
+        const int n_threads = 1 + int( m_bits() % 4 );
+        const uint64_t length = (0?0
+            : m_bits() % 4 == 0?    m_bits() % 10
+            : m_bits() % 4 == 0?    m_bits() % 300'000
+            :                       m_bits() % 20'000
+            );
+        const uint64_t first = (m_bits() % 4 == 0?
+            (uint64_t( 1 ) << 40) - m_bits() % (2*length + 1)
+            : (m_bits() % max_range_end) >> (m_bits() % 45)
+            );
+        const uint64_t beyond = first + length;
+
+        const vector<uint64_t> expected = reference_primes_in( first, beyond );
+        const auto range = [&]
+        {
+            return ""s << "[" << first << ", " << beyond << ") and "
+                << n_threads << (n_threads == 1? " thread" : " threads");
+        };
+        check_( primes_in( first, beyond, n_threads ) == expected, "primes_in", range );
+
+        vector<uint64_t> primes;
+        for_each_prime_in( first, beyond, [&]( const uint64_t p ) { primes.push_back( p ); } );
+        check_( primes == expected, "for_each_prime_in", range );
+    }
+
+public:
+    Fuzzer( const uint64_t seed ):
+        Fuzzer_base( seed ),
+        m_odd_primes( odd_primes_below( uint64_t( 1 ) << 22 ) )
+    {}
+
+    void run_iteration()
+    {
+        const uint64_t n_64 = m_bits() >> (m_bits() % 64);
+        const bool expected_64 = reference_is_prime( n_64 );
+        check_( is_prime( n_64 ) == expected_64, "is_prime", [&]
+        {
+            return ""s << "64-bit value " << n_64 << ", expected " << (expected_64? "prime" : "composite");
+        } );
+
+        const Native n = random_native( 65 + int( m_bits() % 64 ) );
+        check_is_prime( n, reference_is_prime( n ), "random value" );
+        check_is_prime( random_prime( 82 + int( m_bits() % 47 ) ), true, "prime above ψ13" );
+
+        const Native p = random_prime( 33 + int( m_bits() % 32 ) );
+        const Native q = random_prime( 33 + int( m_bits() % 32 ) );
+        check_is_prime( p*q, false, "product of primes" );
+        check_is_prime( p*p, false, "square of a prime" );
+
+        for( const int n_bits: {89, 107, 127} ) {
+            check_is_prime( (Native( 1 ) << n_bits) - 1, true, "Mersenne prime" );
+        }
+
+        check_primes_in();
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 200, "A primality result differs from the reference." ); }
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }
@@ -0,0 +1,85 @@
+// Differential fuzzing of the MSD radix sort `batch::radix_sort` against `std::sort`. The value
+// counts are biased towards the small sizes and the sizes around `max_comparison_sort_size`,
+// where buckets switch between radix passes and comparison sorting. The values are random,
+// random below a power of 2, with a common random high part, or picked from a few distinct
+// values, and the input is in random, ascending or descending order. The sorts use from 1 to
+// 4 threads. Usage:
+//
+//      fuzz [N_ITERATIONS [SEED]]
+//
+// The exit code is non-zero if any mismatch was found. Build e.g. with
+//
+//      g++ -std=c++17 -O2 -pthread -I ../../library fuzz.cpp
+
+#include "../fuzzing.hpp"
+using namespace kickstart::all;
+
+#include <stdint.h>
+
+#include <algorithm>        // std::(reverse, sort)
+#include <vector>           // std::vector
+
+using std::reverse, std::sort, std::vector;
+
+class Fuzzer: public Fuzzer_base
+{
+    auto random_uint_128() -> Uint_128 { return Uint_128( tag::From_parts(), m_bits(), m_bits() ); }
+
+    auto random_n_values() -> Size
+    {
+        switch( m_bits() % 8 ) {
+            case 0:     return Size( m_bits() % 5 );
+            case 1:     return Size( 120 + m_bits() % 20 );
+            case 2:     return Size( 256*(1 + m_bits() % 4) + m_bits() % 3 - 1 );
+            case 3:     return Size( m_bits() % 100'000 );
+            default:    return Size( m_bits() % 3000 );
+        }
+    }
+
+public:
+    using Fuzzer_base::Fuzzer_base;
+
+    void run_iteration()
+    {
+        const Size n = random_n_values();
+        const int n_threads = 1 + int( m_bits() % 4 );
+        const int value_kind = int( m_bits() % 4 );
+        const int order = int( m_bits() % 3 );
+        const int n_bits = 1 + int( m_bits() % 128 );
+        const int n_distinct = 1 + int( m_bits() % 20 );
+
+        const Uint_128 high_part = random_uint_128() << 64;
+        vector<Uint_128> distinct_values;
+        for( int i = 0; i < n_distinct; ++i ) { distinct_values.push_back( random_uint_128() ); }
+
+        vector<Uint_128> values( n );
+        for( Uint_128& v: values ) {
+            switch( value_kind ) {
+                case 0:     v = random_uint_128();  break;
+                case 1:     v = (n_bits == 128? random_uint_128() : random_uint_128() % (Uint_128( 1 ) << n_bits));  break;
+                case 2:     v = high_part | Uint_128( m_bits() % 1000 );  break;
+                default:    v = distinct_values[m_bits() % n_distinct];
+            }
+        }
+        if( order != 0 ) {
+            sort( values.begin(), values.end() );
+            if( order == 1 ) { reverse( values.begin(), values.end() ); }
+        }
+
+        vector<Uint_128> expected = values;
+        sort( expected.begin(), expected.end() );
+        batch::radix_sort( values, n_threads );
+
+        check_( values == expected, "radix_sort", [&]
+        {
+            static const char* const value_kinds[] = {"random", "narrow", "common high part", "few distinct"};
+            static const char* const orders[] = {"random", "descending", "ascending"};
+            return ""s << n << " " << value_kinds[value_kind] << " values"
+                << (value_kind == 1? ""s << " of " << n_bits << " bits" : ""s)
+                << " in " << orders[order] << " order and " << n_threads << (n_threads == 1? " thread" : " threads");
+        } );
+    }
+};
+
+void cpp_main() { run_fuzzer_<Fuzzer>( 1000, "The radix sort order differs from std::sort." ); }
+auto main() -> int { return with_exceptions_displayed( cpp_main ); }